@@ -77,7 +77,8 @@ static void openChunk(HttpQueue *q)
         <CRLF>
     Chunk spec is: "HEX_COUNT; chunk length DECIMAL_COUNT\r\n". The "; chunk length DECIMAL_COUNT is optional.
     As an optimization, use "\r\nSIZE ...\r\n" as the delimiter so that the CRLF after data does not special consideration.
-    Achive this by parseHeaders reversing the input start by 2.
+    Achive this by parseHeaders reversing the input start by 2. As for header lines, a bare LF is accepted in place of 
+    each CRLF. This also handles a header terminated by a bare "\n\n" where only a "\n" precedes the first chunk spec.
 
     Return number of bytes available to read.
     NOTE: may set rx->eof and return 0 bytes on EOF.
@@ -88,7 +89,7 @@ ssize httpFilterChunkData(HttpQueue *q, HttpPacket *packet)
     HttpRx      *rx;
     MprBuf      *buf;
     ssize       chunkSize, nbytes;
-    char        *start, *cp;
+    char        *start, *cp, *size;
     int         bad;
 
     conn = q->conn;
@@ -117,36 +118,37 @@ ssize httpFilterChunkData(HttpQueue *q, HttpPacket *packet)
 
     case HTTP_CHUNK_START:
         /*  
-            Validate:  "\r\nSIZE.*\r\n"
+            Validate:  "\r\nSIZE.*\r\n" or "\nSIZE.*\n"
          */
-        if (mprGetBufLength(buf) < 5) {
+        if (mprGetBufLength(buf) < 3) {
             return MPR_ERR_NOT_READY;
         }
         start = mprGetBufStart(buf);
-        bad = (start[0] != '\r' || start[1] != '\n');
-        for (cp = &start[2]; cp < buf->end && *cp != '\n'; cp++) {}
+        size = (start[0] == '\r') ? &start[1] : start;
+        bad = (*size++ != '\n');
+        for (cp = size; cp < buf->end && *cp != '\n'; cp++) {}
         if (*cp != '\n' && (cp - start) < 80) {
             return MPR_ERR_NOT_READY;
         }
-        bad += (cp[-1] != '\r' || cp[0] != '\n');
+        bad += (cp[0] != '\n');
         if (bad) {
             httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad chunk specification");
             return 0;
         }
-        chunkSize = (int) stoiradix(&start[2], 16, NULL);
-        if (!isxdigit((int) start[2]) || chunkSize < 0) {
+        chunkSize = (int) stoiradix(size, 16, NULL);
+        if (!isxdigit((int) *size) || chunkSize < 0) {
             httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad chunk specification");
             return 0;
         }
         if (chunkSize == 0) {
             /*
-                Last chunk. Consume the final "\r\n".
+                Last chunk. Consume the final "\r\n" or "\n".
              */
-            if ((cp + 2) >= buf->end) {
+            if ((cp + 1) >= buf->end || (cp[1] == '\r' && (cp + 2) >= buf->end)) {
                 return MPR_ERR_NOT_READY;
             }
-            cp += 2;
-            bad += (cp[-1] != '\r' || cp[0] != '\n');
+            cp += (cp[1] == '\r') ? 2 : 1;
+            bad += (cp[0] != '\n');
             if (bad) {
                 httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad final chunk specification");
                 return 0;
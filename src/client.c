@@ -180,7 +180,8 @@ bool httpNeedRetry(HttpConn *conn, char **url)
     } else if (HTTP_CODE_MOVED_PERMANENTLY <= rx->status && rx->status <= HTTP_CODE_MOVED_TEMPORARILY && 
             conn->followRedirects) {
         if (rx->redirect) {
-            *url = rx->redirect;
+            /* The redirect references the header packet which is released with the Rx object */
+            *url = sclone(rx->redirect);
             return 1;
         }
         httpFormatError(conn, rx->status, "Missing location header");
@@ -12,6 +12,7 @@
 static void manageConn(HttpConn *conn, int flags);
 static HttpPacket *getPacket(HttpConn *conn, ssize *bytesToRead);
 static void readEvent(HttpConn *conn);
+static void releaseIdlePackets(HttpConn *conn);
 static void writeEvent(HttpConn *conn);
 
 /*********************************** Code *************************************/
@@ -54,6 +55,9 @@ HttpConn *httpCreateConn(Http *http, HttpEndpoint *endpoint, MprDispatcher *disp
     }
     conn->keepAliveCount = conn->limits->keepAliveMax;
     conn->serviceq = httpCreateQueueHead(conn, "serviceq");
+    if (endpoint && endpoint->arenaSize > 0) {
+        conn->arena = mprCreateArena(endpoint->arenaSize);
+    }
 
     if (dispatcher) {
         conn->dispatcher = dispatcher;
@@ -104,6 +108,8 @@ void httpDestroyConn(HttpConn *conn)
 
 static void manageConn(HttpConn *conn, int flags)
 {
+    HttpPacket  *packet;
+
     mprAssert(conn);
 
     if (flags & MPR_MANAGE_MARK) {
@@ -120,8 +126,16 @@ static void manageConn(HttpConn *conn, int flags)
         mprMark(conn->waitHandler);
         mprMark(conn->sock);
         mprMark(conn->serviceq);
+        mprMark(conn->arena);
         mprMark(conn->currentq);
         mprMark(conn->input);
+        mprMark(conn->headerIndex);
+        for (packet = conn->packetPool; packet; packet = packet->next) {
+            mprMark(packet);
+        }
+        for (packet = conn->heldOutput; packet; packet = packet->next) {
+            mprMark(packet);
+        }
         mprMark(conn->readq);
         mprMark(conn->writeq);
         mprMark(conn->connectorq);
@@ -162,7 +176,7 @@ void httpCloseConn(HttpConn *conn)
     mprAssert(conn);
 
     if (conn->sock) {
-        mprLog(6, "Closing connection");
+        mprLog(6, "Closing connection %Ld", conn->seqno);
         if (conn->waitHandler) {
             mprRemoveWaitHandler(conn->waitHandler);
             conn->waitHandler = 0;
@@ -185,7 +199,7 @@ void httpConnTimeout(HttpConn *conn)
     limits = conn->limits;
     mprAssert(limits);
 
-    mprLog(6, "Inactive connection timed out");
+    mprLog(6, "Inactive connection %Ld timed out", conn->seqno);
     if (conn->state >= HTTP_STATE_PARSED) {
         if ((conn->lastActivity + limits->inactivityTimeout) < now) {
             httpError(conn, HTTP_CODE_REQUEST_TIMEOUT,
@@ -256,6 +270,10 @@ void httpPrepServerConn(HttpConn *conn)
     conn->readq = 0;
     conn->writeq = 0;
     commonPrep(conn);
+    /*
+        The prior request is complete and commonPrep has cleared all conn references into the arena
+     */
+    mprResetArena(conn->arena);
 }
 
 
@@ -351,6 +369,9 @@ void httpEvent(HttpConn *conn, MprEvent *event)
                 httpDestroyConn(conn);
             } else {
                 mprAssert(conn->state < HTTP_STATE_COMPLETE);
+                if (conn->state <= HTTP_STATE_CONNECTED) {
+                    releaseIdlePackets(conn);
+                }
                 httpEnableConnEvents(conn);
             }
         }
@@ -361,6 +382,20 @@ void httpEvent(HttpConn *conn, MprEvent *event)
 }
 
 
+/*
+    Release the packet pool while the connection waits for the next request, so idle keep-alive connections do not
+    retain pooled buffers. The input packet is kept as the read buffer for the next request.
+ */
+static void releaseIdlePackets(HttpConn *conn)
+{
+    if (conn->packetPool) {
+        mprAtomicAdd64(&conn->http->packetStats.released, conn->packetPoolCount);
+        conn->packetPool = 0;
+        conn->packetPoolCount = 0;
+    }
+}
+
+
 /*
     Process a socket readable event
  */
@@ -411,6 +446,12 @@ static void writeEvent(HttpConn *conn)
     LOG(6, "httpProcessWriteEvent, state %d", conn->state);
 
     conn->writeBlocked = 0;
+    /*
+        Write held pipeline output first. If it is in the connector's I/O vector, resume the connector to complete it.
+     */
+    if (conn->heldOutput && !httpWriteHeldOutput(conn)) {
+        return;
+    }
     if (conn->tx) {
         httpResumeQueue(conn->connectorq);
         httpServiceQueues(conn);
@@ -513,6 +554,9 @@ void httpEnableConnEvents(HttpConn *conn)
         } else {
             eventMask |= MPR_READABLE;
         }
+        if (conn->heldOutput) {
+            eventMask |= MPR_WRITABLE;
+        }
         if (eventMask) {
             if (conn->waitHandler == 0) {
                 conn->waitHandler = mprCreateWaitHandler(conn->sock->fd, eventMask, conn->dispatcher, conn->ioCallback, 
@@ -548,7 +592,7 @@ static HttpPacket *getPacket(HttpConn *conn, ssize *size)
     MprBuf      *content;
 
     if ((packet = conn->input) == NULL) {
-        conn->input = packet = httpCreatePacket(HTTP_BUFSIZE);
+        conn->input = packet = httpCreatePoolPacket(conn, 0);
     } else {
         content = packet->content;
         mprResetBufIfEmpty(content);
@@ -720,6 +764,7 @@ void httpSetTimeout(HttpConn *conn, int requestTimeout, int inactivityTimeout)
             conn->limits->inactivityTimeout = inactivityTimeout;
         }
     }
+    httpScheduleConnTimeout(conn);
 }
 
 
@@ -1261,6 +1261,12 @@ struct  MprXml;
 #define MPR_DEFAULT_BREAK_PORT  9473
 #define MPR_FD_MIN              32
 
+/*
+    Files sent to secure sockets are read into page aligned buffers of one TLS record (16K max plaintext)
+ */
+#define MPR_SSL_RECORD_SIZE     (16 * 1024)
+#define MPR_SSL_RECORD_BUFFERS  16            /**< Maximum idle record buffers retained for reuse */
+
 /* 
     Longest IPv6 is XXXX:XXXX:XXXX:XXXX:XXXX:XXXX:XXXX:XXXX (40 bytes with null) 
  */ 
@@ -1310,6 +1316,7 @@ struct  MprXml;
 #define MPR_TIMEOUT_STOP_TASK   10000       /**< Time to stop or reap tasks (vxworks) */
 #define MPR_TIMEOUT_LINGER      2000        /**< Close socket linger timeout */
 #define MPR_TIMEOUT_GC_SYNC     10000       /**< Wait period for threads to synchronize */
+#define MPR_TIMEOUT_GC_HANDSHAKE 10         /**< Initial wait for threads to yield before abandoning a collection */
 #define MPR_TIMEOUT_NO_BUSY     1000        /**< Wait period to minimize CPU drain */
 #define MPR_TIMEOUT_NAP         20          /**< Short pause */
 
@@ -2005,11 +2012,12 @@ extern void *mprAtomicExchange(void * volatile *target, cvoid *value);
 
     @stability Evolving
     @defgroup MprMem MprMem
-    @see MprFreeMem MprHeap MprManager MprMemNotifier MprRegion mprAddRoot mprAlloc mprAllocMem mprAllocObj 
-        mprAllocZeroed mprCreateMemService mprDestroyMemService mprEnableGC mprGetBlockSize mprGetMem 
-        mprGetMemStats mprGetMpr mprGetPageSize mprHasMemError mprHold mprIsDead mprIsParent mprIsValid mprMark 
+    @see MprFreeMem MprHeap MprManager MprMemNotifier MprRegion MprSlab mprAddRoot mprAlloc mprAllocMem mprAllocObj 
+        mprAllocSlab mprAllocSlabObj mprAllocZeroed mprCreateMemService mprCreateSlab mprDestroyMemService mprEnableGC mprGetBlockSize mprGetMem 
+        mprGetGCPauses mprGetHeapStats mprGetMemStats mprGetMpr 
+        mprGetPageSize mprHasMemError mprHold mprIsDead mprIsParent mprIsValid mprMark 
         mprMemcmp mprMemcpy mprMemdup mprPrintMem mprRealloc mprRelease mprRemoveRoot mprRequestGC mprResetMemError 
-        mprRevive mprSetAllocLimits mprSetManager mprSetMemError mprSetMemLimits mprSetMemNotifier mprSetMemPolicy 
+        mprRevive mprSetAllocLimits mprSetManager mprSetMemError mprSetMemLimits mprSetMemNotifier mprSetMemPolicy mprSetMemRetain 
         mprSetName mprValidateBlock mprVerifyMem mprVirtAlloc mprVirtFree 
  */
 typedef struct MprMem {
@@ -2034,6 +2042,28 @@ typedef struct MprMem {
 
 #define MPR_ALLOC_MIN_SPLIT         (32 + sizeof(MprMem))
 #define MPR_ALLOC_ALIGN(x)          (((x) + MPR_ALIGN - 1) & ~(MPR_ALIGN - 1))
+
+/*
+    Thread allocation caches. Small blocks are cached per thread for the first MPR_ALLOC_CACHE_CLASSES free queues 
+    (which each hold exactly one block size). A cache is refilled from the free queues with MPR_ALLOC_CACHE_BYTES
+    of blocks at a time, so the heap lock is taken once per batch rather than once per allocation.
+ */
+#define MPR_ALLOC_CACHE_CLASSES     32
+#define MPR_ALLOC_CACHE_BYTES       (4 * 1024)
+
+/*
+    Slab pools. Hot fixed size objects may be allocated from dedicated regions of equal sized slots. Slots are aligned 
+    to MPR_ALLOC_SLAB_ALIGN so that objects do not share cache lines.
+ */
+#define MPR_ALLOC_MAX_SLABS         16
+#define MPR_ALLOC_SLAB_ALIGN        64
+#define MPR_ARENA_CHUNK             (8 * 1024)      /**< Default arena chunk size */
+#define MPR_MEM_RETAIN              (MPR_MEM_REGION_SIZE * 4)   /**< Free heap memory to retain when releasing regions */
+#define MPR_MEM_ADVISE_MIN          (64 * 1024)     /**< Min free block to release with madvise in a used region */
+#define MPR_MEM_RELEASE_DELAY       5000            /**< Msec after heap growth before releasing free blocks */
+#define MPR_GC_HANDSHAKE_RETRIES    6               /**< Abandoned attempts before waiting MPR_TIMEOUT_GC_SYNC */
+#define MPR_GC_PAUSE_BUCKETS        16              /**< GC pause histogram buckets */
+#define MPR_GC_PAUSE_SHIFT          6               /**< First histogram bucket holds pauses under 64 usec */
 #define MPR_PAGE_ALIGN(x, psize)    ((((ssize) (x)) + ((ssize) (psize)) - 1) & ~(((ssize) (psize)) - 1))
 #define MPR_PAGE_ALIGNED(x, psize)  ((((ssize) (x)) % ((ssize) (psize))) == 0)
 #define MPR_ALLOC_MAGIC             0xe814ecab
@@ -2177,6 +2207,15 @@ typedef struct MprMemStats {
     int             marked;
     int             sweepVisited;
     int             swept;
+    uint64          syncTime;               /**< Total usec waiting for threads to yield for collection */
+    uint64          markTime;               /**< Total usec marking */
+    uint64          sweepTime;              /**< Total usec running destructors and freeing blocks */
+    uint64          totalFreed;             /**< Total bytes freed by all sweeps */
+    uint64          growths;                /**< Count of regions allocated from the O/S to grow the heap */
+    uint64          growBytes;              /**< Total bytes allocated from the O/S to grow the heap */
+    uint64          releases;               /**< Count of free regions returned to the O/S */
+    uint64          releasedBytes;          /**< Total bytes returned to the O/S */
+    uint64          advisedBytes;           /**< Total bytes of free blocks released to the O/S via madvise */
 
 #if BIT_MEMORY_STATS
     /*
@@ -2188,12 +2227,71 @@ typedef struct MprMemStats {
     uint64          reuse;                  /**< Count of times a block was reused from a free queue */
     uint64          splits;                 /**< Count of times a block was split */
     uint64          unpins;                 /**< Count of times a block was unpinned and released back to the O/S */
+    uint64          cacheHits;              /**< Count of allocations satisfied from a thread cache */
+    uint64          cacheRefills;           /**< Count of thread cache refills from the free queues */
+    uint64          cacheFlushes;           /**< Count of thread caches flushed back to the heap on thread exit */
+    uint64          heapContention;         /**< Count of times the heap lock was contended */
 
     MprLocationStats locations[MPR_TRACK_HASH]; /* Per location allocation stats */
 #endif
 } MprMemStats;
 
 
+/**
+    Garbage collection pause statistics. Times are in microseconds and measure how long threads are held from
+    requesting a collection to resuming. Histogram bucket N holds pauses under (1 << (MPR_GC_PAUSE_SHIFT + N)) usec,
+    and the last bucket holds all longer pauses.
+    @ingroup MprMem
+ */
+typedef struct MprGCPauses {
+    uint64  count;                                  /**< Count of pauses including aborted attempts */
+    uint64  total;                                  /**< Total time paused */
+    uint64  max;                                    /**< Longest pause */
+    uint64  aborted;                                /**< Collection attempts abandoned as threads did not yield */
+    uint64  histogram[MPR_GC_PAUSE_BUCKETS];        /**< Pause time histogram (log2 buckets) */
+} MprGCPauses;
+
+
+/**
+    Heap block statistics for one generation
+    @ingroup MprMem
+ */
+typedef struct MprGenStats {
+    uint64  blocks;                                 /**< Count of blocks */
+    uint64  bytes;                                  /**< Bytes in blocks including headers */
+} MprGenStats;
+
+
+/**
+    Heap statistics snapshot. See mprGetHeapStats. Times are in microseconds.
+    @ingroup MprMem
+ */
+typedef struct MprHeapStats {
+    uint64      collections;                        /**< Count of completed garbage collections */
+    uint64      syncTime;                           /**< Total time waiting for threads to yield */
+    uint64      markTime;                           /**< Total time marking */
+    uint64      sweepTime;                          /**< Total time running destructors and freeing blocks */
+    uint64      freed;                              /**< Total bytes freed by the collector */
+    uint64      growths;                            /**< Count of heap growth events */
+    uint64      growBytes;                          /**< Total bytes added by heap growth */
+    uint64      releases;                           /**< Count of free regions returned to the O/S */
+    uint64      released;                           /**< Total bytes returned to the O/S by unmapping regions */
+    uint64      advised;                            /**< Total bytes of free blocks released via madvise */
+    uint64      bytesAllocated;                     /**< Bytes currently allocated from the O/S */
+    uint64      bytesFree;                          /**< Bytes on the heap free queues */
+    uint64      heapSize;                           /**< Bytes in heap regions */
+    uint64      largestFree;                        /**< Largest free block */
+    int         regions;                            /**< Count of heap regions */
+    int         fragmentation;                      /**< Percentage of free bytes not in the largest free block */
+    MprGenStats eternal;                            /**< Held, cached and arena blocks */
+    MprGenStats active;                             /**< Blocks allocated or marked since the last collection */
+    MprGenStats dead;                               /**< Blocks found unreachable and not yet freed */
+    MprGenStats free;                               /**< Free blocks */
+    MprGenStats slabFree;                           /**< Free slab slots. These are included in eternal */
+    MprGCPauses pauses;                             /**< GC pause statistics */
+} MprHeapStats;
+
+
 /**
    Memmory regions allocated from the O/S
     @ingroup MemMem
@@ -2204,9 +2302,33 @@ typedef struct MprRegion {
     MprSpin          lock;                  /**< Region multithread lock */
     ssize            size;                  /**< Size of region including region header */
     int              freeable;              /**< Set to true when completely unused */
+    struct MprSlab   *slab;                 /**< Owning slab pool. Null for general heap regions */
+    struct MprRegion *nextSlab;             /**< Next region in the slab pool */
+    MprMem           *slots;                /**< Free slab slots linked via the first word of user memory */
+    int              freeSlots;             /**< Count of free slab slots */
+    int              numSlots;              /**< Count of slab slots */
 } MprRegion;
 
 
+/**
+    Slab pool for fixed size objects
+    @description A slab pool allocates equal sized slots from dedicated heap regions. Slots are handed to per-thread 
+        allocation caches in batches. Slots are ordinary garbage collected blocks: managers are invoked and the 
+        collector frees unreferenced slots. The sweeper returns freed slots to their region rather than coalescing
+        them, and unmaps regions that become entirely free.
+    @ingroup MprMem
+ */
+typedef struct MprSlab {
+    cchar            *name;                 /**< Slab name */
+    ssize            size;                  /**< Slot size including block header and manager */
+    MprRegion        *regions;              /**< Slab regions */
+    MprSpin          lock;                  /**< Lock for the slab region list and region free slots */
+    int              batch;                 /**< Slots to move to a thread cache at a time */
+    int              hasManager;            /**< Slots have a manager */
+    int              index;                 /**< Free queue index of the slot size. Used for GC accounting */
+} MprSlab;
+
+
 /**
     Memory allocator heap
     @ingroup MemMem
@@ -2223,15 +2345,24 @@ typedef struct MprHeap {
     MprSpin          rootLock;               /**< Root locking */
     MprCond          *markerCond;            /**< Marker sleep cond var */
     MprMutex         *mutex;                 /**< Locking for state changes */
+    MprMutex         *sweepLock;             /**< Excludes heap walkers while sweeping */
     MprRegion        *regions;               /**< List of memory regions */
     struct MprThread *marker;                /**< Marker thread */
     struct MprThread *sweeper;               /**< Optional sweeper thread */
+    MprGCPauses      pauses;                 /**< GC pause statistics */
+    MprSlab          slabs[MPR_ALLOC_MAX_SLABS]; /**< Slab pools */
+    int              numSlabs;               /**< Count of slab pools */
 
     int              eternal;                /**< Eternal generation (permanent and dead blocks) */
     int              active;                 /**< Active generation for new and active blocks */
     int              stale;                  /**< Stale generation for blocks that may have no references*/
     int              dead;                   /**< Dead generation (blocks about to be freed) */
 
+    ssize            retain;                 /**< Free memory to retain before releasing regions to the O/S */
+    ssize            freeLow;                /**< Low water mark of free memory since the last sweep */
+    ssize            releaseBudget;          /**< Bytes of free blocks the current sweep may release via madvise */
+    MprTime          lastGrowth;             /**< Time the heap last grew */
+    MprTime          releaseDelay;           /**< Time after heap growth before releasing free blocks via madvise */
     int              allocPolicy;            /**< Memory allocation depletion policy */
     int              chunkSize;              /**< O/S memory allocation chunk size */
     int              collecting;             /**< Manual GC is running */
@@ -2240,6 +2371,7 @@ typedef struct MprHeap {
     int              flags;                  /**< GC operational control flags */
     int              from;                   /**< Eligible mprCollectGarbage flags */
     int              gc;                     /**< GC has been requested */
+    int              handshakeFailures;      /**< Consecutive collection attempts where threads did not yield */
     int              hasError;               /**< Memory allocation error */
     int              hasSweeper;             /**< Has dedicated sweeper thread */
     int              iteration;              /**< GC iteration counter (debug only) */
@@ -2304,6 +2436,25 @@ extern void *mprAllocMem(ssize size, int flags);
  */
 extern MprMemStats *mprGetMemStats();
 
+/**
+    Get the garbage collection pause statistics
+    @description Copies a snapshot of the pause count, total, maximum and histogram. Use this to observe the time
+        threads are held by the collector.
+    @param pauses Structure to receive the statistics
+    @ingroup MprMem
+ */
+extern void mprGetGCPauses(MprGCPauses *pauses);
+
+/**
+    Get a snapshot of the heap statistics
+    @description Returns collector counters and times, heap growth, free memory fragmentation and per-generation 
+        block counts. This walks all heap blocks while holding the heap lock, so it is intended for periodic 
+        monitoring rather than frequent calls.
+    @param stats Structure to receive the statistics
+    @ingroup MprMem
+ */
+extern void mprGetHeapStats(MprHeapStats *stats);
+
 /**
     Return the amount of memory currently used by the application. On Unix, this returns the total application memory
     size including code, stack, data and heap. On Windows, VxWorks and other operatings systems, it returns the
@@ -2470,6 +2621,33 @@ extern void mprSetMemLimits(ssize redline, ssize maxMemory);
 */
 extern void mprSetMemPolicy(int policy);
 
+/**
+    Configure when free heap regions are returned to the O/S
+    @description After garbage collection, heap regions that are entirely free are unmapped while the heap has more
+        free memory than the retain target. Large free blocks in regions that are still in use are released via 
+        madvise where supported. To avoid releasing pages that are about to be needed again, this is limited to free
+        memory that stayed unused since the prior sweep, less the retain target, and only once the heap has not grown 
+        for the release delay. If the application is idle, a collection is run after the release delay so memory 
+        freed by a burst of activity is still returned.
+    @param retain Free heap memory in bytes to keep mapped. Set to -1 to leave unchanged. Defaults to MPR_MEM_RETAIN.
+    @param delay Time in milliseconds after the heap last grew before free blocks may be released via madvise. Set 
+        to -1 to leave unchanged. Defaults to MPR_MEM_RELEASE_DELAY.
+    @ingroup MprMem
+ */
+extern void mprSetMemRetain(ssize retain, MprTime delay);
+
+/**
+    Create a slab pool for fixed size objects
+    @description Slab pools are used for hot objects that are allocated and freed at high rates. Creating a slab with 
+        a name that already exists returns the existing slab, so callers may create slabs lazily.
+    @param name Slab name. Must be a static string.
+    @param size Size of the objects to allocate from the slab
+    @param flags Set to MPR_ALLOC_MANAGER if the objects have managers
+    @return A slab identifier for mprAllocSlab, or MPR_ERR_TOO_MANY if there are too many slabs.
+    @ingroup MprMem
+ */
+extern int mprCreateSlab(cchar *name, ssize size, int flags);
+
 /**
     Update the manager for a block of memory.
     @description This call updates the manager for a block of memory allocated via mprAllocWithManager.
@@ -2530,6 +2708,12 @@ extern void mprVirtFree(void *ptr, ssize size);
     ((type*) mprSetManager( \
         mprSetAllocName(mprAllocMem(sizeof(type), MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO), #type "@" MPR_LOC), (MprManager) manage))
 #define mprAllocStruct(type) ((type*) mprSetAllocName(mprAllocMem(sizeof(type), MPR_ALLOC_ZERO), #type "@" MPR_LOC))
+#define mprAllocSlabObj(slab, type, manage) \
+    ((type*) mprSetManager( \
+        mprSetAllocName(mprAllocSlab(slab, sizeof(type), MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO), #type "@" MPR_LOC), \
+        (MprManager) manage))
+#define mprAllocSlabStruct(slab, type) \
+    ((type*) mprSetAllocName(mprAllocSlab(slab, sizeof(type), MPR_ALLOC_ZERO), #type "@" MPR_LOC))
 
 #if DOXYGEN
 typedef void *Type;
@@ -2560,6 +2744,20 @@ extern void *mprAlloc(ssize size);
  */
 extern void *mprAllocObj(Type type, MprManager manager) { return 0;}
 
+/**
+    Allocate an object of a given type from a slab pool
+    @description Allocates a zeroed object with a manager callback from a slab pool created via #mprCreateSlab.
+        This call is implemented as a macro.
+    @param slab Slab identifier returned by mprCreateSlab. If the slab is invalid, the object is allocated from
+        the general heap.
+    @param type Type of the object to allocate
+    @param manager Manager function to invoke when the allocation is managed.
+    @return Returns a pointer to the allocated block. If memory is not available the memory exhaustion handler 
+        specified via mprCreate will be called to allow global recovery.
+    @ingroup MprMem
+ */
+extern void *mprAllocSlabObj(int slab, Type type, MprManager manager) { return 0;}
+
 /**
     Allocate a zeroed block of memory
     @description Allocates a zeroed block of memory.
@@ -2573,6 +2771,7 @@ extern void *mprAllocZeroed(ssize size);
 
 #else /* !DOXYGEN */
 extern void *mprAllocMem(ssize size, int flags);
+extern void *mprAllocSlab(int slab, ssize size, int flags);
 extern void *mprReallocMem(void *ptr, ssize size);
 extern void *mprMemdupMem(cvoid *ptr, ssize size);
 extern void mprCheckBlock(MprMem *bp);
@@ -2684,6 +2883,101 @@ extern void mprWakeGCService();
 extern void mprResumeThreads();
 extern int  mprSyncThreads(MprTime timeout);
 
+/*********************************** Arenas ***********************************/
+/**
+    Memory arena
+    @description An arena is a bump allocator for short-lived, unmanaged memory such as strings. Blocks are carved 
+        from large chunks and are all freed at once by mprResetArena. The collector does not scan or count arena 
+        blocks, so arena allocations do not advance garbage collection. References to arena blocks must not be retained
+        after the arena is reset. Use mprEscapeArena to copy a block to the garbage collected heap if it must outlive
+        the arena. Arena blocks must not be passed to mprRealloc. Arenas are not thread-safe.
+    @defgroup MprArena MprArena
+    @see mprArenaAlloc mprArenaClone mprArenaFmt mprArenaFmtv mprCreateArena mprEscapeArena mprIsArenaMem mprResetArena
+ */
+typedef struct MprArena {
+    char            *chunk;             /**< Current chunk. First word links to the previous chunk */
+    char            *next;              /**< Next free byte in the current chunk */
+    char            *end;               /**< End of the current chunk */
+    ssize           chunkSize;          /**< Size of each chunk */
+    int64           allocs;             /**< Count of arena allocations */
+    int64           resets;             /**< Count of arena resets */
+} MprArena;
+
+/**
+    Create a memory arena
+    @param chunkSize Size of each arena chunk. Set to zero for the default of MPR_ARENA_CHUNK.
+    @return An arena object
+    @ingroup MprArena
+ */
+extern MprArena *mprCreateArena(ssize chunkSize);
+
+/**
+    Allocate a block from an arena
+    @description The block is not zeroed. Requests larger than a quarter of the chunk size are allocated from the 
+        garbage collected heap.
+    @param arena Arena to allocate from. If null, the block is allocated from the garbage collected heap.
+    @param size Size of the memory block to allocate.
+    @return Returns a pointer to the allocated block.
+    @ingroup MprArena
+ */
+extern void *mprArenaAlloc(MprArena *arena, ssize size);
+
+/**
+    Clone a string into an arena
+    @param arena Arena to allocate from. If null, this is equivalent to sclone.
+    @param str String to clone
+    @return An allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaClone(MprArena *arena, cchar *str);
+
+/**
+    Format a string into an arena
+    @param arena Arena to allocate from. If null, this is equivalent to sfmt.
+    @param fmt Printf style format string
+    @param ... Variable arguments to format
+    @return An allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaFmt(MprArena *arena, cchar *fmt, ...);
+
+/**
+    Format a string into an arena using a va_list
+    @param arena Arena to allocate from. If null, this is equivalent to sfmtv.
+    @param fmt Printf style format string
+    @param args Varargs argument list
+    @return An allocated string
+    @ingroup MprArena
+ */
+extern char *mprArenaFmtv(MprArena *arena, cchar *fmt, va_list args);
+
+/**
+    Copy an arena block to the garbage collected heap
+    @description Use this to preserve a block that must outlive the next mprResetArena.
+    @param arena Arena that may own the block
+    @param ptr Block to copy
+    @return A garbage collected copy of the block if it was allocated from the arena. Otherwise returns ptr.
+    @ingroup MprArena
+ */
+extern void *mprEscapeArena(MprArena *arena, cvoid *ptr);
+
+/**
+    Test if a block was allocated from an arena
+    @param arena Arena to test
+    @param ptr Memory block
+    @return True if the block lies in one of the arena chunks
+    @ingroup MprArena
+ */
+extern bool mprIsArenaMem(MprArena *arena, cvoid *ptr);
+
+/**
+    Reset an arena
+    @description Frees all blocks allocated from the arena. The first chunk is retained for reuse.
+    @param arena Arena to reset
+    @ingroup MprArena
+ */
+extern void mprResetArena(MprArena *arena);
+
 /********************************** Safe Strings ******************************/
 /**
     Safe String Module
@@ -6051,6 +6345,8 @@ typedef struct MprDispatcher {
     struct MprEventService *service;
     struct MprWorker *requiredWorker;   /**< Worker affinity */
     MprOsThread     owner;              /**< Owning thread of the dispatcher */
+    MprTime         due;                /**< Due time of the first event. Wait heap key (internal) */
+    int             heapIndex;          /**< Index in the event service wait heap. Zero if not present (internal) */
 } MprDispatcher;
 
 
@@ -6062,11 +6358,16 @@ typedef struct MprEventService {
     MprDispatcher   *waitQ;             /**< Queue of waiting (future) events */
     MprDispatcher   *idleQ;             /**< Queue of idle dispatchers */
     MprDispatcher   *pendingQ;          /**< Queue of pending dispatchers (waiting for resources) */
+    MprDispatcher   **waitHeap;         /**< Min-heap of waitQ dispatchers ordered by due time. Index 1 is the top */
+    int             waitHeapCount;      /**< Count of dispatchers in the wait heap */
+    int             waitHeapMax;        /**< Allocated size of the wait heap */
     MprOsThread     serviceThread;      /**< Thread running the dispatcher service */
     int             eventCount;         /**< Count of events */
     int             waiting;            /**< Waiting for I/O (sleeping) */
     struct MprCond  *waitCond;          /**< Waiting sync */
     struct MprMutex *mutex;             /**< Multi-thread sync */
+    struct MprWaitService *waitService; /**< Wait service to wake. Null for the primary event service */
+    struct MprReactor *reactor;         /**< Owning reactor. Null for the primary event service */
 } MprEventService;
 
 /**
@@ -6242,6 +6543,7 @@ extern int mprDispatchersAreIdle();
 extern void mprClaimDispatcher(MprDispatcher *dispatcher);
 extern MprEventService *mprCreateEventService();
 extern void mprStopEventService();
+extern void mprStopReactors();
 extern MprEvent *mprGetNextEvent(MprDispatcher *dispatcher);
 extern int mprGetEventCount(MprDispatcher *dispatcher);
 extern void mprInitEventQ(MprEvent *q);
@@ -6774,8 +7076,105 @@ typedef struct MprWaitService {
 #endif /* EVENT_SELECT */
     MprMutex        *mutex;                 /* General multi-thread sync */
     MprSpin         *spin;                  /* Fast short locking */
+    int64           ioEvents;               /* Count of I/O events queued to dispatchers */
+    int64           notifyAdds;             /* Count of descriptor registrations with the O/S notifier */
+    int64           notifyMods;             /* Count of descriptor re-arms (EPOLL_CTL_MOD) */
+    int64           notifyDels;             /* Count of descriptor removals from the O/S notifier */
 } MprWaitService;
 
+/**
+    Statistics for the wait service
+    @description The notify counters measure the O/S notifier system calls issued. Divide by the count of requests
+        served to determine the per-request overhead.
+    @ingroup MprWaitHandler
+ */
+typedef struct MprWaitStats {
+    int64           ioEvents;               /**< I/O events queued to dispatchers */
+    int64           notifyAdds;             /**< Descriptors registered with the O/S notifier */
+    int64           notifyMods;             /**< Descriptors re-armed with the O/S notifier */
+    int64           notifyDels;             /**< Descriptors removed from the O/S notifier */
+    int             handlers;               /**< Current count of wait handlers */
+} MprWaitStats;
+
+
+/**
+    Reactor
+    @description A reactor owns a private wait service (epoll instance) and event service and is serviced by a
+        dedicated thread. Dispatchers created via #mprCreateReactorDispatcher are pinned to a reactor. I/O for
+        their wait handlers is detected and their events are run on the reactor thread without involving the 
+        primary event service. Reactors require epoll.
+    @ingroup MprWaitHandler
+ */
+typedef struct MprReactor {
+    int             index;                  /**< Reactor index */
+    MprEventService *eventService;          /**< Private event service for pinned dispatchers */
+    MprWaitService  *waitService;           /**< Private wait service for pinned wait handlers */
+    struct MprThread *thread;               /**< Thread servicing the reactor */
+    int             pinned;                 /**< Count of live dispatchers pinned to this reactor */
+    int64           dispatches;             /**< Count of dispatcher runs */
+    int64           wakeups;                /**< Count of returns from waiting for I/O */
+} MprReactor;
+
+/**
+    Statistics for a reactor
+    @ingroup MprWaitHandler
+ */
+typedef struct MprReactorStats {
+    int             index;                  /**< Reactor index */
+    int             handlers;               /**< Current wait handlers registered with the reactor */
+    int             pinned;                 /**< Live dispatchers pinned to the reactor */
+    int64           ioEvents;               /**< I/O events detected by the reactor */
+    int64           dispatches;             /**< Dispatcher runs on the reactor thread */
+    int64           wakeups;                /**< Returns from waiting for I/O */
+} MprReactorStats;
+
+/**
+    Start reactor threads
+    @description Start a set of reactors, each with its own epoll instance and servicing thread. Connections pinned to
+        a reactor via #mprCreateReactorDispatcher have their I/O and events serviced entirely on that reactor's thread.
+        This should be called once after #mprStart and before listening for connections.
+    @param count Number of reactors to start. Set to -1 for one reactor per CPU core. Zero disables reactors.
+    @return Zero if successful, otherwise a negative MPR error code.
+    @ingroup MprWaitHandler
+ */
+extern int mprStartReactors(int count);
+
+/**
+    Get the number of running reactors
+    @return The count of reactors. Zero if reactors are not enabled.
+    @ingroup MprWaitHandler
+ */
+extern int mprGetReactorCount();
+
+/**
+    Create a dispatcher pinned to the least loaded reactor
+    @description If reactors are not enabled, this creates a standard enabled dispatcher.
+    @param name Useful name for debugging
+    @return An enabled dispatcher object
+    @ingroup MprWaitHandler
+ */
+extern MprDispatcher *mprCreateReactorDispatcher(cchar *name);
+
+/**
+    Create a dispatcher pinned to the same reactor as an existing dispatcher
+    @description This is used to keep related work on one reactor thread. For example: connections accepted by a
+        listener that is itself pinned to a reactor. If the given dispatcher is not pinned to a reactor, this creates
+        a standard enabled dispatcher.
+    @param dispatcher Existing dispatcher
+    @param name Useful name for debugging
+    @return An enabled dispatcher object
+    @ingroup MprWaitHandler
+ */
+extern MprDispatcher *mprCreateSiblingDispatcher(MprDispatcher *dispatcher, cchar *name);
+
+/**
+    Get the statistics for a reactor
+    @param index Reactor index. Ranges from zero to #mprGetReactorCount minus one.
+    @param stats Reference to stats object to receive the stats
+    @return Zero if successful, otherwise MPR_ERR_CANT_FIND if the index is out of range.
+    @ingroup MprWaitHandler
+ */
+extern int mprGetReactorStats(int index, MprReactorStats *stats);
 
 /*
     Internal
@@ -6786,6 +7185,8 @@ extern int  mprStartWaitService(MprWaitService *ws);
 extern int  mprStopWaitService(MprWaitService *ws);
 extern void mprSetWaitServiceThread(MprWaitService *ws, MprThread *thread);
 extern void mprWakeNotifier();
+extern void mprWakeWaitService(MprWaitService *ws);
+extern MprWaitService *mprCreatePrivateWaitService();
 extern int  mprInitWindow();
 #if MPR_EVENT_KQUEUE
     extern void mprManageKqueue(MprWaitService *ws, int flags);
@@ -6822,11 +7223,20 @@ extern void mprWaitForIO(MprWaitService *ws, MprTime timeout);
  */
 extern int mprWaitForSingleIO(int fd, int mask, MprTime timeout);
 
+/**
+    Get the wait service statistics
+    @param ws Wait service object
+    @param stats Reference to stats object to receive the stats
+    @ingroup MprWaitHandler
+ */
+extern void mprGetWaitServiceStats(MprWaitService *ws, MprWaitStats *stats);
+
 /*
     Handler Flags
  */
 #define MPR_WAIT_RECALL_HANDLER     0x1     /**< Wait handler flag to recall the handler asap */
 #define MPR_WAIT_NEW_DISPATCHER     0x2     /**< Wait handler flag to create a new dispatcher for each I/O event */
+#define MPR_WAIT_REGISTERED         0x4     /**< Descriptor is registered with the O/S notifier (internal) */
 
 /**
     Wait Handler Service
@@ -6981,6 +7391,8 @@ typedef struct MprSocketService {
     MprSocketPrebind prebind;                   /**< Prebind callback */
     MprList         *secureSockets;             /**< List of secured (matrixssl) sockets */
     MprMutex        *mutex;                     /**< Multithread locking */
+    void            *recordBuffers;             /**< Free list of TLS record buffers for mprSendFileToSocket */
+    int             recordBufferCount;          /**< Count of buffers on the free list */
 } MprSocketService;
 
 
@@ -7038,6 +7450,18 @@ extern void mprAddSocketProvider(cchar *name, MprSocketProvider *provider);
 #define MPR_SOCKET_CLIENT       0x800       /**< Socket is a client */
 #define MPR_SOCKET_PENDING      0x1000      /**< Pending buffered read data */
 #define MPR_SOCKET_TRACED       0x2000      /**< Socket has been traced to the log */
+#define MPR_SOCKET_REUSEPORT    0x4000      /**< Set SO_REUSEPORT so multiple listeners can share a port */
+#define MPR_SOCKET_CORKED       0x8000      /**< Partial frames are held until the socket is uncorked */
+
+/**
+    Binary remote client address. This is an exact key for a client. IPv4 addresses are held in their IPv4 mapped
+    IPv6 form (::ffff:a.b.c.d) so each address has a single representation.
+    @ingroup MprSocket
+ */
+typedef struct MprIpKey {
+    uint64          hi;                 /**< First 8 bytes of the IPv6 address in network order */
+    uint64          lo;                 /**< Last 8 bytes of the IPv6 address in network order */
+} MprIpKey;
 
 /**
     Socket Service
@@ -7053,7 +7477,8 @@ extern void mprAddSocketProvider(cchar *name, MprSocketProvider *provider);
         mprDisconnectSocket mprEnableSocketEvents mprFlushSocket mprGetSocketBlockingMode mprGetSocketError 
         mprGetSocketFd mprGetSocketInfo mprGetSocketPort mprHasSecureSockets mprIsSocketEof mprIsSocketSecure 
         mprListenOnSocket mprLoadSsl mprParseIp mprReadSocket mprSendFileToSocket mprSetSecureProvider 
-        mprSetSocketBlockingMode mprSetSocketCallback mprSetSocketEof mprSetSocketNoDelay mprSetSslCaFile 
+        mprSetSocketBlockingMode mprSetSocketCallback mprSetSocketCork mprSetSocketDeferAccept mprSetSocketEof 
+        mprSetSocketNoDelay mprSetSslCaFile 
         mprSetSslCaPath mprSetSslCertFile mprSetSslCiphers mprSetSslKeyFile mprSetSslSslProtocols 
         mprSetSslVerifySslClients mprWriteSocket mprWriteSocketString mprWriteSocketVector 
         mprSocketHasPendingData mprUpgradeSocket
@@ -7069,6 +7494,8 @@ typedef struct MprSocket {
     char            *errorMsg;          /**< Connection related error messages */
     int             acceptPort;         /**< Server port doing the listening */
     int             port;               /**< Port to listen or connect on */
+    MprIpKey        ipKey;              /**< Remote client binary address. Set for accepted sockets */
+    int             backlog;            /**< Listen backlog. Set before listening. Zero for the default SOMAXCONN */
     int             fd;                 /**< Actual socket file handle */
     int             flags;              /**< Current state flags */
     MprSocketProvider *provider;        /**< Socket implementation provider */
@@ -7270,6 +7697,8 @@ extern bool mprIsSocketEof(MprSocket *sp);
         @li MPR_SOCKET_DATAGRAM - Use IPv4 datagrams
         @li MPR_SOCKET_NOREUSE - Set NOREUSE flag on the socket
         @li MPR_SOCKET_NODELAY - Set NODELAY on the socket
+        @li MPR_SOCKET_REUSEPORT - Set SO_REUSEPORT so several sockets may listen on the same port. The O/S
+            distributes incoming connections across the listeners. Ignored where SO_REUSEPORT is not supported.
         @li MPR_SOCKET_THREAD - Process callbacks on a separate thread.
     @return Zero if the connection is successful. Otherwise a negative MPR error code.
     @ingroup MprSocket
@@ -7317,6 +7746,9 @@ extern void mprRemoveSocketHandler(MprSocket *sp);
     @description Write the contents of a file to a socket. If the socket is in non-blocking mode (the default), the write
         may return having written less than the required bytes. This API permits the writing of data before and after
         the file contents. 
+        \n\n
+        For secure sockets, the data before, the file contents and the data after are packed into buffers of one TLS 
+        record that are passed directly to the SSL provider write routine.
     @param file File to write to the socket
     @param sock Socket object returned from #mprCreateSocket
     @param offset offset within the file from which to read data
@@ -7363,6 +7795,30 @@ extern void mprSetSocketEof(MprSocket *sp, bool eof);
  */
 extern int mprSetSocketNoDelay(MprSocket *sp, bool on);
 
+/**
+    Cork the socket
+    @description While corked, the O/S holds partial TCP frames so that data written by several system calls is 
+        coalesced into full packets. Uncorking sends any held data immediately. This uses TCP_CORK on Linux and 
+        TCP_NOPUSH on BSD systems. Calls that do not change the corked state are not passed to the O/S.
+    @param sp Socket object returned from #mprCreateSocket
+    @param on Set to true to cork the socket. Set to false to uncork and send held data.
+    @return Zero if successful. Otherwise a negative MPR error code. Returns MPR_ERR_BAD_STATE if not supported.
+    @ingroup MprSocket
+ */
+extern int mprSetSocketCork(MprSocket *sp, bool on);
+
+/**
+    Defer accepting connections until data arrives
+    @description Set TCP_DEFER_ACCEPT on a listening socket so that new connections are only signalled once the
+        client has sent data. This avoids waking to accept connections that have not yet sent a request.
+        Only supported on Linux.
+    @param sp Listening socket object returned from #mprCreateSocket
+    @param timeout Maximum time in seconds to defer a connection. Set to zero to disable.
+    @return Zero if successful. Otherwise a negative MPR error code.
+    @ingroup MprSocket
+ */
+extern int mprSetSocketDeferAccept(MprSocket *sp, int timeout);
+
 /**
     Test if the socket has buffered read data.
     @description Use this function to avoid waiting for incoming I/O if data is already buffered.
@@ -8587,6 +9043,7 @@ typedef struct Mpr {
     struct MprThreadService *threadService; /**< Thread service object */
     struct MprWorkerService *workerService; /**< Worker service object */
     struct MprWaitService   *waitService;   /**< IO Waiting service object */
+    MprList                 *reactors;      /**< Reactors for multi-reactor I/O (MprReactor) */
 
     struct MprDispatcher    *dispatcher;    /**< Primary dispatcher */
     struct MprDispatcher    *nonBlock;      /**< Nonblocking dispatcher */
@@ -132,9 +132,46 @@ int stopSeqno = -1;
     SET_NAME(mp, NULL); \
     } else
 
-#define lockHeap()              mprSpinLock(&heap->heapLock);
+#if BIT_MEMORY_STATS
+    #define lockHeap()          if (!mprTrySpinLock(&heap->heapLock)) { \
+                                    mprSpinLock(&heap->heapLock); \
+                                    heap->stats.heapContention++; \
+                                } else
+#else
+    #define lockHeap()          mprSpinLock(&heap->heapLock);
+#endif
 #define unlockHeap()            mprSpinUnlock(&heap->heapLock);
 
+/*
+    Per-thread allocation caches require thread specific data with a destructor to flush the cache on thread exit
+ */
+#if BIT_UNIX_LIKE
+    #define THREAD_CACHE 1
+#else
+    #define THREAD_CACHE 0
+#endif
+
+/*
+    Internal allocMem flag. Batch allocations that refill a thread cache are not counted toward the GC quota as each 
+    cached block is counted when it is handed out.
+ */
+#define ALLOC_UNCOUNTED 0x100
+
+#if THREAD_CACHE
+/*
+    Cached blocks are owned by the thread and are not free. They are eternal so the collector ignores them.
+    Each list is linked via the first word of the block's user memory. Indexed by [hasManager][queue index].
+    Slab slots are cached in the same way and are indexed by slab.
+ */
+typedef struct ThreadCache {
+    MprMem          *blocks[2][MPR_ALLOC_CACHE_CLASSES];
+    MprMem          *slabs[MPR_ALLOC_MAX_SLABS];
+#if BIT_MEMORY_STATS
+    uint64          hits;
+#endif
+} ThreadCache;
+#endif
+
 #define percent(a,b) ((int) ((a) * 100 / (b)))
 
 /*
@@ -167,6 +204,10 @@ Mpr                 *MPR;
 static MprHeap      *heap;
 static MprMemStats  memStats;
 static int          padding[] = { 0, MANAGER_SIZE };
+#if THREAD_CACHE
+static pthread_key_t threadCacheKey;
+static int          threadCacheEnabled;
+#endif
 
 /***************************** Forward Declarations ***************************/
 
@@ -174,14 +215,21 @@ static void allocException(int cause, ssize size);
 static void checkYielded();
 static void dummyManager(void *ptr, int flags);
 static ssize fastMemSize();
+static void finalize();
+static uint64 gcTime();
 static void *getNextRoot();
 static void getSystemInfo();
+static int growArena(MprArena *arena);
 static void initGen();
+static void manageArena(MprArena *arena, int flags);
 static void mark();
 static void marker(void *unused, MprThread *tp);
 static void markRoots();
 static void nextGen();
-static int pauseThreads();
+static void adviseBlock(MprMem *mp);
+static int pauseThreads(int timeout);
+static int releaseRegion(MprRegion *region);
+static void recordPause(uint64 start);
 static void sweep();
 static void resumeThreads();
 static void triggerGC(int flags);
@@ -208,9 +256,13 @@ static void monitorStack();
 
 static int initFree();
 static MprMem *allocMem(ssize size, int flags);
+static MprMem *allocSlot(MprSlab *slab, int id);
 static MprMem *freeBlock(MprMem *mp);
+static int freeSlots(MprRegion *region, MprMem *slots, int count);
 static int getQueueIndex(ssize size, int roundup);
 static MprMem *growHeap(ssize size, int flags);
+static int growSlab(MprSlab *slab);
+static MprMem *refillSlab(MprSlab *slab, MprMem **list, int count);
 static void linkBlock(MprMem *mp); 
 static void unlinkBlock(MprFreeMem *fp);
 static void *vmalloc(ssize size, int mode);
@@ -218,6 +270,12 @@ static void vmfree(void *ptr, ssize size);
 #if BIT_MEMORY_STATS
     static MprFreeMem *getQueue(ssize size);
 #endif
+#if THREAD_CACHE
+    static MprMem *allocCached(int index, ssize required, int flags);
+    static void flushThreadCache(void *data);
+    static ThreadCache *getThreadCache();
+    static MprMem *refillThreadCache(ThreadCache *cache, int hasManager, int index, ssize size);
+#endif
 
 /************************************* Code ***********************************/
 
@@ -251,6 +309,7 @@ Mpr *mprCreateMemService(MprManager manager, int flags)
     }
     mp = region->start = (MprMem*) (((char*) region) + regionSize);
     region->size = size;
+    region->slab = 0;
 
     MPR = (Mpr*) GET_PTR(mp);
     INIT_BLK(mp, mprSize, 1, 0, NULL);
@@ -265,6 +324,8 @@ Mpr *mprCreateMemService(MprManager manager, int flags)
     heap->stats.redLine = MAXINT / 100 * 99;
     heap->newQuota = MPR_NEW_QUOTA;
     heap->earlyYieldQuota = MPR_NEW_QUOTA * 5;
+    heap->retain = MPR_MEM_RETAIN;
+    heap->releaseDelay = MPR_MEM_RELEASE_DELAY;
     heap->enabled = !(heap->flags & MPR_DISABLE_GC);
     if (scmp(getenv("MPR_DISABLE_GC"), "1") == 0) {
         heap->enabled = 0;
@@ -298,7 +359,11 @@ Mpr *mprCreateMemService(MprManager manager, int flags)
     }
     heap->markerCond = mprCreateCond();
     heap->mutex = mprCreateLock();
+    heap->sweepLock = mprCreateLock();
     heap->roots = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
+#if THREAD_CACHE
+    threadCacheEnabled = pthread_key_create(&threadCacheKey, flushThreadCache) == 0;
+#endif
     mprAddRoot(MPR);
     return MPR;
 }
@@ -358,6 +423,75 @@ void *mprAllocMem(ssize usize, int flags)
 }
 
 
+int mprCreateSlab(cchar *name, ssize size, int flags)
+{
+    MprSlab     *slab;
+    int         id;
+
+    mprAssert(name && *name);
+    mprAssert(size > 0);
+
+    lockHeap();
+    for (id = 0; id < heap->numSlabs; id++) {
+        if (smatch(heap->slabs[id].name, name)) {
+            unlockHeap();
+            return id;
+        }
+    }
+    if (heap->numSlabs >= MPR_ALLOC_MAX_SLABS) {
+        unlockHeap();
+        return MPR_ERR_TOO_MANY;
+    }
+    slab = &heap->slabs[heap->numSlabs];
+    size += sizeof(MprMem) + (padding[flags & MPR_ALLOC_PAD_MASK] * sizeof(void*));
+    size = max(size, (ssize) sizeof(MprFreeMem));
+    slab->name = name;
+    slab->size = MPR_PAGE_ALIGN(size, MPR_ALLOC_SLAB_ALIGN);
+    slab->hasManager = (flags & MPR_ALLOC_MANAGER) ? 1 : 0;
+    slab->index = getQueueIndex(slab->size, 1);
+    slab->batch = (int) max(MPR_ALLOC_CACHE_BYTES / slab->size, 1);
+    mprInitSpinLock(&slab->lock);
+    mprAtomicBarrier();
+    id = heap->numSlabs++;
+    unlockHeap();
+    return id;
+}
+
+
+/*
+    Allocate a block from a slab pool. Fall back to the general heap if the slab is invalid or does not fit the request.
+ */
+void *mprAllocSlab(int id, ssize usize, int flags)
+{
+    MprSlab     *slab;
+    MprMem      *mp;
+    void        *ptr;
+
+    mprAssert(!heap->marking);
+    mprAssert(usize >= 0);
+
+    if (id < 0 || id >= heap->numSlabs) {
+        return mprAllocMem(usize, flags);
+    }
+    slab = &heap->slabs[id];
+    if (slab->hasManager != ((flags & MPR_ALLOC_MANAGER) ? 1 : 0) || 
+            (usize + (ssize) sizeof(MprMem) + (slab->hasManager * (ssize) sizeof(void*))) > slab->size) {
+        mprAssert(0);
+        return mprAllocMem(usize, flags);
+    }
+    if ((mp = allocSlot(slab, id)) == NULL) {
+        return NULL;
+    }
+    ptr = GET_PTR(mp);
+    if (flags & MPR_ALLOC_ZERO) {
+        memset(ptr, 0, GET_USIZE(mp));
+    }
+    BREAKPOINT(mp);
+    CHECK(mp);
+    return ptr;
+}
+
+
 /*
     Realloc will always zero new memory
  */
@@ -414,6 +548,175 @@ void *mprMemdupMem(cvoid *ptr, ssize usize)
 }
 
 
+/*
+    Arenas carve blocks from chunks which are ordinary unmanaged heap blocks. Each arena block has a block header that is 
+    eternal without a manager, so marking a reference to an arena block does nothing. The sweeper walks regions and never
+    sees arena block headers. The first word of each chunk links to the previous chunk.
+ */
+MprArena *mprCreateArena(ssize chunkSize)
+{
+    MprArena    *arena;
+
+    if ((arena = mprAllocObj(MprArena, manageArena)) == 0) {
+        return 0;
+    }
+    arena->chunkSize = (chunkSize > 0) ? MPR_ALLOC_ALIGN(chunkSize) : MPR_ARENA_CHUNK;
+    if (growArena(arena) < 0) {
+        return 0;
+    }
+    return arena;
+}
+
+
+static void manageArena(MprArena *arena, int flags)
+{
+    char    *chunk;
+
+    if (flags & MPR_MANAGE_MARK) {
+        for (chunk = arena->chunk; chunk; chunk = *(char**) chunk) {
+            mprMark(chunk);
+        }
+    }
+}
+
+
+static int growArena(MprArena *arena)
+{
+    char    *chunk;
+
+    if ((chunk = mprAllocMem(arena->chunkSize, 0)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    *(char**) chunk = arena->chunk;
+    arena->chunk = chunk;
+    arena->next = chunk + MPR_ALLOC_ALIGN(sizeof(char*));
+    arena->end = chunk + arena->chunkSize;
+    return 0;
+}
+
+
+void *mprArenaAlloc(MprArena *arena, ssize usize)
+{
+    MprMem      *mp;
+    ssize       size;
+
+    mprAssert(usize >= 0);
+
+    size = MPR_ALLOC_ALIGN(usize + sizeof(MprMem));
+    if (arena == 0 || size > (arena->chunkSize / 4)) {
+        return mprAllocMem(usize, 0);
+    }
+    if ((arena->next + size) > arena->end && growArena(arena) < 0) {
+        return 0;
+    }
+    mp = (MprMem*) arena->next;
+    arena->next += size;
+    SET_FIELD1(mp, NULL, 1, 0);
+    SET_FIELD2(mp, size, heap->eternal, UNMARKED, 0);
+    SET_MAGIC(mp);
+    SET_SEQ(mp);
+    SET_NAME(mp, "arena");
+    arena->allocs++;
+    return GET_PTR(mp);
+}
+
+
+char *mprArenaClone(MprArena *arena, cchar *str)
+{
+    char    *ptr;
+    ssize   len;
+
+    if (arena == 0) {
+        return sclone(str);
+    }
+    if (str == 0) {
+        str = "";
+    }
+    len = slen(str);
+    if ((ptr = mprArenaAlloc(arena, len + 1)) != 0) {
+        memcpy(ptr, str, len + 1);
+    }
+    return ptr;
+}
+
+
+char *mprArenaFmt(MprArena *arena, cchar *fmt, ...)
+{
+    va_list     ap;
+    char        *result;
+
+    va_start(ap, fmt);
+    result = mprArenaFmtv(arena, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+
+/*
+    Format into a stack buffer then copy into the arena. Results that may have been truncated are formatted again onto
+    the garbage collected heap.
+ */
+char *mprArenaFmtv(MprArena *arena, cchar *fmt, va_list args)
+{
+    va_list     ap;
+    char        buf[MPR_MAX_STRING];
+
+    if (arena) {
+        va_copy(ap, args);
+        mprSprintfv(buf, sizeof(buf), fmt, ap);
+        va_end(ap);
+        if (slen(buf) < (sizeof(buf) - 1)) {
+            return mprArenaClone(arena, buf);
+        }
+    }
+    return sfmtv(fmt, args);
+}
+
+
+bool mprIsArenaMem(MprArena *arena, cvoid *ptr)
+{
+    char    *chunk;
+
+    if (arena && ptr) {
+        for (chunk = arena->chunk; chunk; chunk = *(char**) chunk) {
+            if ((char*) ptr > chunk && (char*) ptr < &chunk[arena->chunkSize]) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+void *mprEscapeArena(MprArena *arena, cvoid *ptr)
+{
+    if (!mprIsArenaMem(arena, ptr)) {
+        return (void*) ptr;
+    }
+    return mprMemdupMem(ptr, GET_USIZE(GET_MEM(ptr)));
+}
+
+
+void mprResetArena(MprArena *arena)
+{
+    char    *chunk;
+
+    if (arena == 0) {
+        return;
+    }
+    for (chunk = arena->chunk; *(char**) chunk; chunk = *(char**) chunk) {
+        SCRIBBLE_RANGE(&chunk[sizeof(char*)], arena->chunkSize - sizeof(char*));
+    }
+    SCRIBBLE_RANGE(&chunk[sizeof(char*)], arena->chunkSize - sizeof(char*));
+    /* Later chunks are now unreferenced and will be collected */
+    *(char**) chunk = 0;
+    arena->chunk = chunk;
+    arena->next = chunk + MPR_ALLOC_ALIGN(sizeof(char*));
+    arena->end = chunk + arena->chunkSize;
+    arena->resets++;
+}
+
+
 int mprMemcmp(cvoid *s1, ssize s1Len, cvoid *s2, ssize s2Len)
 {
     int         rc;
@@ -514,9 +817,16 @@ static MprMem *allocMem(ssize required, int flags)
 #endif
 
     index = getQueueIndex(required, 1);
+#if THREAD_CACHE
+    if (index < MPR_ALLOC_CACHE_CLASSES && threadCacheEnabled && (mp = allocCached(index, required, flags)) != 0) {
+        return mp;
+    }
+#endif
     baseGroup = index / MPR_ALLOC_NUM_BUCKETS;
     bucket = index % MPR_ALLOC_NUM_BUCKETS;
-    heap->newCount += index;
+    if (!(flags & ALLOC_UNCOUNTED)) {
+        heap->newCount += index;
+    }
     INC(requests);
 
     /*
@@ -636,6 +946,7 @@ static MprMem *growHeap(ssize required, int flags)
     region->size = size;
     region->start = (MprMem*) (((char*) region) + rsize);
     region->freeable = 0;
+    region->slab = 0;
     mp = (MprMem*) region->start;
     hasManager = (flags & MPR_ALLOC_MANAGER) ? 1 : 0;
     spareLen = size - required - rsize;
@@ -652,6 +963,9 @@ static MprMem *growHeap(ssize required, int flags)
     lockHeap();
     region->next = heap->regions;
     heap->regions = region;
+    heap->stats.growths++;
+    heap->stats.growBytes += size;
+    heap->lastGrowth = mprGetTime();
 
     if (spareLen > 0) {
         mprAssert(spareLen >= sizeof(MprFreeMem));
@@ -668,6 +982,278 @@ static MprMem *growHeap(ssize required, int flags)
 }
 
 
+#if THREAD_CACHE
+/*
+    Allocate a small block from the calling thread's cache. The cache is created on first use. Return null if the 
+    thread cache is unavailable so the caller can fall back to the free queues.
+ */
+static MprMem *allocCached(int index, ssize required, int flags)
+{
+    ThreadCache     *cache;
+    MprMem          *mp;
+    int             hasManager;
+
+    if ((cache = getThreadCache()) == 0) {
+        return 0;
+    }
+    hasManager = (flags & MPR_ALLOC_MANAGER) ? 1 : 0;
+    if ((mp = cache->blocks[hasManager][index]) == 0) {
+        if ((mp = refillThreadCache(cache, hasManager, index, required)) == 0) {
+            return 0;
+        }
+    }
+    cache->blocks[hasManager][index] = *(MprMem**) GET_PTR(mp);
+    heap->newCount += index;
+#if BIT_MEMORY_STATS
+    cache->hits++;
+#endif
+    /* Lock-free update. The block is owned by this thread */
+    SET_FIELD2(mp, GET_SIZE(mp), heap->active, UNMARKED, 0);
+    return mp;
+}
+
+
+/*
+    Get the calling thread's cache. The cache is created on first use.
+ */
+static ThreadCache *getThreadCache()
+{
+    ThreadCache     *cache;
+
+    if ((cache = pthread_getspecific(threadCacheKey)) == 0) {
+        if (heap->destroying || (cache = calloc(1, sizeof(ThreadCache))) == 0) {
+            return 0;
+        }
+        if (pthread_setspecific(threadCacheKey, cache) != 0) {
+            free(cache);
+            return 0;
+        }
+    }
+    return cache;
+}
+
+
+/*
+    Refill a thread cache list by allocating one large block and carving it into blocks of the required size.
+    The carved blocks are eternal until allocated. Managed blocks have their manager slot reserved at this time as
+    field1 must only be updated while locked. Returns the first block which is left on the list.
+ */
+static MprMem *refillThreadCache(ThreadCache *cache, int hasManager, int index, ssize size)
+{
+    MprMem      *mp, *bp, *prior, *after;
+    ssize       total;
+    int         count, i, last;
+
+    count = (int) max(MPR_ALLOC_CACHE_BYTES / size, 1);
+    if ((mp = allocMem(size * count, ALLOC_UNCOUNTED)) == 0) {
+        return 0;
+    }
+    lockHeap();
+    total = GET_SIZE(mp);
+    count = (int) (total / size);
+    last = IS_LAST(mp);
+    after = GET_NEXT(mp);
+
+    /* Create the trailing blocks before shrinking the first so lock-free block traversals remain valid */
+    prior = mp;
+    for (i = 1; i < count; i++) {
+        bp = (MprMem*) ((char*) mp + (i * size));
+        INIT_BLK(bp, (i < (count - 1)) ? size : (total - (i * size)), hasManager, (i < (count - 1)) ? 0 : last, prior);
+        prior = bp;
+    }
+    if (after) {
+        SET_PRIOR(after, prior);
+    }
+    if (count > 1) {
+        SET_SIZE(mp, size);
+        mprAtomicBarrier();
+        SET_LAST(mp, 0);
+    }
+    SET_HAS_MANAGER(mp, hasManager);
+
+    for (i = 0, bp = mp; i < count; i++) {
+        SET_GEN(bp, heap->eternal);
+        if (hasManager) {
+            SET_MANAGER(bp, dummyManager);
+        }
+        after = (i < (count - 1)) ? (MprMem*) ((char*) bp + size) : cache->blocks[hasManager][index];
+        *(MprMem**) GET_PTR(bp) = after;
+        bp = after;
+    }
+    cache->blocks[hasManager][index] = mp;
+#if BIT_MEMORY_STATS
+    heap->stats.cacheRefills++;
+    heap->stats.cacheHits += cache->hits;
+    cache->hits = 0;
+#endif
+    unlockHeap();
+    return mp;
+}
+
+
+/*
+    Thread exit destructor. Release cached blocks to the collector which will return them to the free queues 
+    (and coalesce them) in the next sweep. The sweeper is the only code that may coalesce blocks.
+ */
+static void flushThreadCache(void *data)
+{
+    ThreadCache     *cache;
+    MprMem          *mp, *next;
+    int             hasManager, index;
+
+    cache = data;
+    for (hasManager = 0; hasManager < 2; hasManager++) {
+        for (index = 0; index < MPR_ALLOC_CACHE_CLASSES; index++) {
+            for (mp = cache->blocks[hasManager][index]; mp; mp = next) {
+                next = *(MprMem**) GET_PTR(mp);
+                SET_FIELD2(mp, GET_SIZE(mp), heap->active, UNMARKED, 0);
+            }
+        }
+    }
+    for (index = 0; index < MPR_ALLOC_MAX_SLABS; index++) {
+        for (mp = cache->slabs[index]; mp; mp = next) {
+            next = *(MprMem**) GET_PTR(mp);
+            SET_FIELD2(mp, GET_SIZE(mp), heap->active, UNMARKED, 0);
+        }
+    }
+#if BIT_MEMORY_STATS
+    lockHeap();
+    heap->stats.cacheFlushes++;
+    heap->stats.cacheHits += cache->hits;
+    unlockHeap();
+#endif
+    free(cache);
+}
+#endif /* THREAD_CACHE */
+
+
+/*
+    Allocate a slot from a slab. Slots are taken from the calling thread's cache which is refilled with a batch of slots
+    at a time. Without a thread cache, one slot is taken from the slab at a time.
+ */
+static MprMem *allocSlot(MprSlab *slab, int id)
+{
+    MprMem      *mp, **list, *local;
+    int         count;
+
+    local = 0;
+    list = &local;
+    count = 1;
+#if THREAD_CACHE
+    {
+        ThreadCache     *cache;
+
+        if (threadCacheEnabled && (cache = getThreadCache()) != 0) {
+            list = &cache->slabs[id];
+            count = slab->batch;
+        }
+    }
+#endif
+    if ((mp = *list) == 0) {
+        if ((mp = refillSlab(slab, list, count)) == 0) {
+            return 0;
+        }
+    }
+    *list = *(MprMem**) GET_PTR(mp);
+    heap->newCount += slab->index;
+    INC(requests);
+    /* Lock-free update. The slot is owned by this thread */
+    SET_FIELD2(mp, slab->size, heap->active, UNMARKED, 0);
+    return mp;
+}
+
+
+/*
+    Move up to count free slots from a slab region to the front of a list. Grow the slab if there are no free slots.
+    Returns the first slot which is left on the list.
+ */
+static MprMem *refillSlab(MprSlab *slab, MprMem **list, int count)
+{
+    MprRegion   *region;
+    MprMem      *first, *mp;
+    int         i;
+
+    mprSpinLock(&slab->lock);
+    for (region = slab->regions; region && region->freeSlots == 0; region = region->nextSlab) ;
+    while (region == 0) {
+        mprSpinUnlock(&slab->lock);
+        if (growSlab(slab) < 0) {
+            return 0;
+        }
+        mprSpinLock(&slab->lock);
+        for (region = slab->regions; region && region->freeSlots == 0; region = region->nextSlab) ;
+    }
+    count = min(count, region->freeSlots);
+    first = mp = region->slots;
+    for (i = 1; i < count; i++) {
+        mp = *(MprMem**) GET_PTR(mp);
+    }
+    region->slots = *(MprMem**) GET_PTR(mp);
+    region->freeSlots -= count;
+    *(MprMem**) GET_PTR(mp) = *list;
+    *list = first;
+    mprSpinUnlock(&slab->lock);
+    return first;
+}
+
+
+/*
+    Add a region of slots to a slab. The first slot is aligned to MPR_ALLOC_SLAB_ALIGN and slots are laid out as 
+    ordinary heap blocks so the collector can walk the region. Free slots are eternal so the collector ignores them.
+ */
+static int growSlab(MprSlab *slab)
+{
+    MprRegion   *region;
+    MprMem      *mp, *prior;
+    ssize       size;
+    char        *start;
+    int         count, i;
+
+    triggerGC(0);
+    size = MPR_PAGE_ALIGN(heap->chunkSize, memStats.pageSize);
+    if ((region = mprVirtAlloc(size, MPR_MAP_READ | MPR_MAP_WRITE)) == NULL) {
+        return MPR_ERR_MEMORY;
+    }
+    start = (char*) MPR_PAGE_ALIGN(((char*) region) + MPR_ALLOC_ALIGN(sizeof(MprRegion)), MPR_ALLOC_SLAB_ALIGN);
+    count = (int) ((((char*) region) + size - start) / slab->size);
+    mprAssert(count > 0);
+
+    mprInitSpinLock(&region->lock);
+    region->size = size;
+    region->start = (MprMem*) start;
+    region->freeable = 0;
+    region->slab = slab;
+    region->slots = region->start;
+    region->freeSlots = region->numSlots = count;
+
+    for (i = 0, prior = NULL; i < count; i++) {
+        mp = (MprMem*) (start + (i * slab->size));
+        INIT_BLK(mp, slab->size, slab->hasManager, i == (count - 1), prior);
+        SET_GEN(mp, heap->eternal);
+        if (slab->hasManager) {
+            SET_MANAGER(mp, dummyManager);
+        }
+        *(MprMem**) GET_PTR(mp) = (i < (count - 1)) ? (MprMem*) (start + ((i + 1) * slab->size)) : NULL;
+        prior = mp;
+    }
+    /* Add to the heap before the slab so the collector sees the region before any slot is allocated */
+    lockHeap();
+    region->next = heap->regions;
+    heap->regions = region;
+    heap->stats.growths++;
+    heap->stats.growBytes += size;
+    heap->lastGrowth = mprGetTime();
+    INC(allocs);
+    unlockHeap();
+
+    mprSpinLock(&slab->lock);
+    region->nextSlab = slab->regions;
+    slab->regions = region;
+    mprSpinUnlock(&slab->lock);
+    return 0;
+}
+
+
 /*
     Free a block. MUST only ever be called by the sweeper. The sweeper takes advantage of the fact that only it 
     coalesces blocks.
@@ -675,7 +1261,6 @@ static MprMem *growHeap(ssize required, int flags)
 static MprMem *freeBlock(MprMem *mp)
 {
     MprMem      *prev, *next, *after;
-    MprRegion   *region;
     ssize       size;
 
     BREAKPOINT(mp);
@@ -728,20 +1313,8 @@ static MprMem *freeBlock(MprMem *mp)
         mprAssert(prev == 0 || !IS_FREE(prev));
     }
     next = GET_NEXT(mp);
-
-    /*
-        Release entire regions back to the O/S. (Blocks equal to Empty regions have no prior and are last)
-     */
-    if (GET_PRIOR(mp) == NULL && IS_LAST(mp) && heap->stats.bytesFree > (MPR_MEM_REGION_SIZE * 4)) {
-        INC(unpins);
-        unlockHeap();
-        region = GET_REGION(mp);
-        region->freeable = 1;
-        mprAssert(next == NULL);
-    } else {
-        linkBlock(mp);
-        unlockHeap();
-    }
+    linkBlock(mp);
+    unlockHeap();
     /*
         WARN: there is a race here. Another thread may allocate and split the block just freed. So next will be
         pessimistic and there may be newly created intervening blocks.
@@ -866,6 +1439,9 @@ static void unlinkBlock(MprFreeMem *fp)
     mp = (MprMem*) fp;
     size = GET_SIZE(mp);
     heap->stats.bytesFree -= size;
+    if (heap->stats.bytesFree < heap->freeLow) {
+        heap->freeLow = heap->stats.bytesFree;
+    }
     mprAssert(IS_FREE(mp));
     SET_FREE(mp, 0);
     mprAtomicBarrier();
@@ -1063,19 +1639,12 @@ void mprRequestGC(int flags)
  */
 static void resumeThreads()
 {
-#if BIT_MEMORY_STATS
-    LOG(7, "GC: MARKED %,d/%,d, SWEPT %,d/%,d, freed %,d, bytesFree %,d (prior %,d), newCount %,d/%,d, " 
-            "blocks %,d bytes %,d",
-            heap->stats.marked, heap->stats.markVisited, heap->stats.swept, heap->stats.sweepVisited, 
-            (int) heap->stats.freed, (int) heap->stats.bytesFree, (int) heap->priorFree, heap->priorNewCount, heap->newQuota,
-            heap->stats.sweepVisited - heap->stats.swept, (int) heap->stats.bytesAllocated);
-#endif
 #if PARALLEL_GC
     heap->mustYield = 1;
     if (heap->notifier) {
         (heap->notifier)(MPR_MEM_ATTENTION, 0);
     }
-    if (pauseThreads()) {
+    if (pauseThreads(MPR_TIMEOUT_GC_SYNC)) {
         nextGen();
     } else {
         LOG(7, "DEBUG: Pause for GC sync timed out");
@@ -1088,7 +1657,11 @@ static void resumeThreads()
 
 static void mark()
 {
+    uint64      begin, start;
+    int         concurrent, timeout;
+
     LOG(7, "GC: mark started");
+    start = gcTime();
 
     /*
         When parallel, we mark blocks using the current heap->active mark. After marking, synchronization will rotate
@@ -1102,13 +1675,30 @@ static void mark()
         heap->mustYield = 1;
     }
 #else
+    /*
+        Only wait briefly for threads to yield. If a thread is busy, release the threads that have yielded and retry 
+        later (see marker) rather than stall them all until the busy thread yields. Each retry waits twice as long and
+        after repeated failures, wait the full sync period so collection is not starved.
+     */
     heap->mustYield = 1;
-    if (!pauseThreads()) {
-        LOG(6, "DEBUG: GC synchronization timed out, some threads did not yield.");
-        LOG(6, "This is most often caused by a thread doing a long running operation and not first calling mprYield.");
-        LOG(6, "If debugging, run the process with -D to enable debug mode.");
+    if (heap->handshakeFailures < MPR_GC_HANDSHAKE_RETRIES) {
+        timeout = MPR_TIMEOUT_GC_HANDSHAKE << heap->handshakeFailures;
+    } else {
+        timeout = MPR_TIMEOUT_GC_SYNC;
+    }
+    if (!pauseThreads(timeout)) {
+        if (timeout == MPR_TIMEOUT_GC_SYNC) {
+            LOG(6, "DEBUG: GC synchronization timed out, some threads did not yield.");
+            LOG(6, "This is most often caused by a thread doing a long running operation and not first calling mprYield.");
+            LOG(6, "If debugging, run the process with -D to enable debug mode.");
+        }
+        heap->handshakeFailures++;
+        heap->pauses.aborted++;
+        resumeThreads();
+        recordPause(start);
         return;
     }
+    heap->handshakeFailures = 0;
     nextGen();
 #endif
     heap->priorNewCount = heap->newCount;
@@ -1116,44 +1706,165 @@ static void mark()
     heap->newCount = 0;
     heap->gc = 0;
     checkYielded();
+    begin = gcTime();
     markRoots();
+    heap->stats.markTime += gcTime() - begin;
     heap->marking = 0;
+    /*
+        With multiple CPUs, free dead blocks after resuming other threads. Dead blocks are unreachable and new blocks 
+        are allocated in the active generation, so only the sweeper touches dead blocks. On a single CPU, sweeping 
+        concurrently only adds heap lock contention, so sweep while paused.
+     */
+    concurrent = heap->stats.numCpu > 1;
     if (!heap->hasSweeper) {
-        MPR_MEASURE(7, "GC", "sweep", sweep());
+        MPR_MEASURE(7, "GC", "finalize", finalize());
+        if (!concurrent) {
+            MPR_MEASURE(7, "GC", "sweep", sweep());
+        }
     }
     resumeThreads();
+    recordPause(start);
+    if (!heap->hasSweeper && concurrent) {
+        MPR_MEASURE(7, "GC", "sweep", sweep());
+    }
+#if BIT_MEMORY_STATS
+    LOG(7, "GC: MARKED %,d/%,d, SWEPT %,d/%,d, freed %,d, bytesFree %,d (prior %,d), newCount %,d/%,d, " 
+            "blocks %,d bytes %,d",
+            heap->stats.marked, heap->stats.markVisited, heap->stats.swept, heap->stats.sweepVisited, 
+            (int) heap->stats.freed, (int) heap->stats.bytesFree, (int) heap->priorFree, heap->priorNewCount, heap->newQuota,
+            heap->stats.sweepVisited - heap->stats.swept, (int) heap->stats.bytesAllocated);
+#endif
 }
 
 
 /*
-    Sweep up the garbage.
-    WARNING: This code uses lock-free algorithms. The sweeper traverses the region list and block list without locking. 
-    Other code must similarly use lock-free code -- only add regions to the start of the regions list and never 
-    otherwise modify the region list. Other code may modify blocks on the list, but must atomically update MprMem.field1.
-    The sweeper is the only routine to do coalesing, other code may split blocks, but this can be done in a lock-free 
-    manner by creating the spare 2nd half block first and then updating mp->field2 with the size and last bit.
-*/
-static void sweep()
+    Record the time threads were held for a collection or an abandoned handshake
+ */
+static void recordPause(uint64 start)
 {
-    MprRegion   *region, *nextRegion, *prior;
-    MprMem      *mp, *next;
-    MprManager  mgr;
-    
-    if (!heap->enabled) {
-        LOG(7, "DEBUG: sweep: Abort sweep - GC disabled");
-        return;
-    }
-    LOG(7, "GC: sweep started");
-    heap->stats.freed = 0;
+    MprGCPauses     *pauses;
+    uint64          elapsed, t;
+    int             bucket;
 
-    if (heap->newCount > heap->earlyYieldQuota) {
-        heap->mustYield = 1;
+    pauses = &heap->pauses;
+    elapsed = gcTime() - start;
+    for (bucket = 0, t = elapsed >> MPR_GC_PAUSE_SHIFT; t && bucket < (MPR_GC_PAUSE_BUCKETS - 1); t >>= 1) {
+        bucket++;
     }
+    pauses->histogram[bucket]++;
+    pauses->count++;
+    pauses->total += elapsed;
+    if (elapsed > pauses->max) {
+        pauses->max = elapsed;
+    }
+}
+
 
+void mprGetGCPauses(MprGCPauses *pauses)
+{
+    *pauses = heap->pauses;
+}
+
+
+void mprGetHeapStats(MprHeapStats *sp)
+{
+    MprRegion   *region;
+    MprMem      *mp;
+    MprGenStats *gp;
+    uint64      free;
+    ssize       size;
+    int         gen;
+
+    memset(sp, 0, sizeof(MprHeapStats));
     /*
-        Run all destructors first so all destructors can guarantee dependant memory blocks will still exist.
-        Actually free the memory in a 2nd pass below.
+        Walk the heap like the sweeper without the heap lock so allocating threads are not held for the walk. Growing
+        the heap only prepends regions and splitting blocks is lock-free, so only the sweeper (which coalesces blocks
+        and frees regions) must be excluded. The walk does not allocate, so stay yielded to not delay a collection.
      */
+    mprYield(MPR_YIELD_STICKY);
+    mprLock(heap->sweepLock);
+    for (region = heap->regions; region; region = region->next) {
+        sp->regions++;
+        sp->heapSize += region->size;
+        if (region->slab) {
+            sp->slabFree.blocks += region->freeSlots;
+            sp->slabFree.bytes += region->freeSlots * region->slab->size;
+        }
+        for (mp = region->start; mp; mp = GET_NEXT(mp)) {
+            size = GET_SIZE(mp);
+            gen = GET_GEN(mp);
+            if (IS_FREE(mp)) {
+                gp = &sp->free;
+                if ((uint64) size > sp->largestFree) {
+                    sp->largestFree = size;
+                }
+            } else if (gen == heap->active) {
+                gp = &sp->active;
+            } else if (gen == heap->dead) {
+                gp = &sp->dead;
+            } else {
+                gp = &sp->eternal;
+            }
+            gp->blocks++;
+            gp->bytes += size;
+        }
+    }
+    mprUnlock(heap->sweepLock);
+    mprResetYield();
+
+    lockHeap();
+    sp->collections = heap->iteration;
+    sp->syncTime = heap->stats.syncTime;
+    sp->markTime = heap->stats.markTime;
+    sp->sweepTime = heap->stats.sweepTime;
+    sp->freed = heap->stats.totalFreed;
+    sp->growths = heap->stats.growths;
+    sp->growBytes = heap->stats.growBytes;
+    sp->releases = heap->stats.releases;
+    sp->released = heap->stats.releasedBytes;
+    sp->advised = heap->stats.advisedBytes;
+    sp->bytesAllocated = heap->stats.bytesAllocated;
+    sp->bytesFree = heap->stats.bytesFree;
+    sp->pauses = heap->pauses;
+    unlockHeap();
+
+    free = sp->free.bytes;
+    sp->fragmentation = free ? (int) (100 - (sp->largestFree * 100 / free)) : 0;
+}
+
+
+/*
+    Microsecond clock for pause measurement
+ */
+static uint64 gcTime()
+{
+#if VXWORKS
+    struct timespec  tv;
+    clock_gettime(CLOCK_REALTIME, &tv);
+    return (((uint64) tv.tv_sec) * 1000000) + (tv.tv_nsec / 1000);
+#else
+    struct timeval  tv;
+    gettimeofday(&tv, NULL);
+    return (((uint64) tv.tv_sec) * 1000000) + tv.tv_usec;
+#endif
+}
+
+
+/*
+    Run the managers of dead blocks. This runs while threads are paused so managers see a stopped world, and before the 
+    sweep so managers can rely on dependant memory blocks still existing.
+ */
+static void finalize()
+{
+    MprRegion   *region;
+    MprMem      *mp;
+    MprManager  mgr;
+    uint64      start;
+    
+    if (!heap->enabled) {
+        return;
+    }
+    start = gcTime();
     for (region = heap->regions; region; region = region->next) {
         /*
             This code assumes that no other code coalesces blocks and that splitting blocks will be done lock-free
@@ -1170,6 +1881,44 @@ static void sweep()
             }
         }
     }
+    heap->stats.sweepTime += gcTime() - start;
+}
+
+
+/*
+    Sweep up the garbage. This may run after threads have resumed from the collection pause.
+    WARNING: This code uses lock-free algorithms. The sweeper traverses the region list and block list without locking. 
+    Other code must similarly use lock-free code -- only add regions to the start of the regions list and never 
+    otherwise modify the region list. Other code may modify blocks on the list, but must atomically update MprMem.field1.
+    The sweeper is the only routine to do coalesing, other code may split blocks, but this can be done in a lock-free 
+    manner by creating the spare 2nd half block first and then updating mp->field2 with the size and last bit.
+*/
+static void sweep()
+{
+    MprRegion   *region, *nextRegion, *prior;
+    MprMem      *mp, *next, *slots;
+    uint64      start;
+    int         count, release;
+    
+    if (!heap->enabled) {
+        LOG(7, "DEBUG: sweep: Abort sweep - GC disabled");
+        return;
+    }
+    LOG(7, "GC: sweep started");
+    start = gcTime();
+
+    /*
+        Pages of free blocks in used regions may be released if they were not needed since the last sweep. If the 
+        heap grew recently, this memory is about to be needed, so keep it.
+     */
+    lockHeap();
+    if (mprGetElapsedTime(heap->lastGrowth) >= heap->releaseDelay) {
+        heap->releaseBudget = heap->freeLow - heap->retain;
+    } else {
+        heap->releaseBudget = 0;
+    }
+    unlockHeap();
+    heap->stats.freed = 0;
     heap->stats.sweepVisited = 0;
     heap->stats.swept = 0;
 
@@ -1177,11 +1926,15 @@ static void sweep()
         growHeap() will append new regions to the front of heap->regions and so will not race with this code. This code
         is the only code that frees regions.
         RACE: Take from the front. Racing with growHeap.
+        Heap walkers (mprGetHeapStats) lock sweepLock to not race with coalescing and freeing regions.
      */
+    mprLock(heap->sweepLock);
     prior = NULL;
     for (region = heap->regions; region; region = nextRegion) {
         mprAssert(region->freeable == 0 || region->freeable == 1);
         nextRegion = region->next;
+        slots = 0;
+        count = 0;
 
         /*
             This code assumes that no other code coalesces blocks and that splitting blocks will be done lock-free
@@ -1200,8 +1953,25 @@ static void sweep()
                 }
 #endif
                 heap->stats.freed += GET_SIZE(mp);
-                next = freeBlock(mp);
+                if (region->slab) {
+                    /* Slab slots are never coalesced. Collect them to return to the region */
+                    next = GET_NEXT(mp);
+                    SCRIBBLE(mp);
+                    if (HAS_MANAGER(mp)) {
+                        SET_MANAGER(mp, dummyManager);
+                    }
+                    *(MprMem**) GET_PTR(mp) = slots;
+                    slots = mp;
+                    count++;
+                    SET_FIELD2(mp, GET_SIZE(mp), heap->eternal, UNMARKED, 0);
+                } else {
+                    next = freeBlock(mp);
+                }
             } else {
+                if (IS_FREE(mp) && heap->releaseBudget > 0 && GET_SIZE(mp) >= MPR_MEM_ADVISE_MIN && 
+                        (GET_PRIOR(mp) || !IS_LAST(mp))) {
+                    adviseBlock(mp);
+                }
                 /*
                     RACE: Block could be allocated here, but will never be coalesced (sweeper is the only one to do that).
                     So mp->field2 may be reduced so we may skip a newly created block -- no problem. Get it next scan.
@@ -1210,16 +1980,19 @@ static void sweep()
             }
         }
         /*
-            The sweeper is the only one who removes regions. 
-            Currently all threads are suspended so no locks needed. FUTURE - When doing parallel collection, do this 
-            lock-free because user code traverses the region list.
+            The sweeper is the only one who removes regions. Other threads are running, so growHeap may have added
+            regions to the front of the list since the sweep started.
          */ 
-        if (region->freeable) {
+        release = region->slab ? freeSlots(region, slots, count) : releaseRegion(region);
+        if (release) {
             lockHeap();
             if (prior) {
                 prior->next = nextRegion;
-            } else {
+            } else if (heap->regions == region) {
                 heap->regions = nextRegion;
+            } else {
+                for (prior = heap->regions; prior->next != region; prior = prior->next) ;
+                prior->next = nextRegion;
             }
             unlockHeap();
             LOG(9, "DEBUG: Unpin %p to %p size %d, used %d", region, 
@@ -1230,6 +2003,123 @@ static void sweep()
             prior = region;
         }
     }
+    mprUnlock(heap->sweepLock);
+    lockHeap();
+    heap->freeLow = heap->stats.bytesFree;
+    unlockHeap();
+    heap->stats.totalFreed += heap->stats.freed;
+    heap->stats.sweepTime += gcTime() - start;
+}
+
+
+/*
+    Release the pages of a large free block to the O/S. The pages read back as zero when next used. The block is 
+    removed from the free queues while advising so it can't be allocated. A marker after the free block header 
+    records the block address and size so the same block is not advised on every sweep. If the block is allocated,
+    split or coalesced, the marker will not match and the block may be advised again.
+ */
+static void adviseBlock(MprMem *mp)
+{
+#if VALLOC && BIT_UNIX_LIKE && defined(MADV_DONTNEED)
+    ssize       *marker, size, len;
+    char        *start, *end;
+
+    if (heap->scribble) {
+        return;
+    }
+    lockHeap();
+    size = GET_SIZE(mp);
+    marker = (ssize*) ((char*) mp + sizeof(MprFreeMem));
+    start = (char*) MPR_PAGE_ALIGN(&marker[2], memStats.pageSize);
+    end = (char*) (((ssize) mp + size) & ~((ssize) memStats.pageSize - 1));
+    len = end - start;
+    if (!IS_FREE(mp) || len <= 0 || len > heap->releaseBudget || 
+            (marker[0] == ((ssize) mp ^ MPR_ALLOC_MAGIC) && marker[1] == size)) {
+        unlockHeap();
+        return;
+    }
+    unlinkBlock((MprFreeMem*) mp);
+    marker[0] = (ssize) mp ^ MPR_ALLOC_MAGIC;
+    marker[1] = size;
+    heap->releaseBudget -= len;
+    heap->stats.advisedBytes += len;
+    unlockHeap();
+
+    madvise(start, len, MADV_DONTNEED);
+
+    lockHeap();
+    linkBlock(mp);
+    unlockHeap();
+#endif
+}
+
+
+/*
+    Claim an entirely free region for release to the O/S if the heap has more free memory than the retain target. 
+    An empty region is one free block with no prior block that is the last block. Returns true if the region's block 
+    has been removed from the free queues and the region may be unmapped.
+ */
+static int releaseRegion(MprRegion *region)
+{
+    MprMem      *mp;
+
+    mp = region->start;
+    if (!IS_FREE(mp) || !IS_LAST(mp) || heap->stats.bytesFree <= heap->retain) {
+        return 0;
+    }
+    lockHeap();
+    if (!IS_FREE(mp) || !IS_LAST(mp) || heap->stats.bytesFree <= heap->retain) {
+        unlockHeap();
+        return 0;
+    }
+    unlinkBlock((MprFreeMem*) mp);
+    region->freeable = 1;
+    heap->stats.releases++;
+    heap->stats.releasedBytes += region->size;
+    INC(unpins);
+    unlockHeap();
+    return 1;
+}
+
+
+/*
+    Return slots freed by the sweeper to their slab region. If the region is now entirely free and the slab has free slots
+    in another region, remove the region from the slab. Returns true if the region may be unmapped.
+ */
+static int freeSlots(MprRegion *region, MprMem *slots, int count)
+{
+    MprSlab     *slab;
+    MprRegion   *rp, **prior;
+    MprMem      *mp;
+
+    slab = region->slab;
+    mprSpinLock(&slab->lock);
+    if (slots) {
+        for (mp = slots; *(MprMem**) GET_PTR(mp); mp = *(MprMem**) GET_PTR(mp)) ;
+        *(MprMem**) GET_PTR(mp) = region->slots;
+        region->slots = slots;
+        region->freeSlots += count;
+    }
+    if (region->freeSlots < region->numSlots) {
+        mprSpinUnlock(&slab->lock);
+        return 0;
+    }
+    for (rp = slab->regions; rp && (rp == region || rp->freeSlots == 0); rp = rp->nextSlab) ;
+    if (rp == 0) {
+        mprSpinUnlock(&slab->lock);
+        return 0;
+    }
+    for (prior = &slab->regions; *prior != region; prior = &(*prior)->nextSlab) ;
+    *prior = region->nextSlab;
+    mprSpinUnlock(&slab->lock);
+
+    lockHeap();
+    region->freeable = 1;
+    heap->stats.releases++;
+    heap->stats.releasedBytes += region->size;
+    INC(unpins);
+    unlockHeap();
+    return 1;
 }
 
 
@@ -1241,6 +2131,7 @@ static void markRoots()
     heap->stats.marked = 0;
     mprMark(heap->roots);
     mprMark(heap->mutex);
+    mprMark(heap->sweepLock);
     mprMark(heap->markerCond);
 
     heap->rootIndex = 0;
@@ -1281,6 +2172,10 @@ void mprMarkBlock(cvoid *ptr)
 #endif
     CHECK(mp);
     INC(markVisited);
+    if (GET_GEN(mp) == heap->eternal && !HAS_MANAGER(mp)) {
+        /* Held or arena blocks without a manager have nothing to mark */
+        return;
+    }
     mprAssert((GET_MARK(mp) != heap->active) || GET_GEN(mp) == heap->active);
 
     if (GET_MARK(mp) != heap->active) {
@@ -1370,12 +2265,33 @@ static void marker(void *unused, MprThread *tp)
 
     while (!mprIsFinished()) {
         if (!heap->mustYield) {
-            mprWaitForCond(heap->markerCond, -1);
+            /*
+                If idle with surplus free memory, collect after a delay so free regions can be released
+             */
+            mprWaitForCond(heap->markerCond, heap->stats.bytesFree > heap->retain ? heap->releaseDelay : -1);
             if (mprIsFinished()) {
                 break;
             }
+            if (!heap->mustYield) {
+                if (heap->stats.bytesFree <= heap->retain || heap->newCount == 0) {
+                    continue;
+                }
+                heap->gc = 1;
+                heap->mustYield = 1;
+            }
         }
         MPR_MEASURE(7, "GC", "mark", mark());
+        if (heap->gc && !mprIsFinished()) {
+            /*
+                The collection is still due. Either threads did not all yield, or a sticky yielded thread requested 
+                a collection while marking and resumeThreads cleared mustYield. If threads did not yield, let the 
+                released threads run before retrying.
+             */
+            if (heap->handshakeFailures) {
+                mprWaitForCond(heap->markerCond, MPR_TIMEOUT_GC_HANDSHAKE);
+            }
+            heap->mustYield = 1;
+        }
     }
     heap->mustYield = 0;
 }
@@ -1466,18 +2382,19 @@ void mprResetYield()
     NOTE: this functions differently if parallel. If so, then it will abort waiting. If !parallel, it waits for all
     threads to yield.
  */
-static int pauseThreads()
+static int pauseThreads(int timeout)
 {
     MprThreadService    *ts;
     MprThread           *tp;
     MprTime             mark;
-    int                 i, allYielded, timeout;
+    uint64              start;
+    int                 i, allYielded;
 
 #if BIT_DEBUG
     uint64  ticks = mprGetTicks();
 #endif
     ts = MPR->threadService;
-    timeout = MPR_TIMEOUT_GC_SYNC;
+    start = gcTime();
 
     LOG(7, "pauseThreads: wait for threads to yield, timeout %d", timeout);
     mark = mprGetTime();
@@ -1512,13 +2429,14 @@ static int pauseThreads()
         }
         unlock(ts->threads);
         LOG(7, "pauseThreads: waiting for threads to yield");
-        mprWaitForCond(ts->cond, 20);
+        mprWaitForCond(ts->cond, min(timeout, 20));
 
     } while (!allYielded && mprGetElapsedTime(mark) < timeout);
 
 #if BIT_DEBUG
     LOG(7, "TIME: pauseThreads elapsed %,d msec, %,d ticks", mprGetElapsedTime(mark), mprGetTicks() - ticks);
 #endif
+    heap->stats.syncTime += gcTime() - start;
     if (allYielded) {
         checkYielded();
     }
@@ -1842,6 +2760,10 @@ void mprPrintMem(cchar *msg, int detail)
     printf("  Block reuse         %14d %%\n",            percent(ap->reuse, ap->requests));
     printf("  Joins               %14d %%\n",            percent(ap->joins, ap->requests));
     printf("  Splits              %14d %%\n",            percent(ap->splits, ap->requests));
+    printf("  Thread cache hits   %14d\n",               (int) ap->cacheHits);
+    printf("  Thread cache refills%14d\n",               (int) ap->cacheRefills);
+    printf("  Thread cache flushes%14d\n",               (int) ap->cacheFlushes);
+    printf("  Heap lock contention%14d %%\n",            percent(ap->heapContention, ap->requests));
 
     printGCStats();
     if (detail) {
@@ -2381,6 +3303,17 @@ void mprSetMemPolicy(int policy)
 }
 
 
+void mprSetMemRetain(ssize retain, MprTime delay)
+{
+    if (retain >= 0) {
+        heap->retain = retain;
+    }
+    if (delay >= 0) {
+        heap->releaseDelay = delay;
+    }
+}
+
+
 void mprSetMemError()
 {
     heap->hasError = 1;
@@ -2715,6 +3648,7 @@ static void manageMpr(Mpr *mpr, int flags)
         mprMark(mpr->threadService);
         mprMark(mpr->workerService);
         mprMark(mpr->waitService);
+        mprMark(mpr->reactors);
         mprMark(mpr->dispatcher);
         mprMark(mpr->nonBlock);
         mprMark(mpr->appwebService);
@@ -8045,6 +8979,8 @@ void mprAtomicAdd64(volatile int64 *ptr, int value)
     OSAtomicAdd64(value, ptr);
 #elif BIT_WIN_LIKE && BIT_64
     InterlockedExchangeAdd64(ptr, value);
+#elif BIT_HAS_SYNC_CAS
+    __sync_fetch_and_add(ptr, (int64) value);
 #elif BIT_UNIX_LIKE && FUTURE
     asm volatile ("lock; xaddl %0,%1"
         : "=r" (value), "=m" (*ptr)
@@ -8127,6 +9063,10 @@ void mprAtomicListInsert(void * volatile *head, volatile void **link, void *item
 
 
 
+/*********************************** Locals ***********************************/
+
+static int bufSlab = -1;                /* Slab pool for buffers */
+
 /********************************** Forwards **********************************/
 
 static void manageBuf(MprBuf *buf, int flags);
@@ -8144,7 +9084,10 @@ MprBuf *mprCreateBuf(ssize initialSize, ssize maxSize)
     if (initialSize <= 0) {
         initialSize = MPR_BUFSIZE;
     }
-    if ((bp = mprAllocObj(MprBuf, manageBuf)) == 0) {
+    if (bufSlab < 0) {
+        bufSlab = mprCreateSlab("MprBuf", sizeof(MprBuf), MPR_ALLOC_MANAGER);
+    }
+    if ((bp = mprAllocSlabObj(bufSlab, MprBuf, manageBuf)) == 0) {
         return 0;
     }
     bp->growBy = MPR_BUFSIZE;
@@ -12304,19 +13247,29 @@ MprDiskFileSystem *mprCreateDiskFileSystem(cchar *path)
 
 /***************************** Forward Declarations ***************************/
 
+static MprDispatcher *createDispatcher(MprEventService *es, cchar *name, int enable);
+static MprEventService *createEventService();
 static void dequeueDispatcher(MprDispatcher *dispatcher);
 static int dispatchEvents(MprDispatcher *dispatcher);
 static MprTime getDispatcherIdleTime(MprDispatcher *dispatcher, MprTime timeout);
 static MprTime getIdleTime(MprEventService *es, MprTime timeout);
 static MprDispatcher *getNextReadyDispatcher(MprEventService *es);
+static MprDispatcher *getNextWaitingDispatcher(MprEventService *es);
+static bool heapGrow(MprEventService *es);
+static void heapInsert(MprEventService *es, MprDispatcher *dispatcher);
+static void heapRemove(MprEventService *es, MprDispatcher *dispatcher);
+static void heapUpdate(MprEventService *es, MprDispatcher *dispatcher);
 static void initDispatcher(MprDispatcher *q);
 static int makeRunnable(MprDispatcher *dispatcher);
 static void manageDispatcher(MprDispatcher *dispatcher, int flags);
 static void manageEventService(MprEventService *es, int flags);
+static void manageReactor(MprReactor *reactor, int flags);
 static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher);
 static void scheduleDispatcher(MprDispatcher *dispatcher);
 static void serviceDispatcherMain(MprDispatcher *dispatcher);
 static bool serviceDispatcher(MprDispatcher *dp);
+static void serviceReactor(MprReactor *reactor, MprThread *tp);
+static void wakeEventService(MprEventService *es);
 
 #define isRunning(dispatcher) (dispatcher->parent == dispatcher->service->runQ)
 #define isReady(dispatcher) (dispatcher->parent == dispatcher->service->readyQ)
@@ -12331,18 +13284,36 @@ MprEventService *mprCreateEventService()
 {
     MprEventService     *es;
 
-    if ((es = mprAllocObj(MprEventService, manageEventService)) == 0) {
+    if ((es = createEventService()) == 0) {
         return 0;
     }
     MPR->eventService = es;
+    return es;
+}
+
+
+/*
+    Create an event service. Used for the primary event service and for the private event service of each reactor.
+ */
+static MprEventService *createEventService()
+{
+    MprEventService     *es;
+
+    if ((es = mprAllocObj(MprEventService, manageEventService)) == 0) {
+        return 0;
+    }
     es->now = mprGetTime();
     es->mutex = mprCreateLock();
     es->waitCond = mprCreateCond();
-    es->runQ = mprCreateDispatcher("running", 0);
-    es->readyQ = mprCreateDispatcher("ready", 0);
-    es->idleQ = mprCreateDispatcher("idle", 0);
-    es->pendingQ = mprCreateDispatcher("pending", 0);
-    es->waitQ = mprCreateDispatcher("waiting", 0);
+    es->runQ = createDispatcher(es, "running", 0);
+    es->readyQ = createDispatcher(es, "ready", 0);
+    es->idleQ = createDispatcher(es, "idle", 0);
+    es->pendingQ = createDispatcher(es, "pending", 0);
+    es->waitQ = createDispatcher(es, "waiting", 0);
+    es->waitHeapMax = 64;
+    if ((es->waitHeap = mprAlloc(sizeof(MprDispatcher*) * es->waitHeapMax)) == 0) {
+        return 0;
+    }
     return es;
 }
 
@@ -12355,8 +13326,11 @@ static void manageEventService(MprEventService *es, int flags)
         mprMark(es->waitQ);
         mprMark(es->idleQ);
         mprMark(es->pendingQ);
+        mprMark(es->waitHeap);
         mprMark(es->waitCond);
         mprMark(es->mutex);
+        mprMark(es->waitService);
+        mprMark(es->reactor);
 
     } else if (flags & MPR_MANAGE_FREE) {
         /* Needed for race with manageDispatcher */
@@ -12369,6 +13343,20 @@ void mprStopEventService()
 {
     mprWakeDispatchers();
     mprWakeNotifier();
+    mprStopReactors();
+}
+
+
+/*
+    Wake the thread servicing an event service if it is waiting for I/O
+ */
+static void wakeEventService(MprEventService *es)
+{
+    if (es->waitService) {
+        mprWakeWaitService(es->waitService);
+    } else {
+        mprWakeNotifier();
+    }
 }
 
 
@@ -12377,7 +13365,12 @@ void mprStopEventService()
  */
 MprDispatcher *mprCreateDispatcher(cchar *name, int enable)
 {
-    MprEventService     *es;
+    return createDispatcher(MPR->eventService, name, enable);
+}
+
+
+static MprDispatcher *createDispatcher(MprEventService *es, cchar *name, int enable)
+{
     MprDispatcher       *dispatcher;
 
     if ((dispatcher = mprAllocObj(MprDispatcher, manageDispatcher)) == 0) {
@@ -12387,7 +13380,7 @@ MprDispatcher *mprCreateDispatcher(cchar *name, int enable)
     dispatcher->cond = mprCreateCond();
     dispatcher->enabled = enable;
     dispatcher->magic = MPR_DISPATCHER_MAGIC;
-    es = dispatcher->service = MPR->eventService;
+    dispatcher->service = es;
     dispatcher->eventQ = mprCreateEventQueue();
     if (enable) {
         queueDispatcher(es->idleQ, dispatcher);
@@ -12405,15 +13398,16 @@ void mprDestroyDispatcher(MprDispatcher *dispatcher)
 
     if (dispatcher && !dispatcher->destroyed) {
         es = dispatcher->service;
-        mprAssert(es == MPR->eventService);
         lock(es);
-        mprAssert(dispatcher->service == MPR->eventService);
         mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
         dequeueDispatcher(dispatcher);
         mprAssert(dispatcher->parent == dispatcher);
         q = dispatcher->eventQ;
         dispatcher->enabled = 0;
         dispatcher->destroyed = 1;
+        if (es->reactor) {
+            mprAtomicAdd(&es->reactor->pinned, -1);
+        }
         for (event = q->next; event != q; event = next) {
             mprAssert(event->magic == MPR_EVENT_MAGIC);
             next = event->next;
@@ -12484,7 +13478,7 @@ void mprEnableDispatcher(MprDispatcher *dispatcher)
     }
     unlock(es);
     if (mustWake) {
-        mprWakeNotifier();
+        wakeEventService(es);
     }
 }
 
@@ -12578,15 +13572,15 @@ int mprWaitForEvent(MprDispatcher *dispatcher, MprTime timeout)
     MprOsThread         thread;
     int                 claimed, signalled, wasRunning, runEvents;
 
+    if (dispatcher == NULL) {
+        dispatcher = MPR->dispatcher;
+    }
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
     mprAssert(!dispatcher->destroyed);
 
-    es = MPR->eventService;
+    es = dispatcher->service;
     es->now = mprGetTime();
 
-    if (dispatcher == NULL) {
-        dispatcher = MPR->dispatcher;
-    }
     mprAssert(!dispatcher->waitingOnCond);
     if (dispatcher->waitingOnCond) {
         return MPR_ERR_BUSY;
@@ -12773,7 +13767,7 @@ void mprScheduleDispatcher(MprDispatcher *dispatcher)
         mprSignalDispatcher(dispatcher);
     }
     if (mustWakeWaitService) {
-        mprWakeNotifier();
+        wakeEventService(es);
     }
 }
 
@@ -12814,7 +13808,7 @@ static int dispatchEvents(MprDispatcher *dispatcher)
     unlock(es);
     if (count && es->waiting) {
         es->eventCount += count;
-        mprWakeNotifier();
+        wakeEventService(es);
     }
     return count;
 }
@@ -12881,10 +13875,8 @@ void mprWakePendingDispatchers()
  */
 static MprDispatcher *getNextReadyDispatcher(MprEventService *es)
 {
-    MprDispatcher   *dp, *next, *pendingQ, *readyQ, *waitQ, *dispatcher;
-    MprEvent        *event;
+    MprDispatcher   *dp, *pendingQ, *readyQ, *dispatcher;
 
-    waitQ = es->waitQ;
     readyQ = es->readyQ;
     pendingQ = es->pendingQ;
     dispatcher = 0;
@@ -12899,18 +13891,10 @@ static MprDispatcher *getNextReadyDispatcher(MprEventService *es)
 
     } else if (readyQ->next == readyQ) {
         /*
-            ReadyQ is empty, try to transfer a dispatcher with due events onto the readyQ
+            ReadyQ is empty, try to transfer the dispatcher with the earliest due event onto the readyQ
          */
-        for (dp = waitQ->next; dp != waitQ; dp = next) {
-            mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
-            mprAssert(!dp->destroyed);
-            next = dp->next;
-            event = dp->eventQ->next;
-            mprAssert(event->magic == MPR_EVENT_MAGIC);
-            if (event->due <= es->now && dp->enabled) {
-                queueDispatcher(es->readyQ, dp);
-                break;
-            }
+        if ((dp = getNextWaitingDispatcher(es)) != 0 && dp->due <= es->now) {
+            queueDispatcher(es->readyQ, dp);
         }
     }
     if (!dispatcher && readyQ->next != readyQ) {
@@ -12934,11 +13918,9 @@ static MprDispatcher *getNextReadyDispatcher(MprEventService *es)
  */
 static MprTime getIdleTime(MprEventService *es, MprTime timeout)
 {
-    MprDispatcher   *readyQ, *waitQ, *dp;
-    MprEvent        *event;
+    MprDispatcher   *readyQ, *dp;
     MprTime         delay;
 
-    waitQ = es->waitQ;
     readyQ = es->readyQ;
 
     if (readyQ->next != readyQ) {
@@ -12947,20 +13929,8 @@ static MprTime getIdleTime(MprEventService *es, MprTime timeout)
         delay = 10;
     } else {
         delay = MPR_MAX_TIMEOUT;
-        /*
-            Examine all the dispatchers on the waitQ
-         */
-        for (dp = waitQ->next; dp != waitQ; dp = dp->next) {
-            mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
-            mprAssert(!dp->destroyed);
-            event = dp->eventQ->next;
-            mprAssert(event->magic == MPR_EVENT_MAGIC);
-            if (event != dp->eventQ) {
-                delay = min(delay, (event->due - es->now));
-                if (delay <= 0) {
-                    break;
-                }
-            }
+        if ((dp = getNextWaitingDispatcher(es)) != 0) {
+            delay = max(dp->due - es->now, 0);
         }
         delay = min(delay, timeout);
     }
@@ -12968,6 +13938,36 @@ static MprTime getIdleTime(MprEventService *es, MprTime timeout)
 }
 
 
+/*
+    Get the waiting dispatcher with the earliest due event. Must be called locked.
+    Heap keys are refreshed lazily here: events may have been removed since the dispatcher was put on the waitQ.
+    Dispatchers that have become empty or disabled are moved to the idleQ. mprEnableDispatcher and 
+    mprScheduleDispatcher will requeue them as required.
+ */
+static MprDispatcher *getNextWaitingDispatcher(MprEventService *es)
+{
+    MprDispatcher   *dp;
+    MprEvent        *event;
+
+    while (es->waitHeapCount > 0) {
+        dp = es->waitHeap[1];
+        mprAssert(dp->magic == MPR_DISPATCHER_MAGIC);
+        mprAssert(!dp->destroyed);
+        event = dp->eventQ->next;
+        mprAssert(event->magic == MPR_EVENT_MAGIC);
+        if (event == dp->eventQ || !dp->enabled) {
+            queueDispatcher(es->idleQ, dp);
+        } else if (event->due != dp->due) {
+            dp->due = event->due;
+            heapUpdate(es, dp);
+        } else {
+            return dp;
+        }
+    }
+    return 0;
+}
+
+
 static MprTime getDispatcherIdleTime(MprDispatcher *dispatcher, MprTime timeout)
 {
     MprEvent    *next;
@@ -13005,7 +14005,7 @@ static void initDispatcher(MprDispatcher *q)
 
 static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher)
 {
-    mprAssert(dispatcher->service == MPR->eventService);
+    mprAssert(dispatcher->service == prior->service);
     lock(dispatcher->service);
 
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
@@ -13014,11 +14014,18 @@ static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher)
     if (dispatcher->parent) {
         dequeueDispatcher(dispatcher);
     }
+    if (prior == dispatcher->service->waitQ && !heapGrow(dispatcher->service)) {
+        /* Can't track the dispatcher in the wait heap. Keep it runnable rather than strand it on the waitQ */
+        prior = dispatcher->service->readyQ;
+    }
     dispatcher->parent = prior->parent;
     dispatcher->prev = prior;
     dispatcher->next = prior->next;
     prior->next->prev = dispatcher;
     prior->next = dispatcher;
+    if (isWaiting(dispatcher)) {
+        heapInsert(dispatcher->service, dispatcher);
+    }
     mprAssert(dispatcher->cond);
     unlock(dispatcher->service);
 }
@@ -13029,12 +14036,14 @@ static void queueDispatcher(MprDispatcher *prior, MprDispatcher *dispatcher)
  */
 static void dequeueDispatcher(MprDispatcher *dispatcher)
 {
-    mprAssert(dispatcher->service == MPR->eventService);
     lock(dispatcher->service);
 
     mprAssert(dispatcher->magic == MPR_DISPATCHER_MAGIC);
     mprAssert(!dispatcher->destroyed);
            
+    if (dispatcher->heapIndex) {
+        heapRemove(dispatcher->service, dispatcher);
+    }
     if (dispatcher->next) {
         dispatcher->next->prev = dispatcher->prev;
         dispatcher->prev->next = dispatcher->next;
@@ -13051,11 +14060,132 @@ static void dequeueDispatcher(MprDispatcher *dispatcher)
 }
 
 
+/*
+    Wait heap. A binary min-heap of the dispatchers on the waitQ keyed by the due time of their first event. This makes
+    finding the next due dispatcher O(1) and queueing or removing a waiting dispatcher O(log n). The heap is 1-based
+    so a zero heapIndex means the dispatcher is not in the heap. Must be called locked.
+ */
+static void heapSet(MprEventService *es, int index, MprDispatcher *dispatcher)
+{
+    es->waitHeap[index] = dispatcher;
+    dispatcher->heapIndex = index;
+}
+
+
+static void heapSiftUp(MprEventService *es, int index)
+{
+    MprDispatcher   *dispatcher, *parent;
+
+    dispatcher = es->waitHeap[index];
+    while (index > 1) {
+        parent = es->waitHeap[index / 2];
+        if (parent->due <= dispatcher->due) {
+            break;
+        }
+        heapSet(es, index, parent);
+        index /= 2;
+    }
+    heapSet(es, index, dispatcher);
+}
+
+
+static void heapSiftDown(MprEventService *es, int index)
+{
+    MprDispatcher   *dispatcher, *child;
+    int             ci;
+
+    dispatcher = es->waitHeap[index];
+    while ((ci = index * 2) <= es->waitHeapCount) {
+        child = es->waitHeap[ci];
+        if (ci < es->waitHeapCount && es->waitHeap[ci + 1]->due < child->due) {
+            child = es->waitHeap[++ci];
+        }
+        if (dispatcher->due <= child->due) {
+            break;
+        }
+        heapSet(es, index, child);
+        index = ci;
+    }
+    heapSet(es, index, dispatcher);
+}
+
+
+/*
+    Ensure there is room in the heap for one more dispatcher. On failure, the existing heap is kept.
+ */
+static bool heapGrow(MprEventService *es)
+{
+    MprDispatcher   **heap;
+    int             max;
+
+    if ((es->waitHeapCount + 1) < es->waitHeapMax) {
+        return 1;
+    }
+    max = es->waitHeapMax * 2;
+    if ((heap = mprRealloc(es->waitHeap, sizeof(MprDispatcher*) * max)) == 0) {
+        mprAssert(!MPR_ERR_MEMORY);
+        return 0;
+    }
+    es->waitHeap = heap;
+    es->waitHeapMax = max;
+    return 1;
+}
+
+
+/*
+    Insert a dispatcher in the heap. The caller must first ensure there is room via heapGrow.
+ */
+static void heapInsert(MprEventService *es, MprDispatcher *dispatcher)
+{
+    MprEvent    *event;
+
+    mprAssert(dispatcher->heapIndex == 0);
+    mprAssert((es->waitHeapCount + 1) < es->waitHeapMax);
+    event = dispatcher->eventQ->next;
+    dispatcher->due = (event != dispatcher->eventQ) ? event->due : 0;
+    heapSet(es, ++es->waitHeapCount, dispatcher);
+    heapSiftUp(es, es->waitHeapCount);
+}
+
+
+static void heapRemove(MprEventService *es, MprDispatcher *dispatcher)
+{
+    MprDispatcher   *last;
+    int             index;
+
+    index = dispatcher->heapIndex;
+    mprAssert(index > 0 && index <= es->waitHeapCount);
+    mprAssert(es->waitHeap[index] == dispatcher);
+
+    last = es->waitHeap[es->waitHeapCount--];
+    dispatcher->heapIndex = 0;
+    if (last != dispatcher) {
+        heapSet(es, index, last);
+        heapUpdate(es, last);
+    }
+}
+
+
+/*
+    Restore heap order after a dispatcher's due time has changed
+ */
+static void heapUpdate(MprEventService *es, MprDispatcher *dispatcher)
+{
+    int     index;
+
+    index = dispatcher->heapIndex;
+    if (index > 1 && es->waitHeap[index / 2]->due > dispatcher->due) {
+        heapSiftUp(es, index);
+    } else {
+        heapSiftDown(es, index);
+    }
+}
+
+
 static void scheduleDispatcher(MprDispatcher *dispatcher)
 {
     MprEventService     *es;
 
-    mprAssert(dispatcher->service == MPR->eventService);
     es = dispatcher->service;
 
     lock(es);
@@ -13108,16 +14238,202 @@ void mprSignalDispatcher(MprDispatcher *dispatcher)
     if (dispatcher == NULL) {
         dispatcher = MPR->dispatcher;
     }
-    mprSignalCond(dispatcher->cond);
+    mprSignalCond(dispatcher->cond);
+}
+
+
+bool mprDispatcherHasEvents(MprDispatcher *dispatcher)
+{
+    if (dispatcher == 0) {
+        return 0;
+    }
+    return !isEmpty(dispatcher);
+}
+
+
+/*
+    Start the reactors. Each reactor has a private event service and wait service (epoll instance) and a dedicated 
+    thread. Dispatchers pinned to a reactor are serviced inline on the reactor thread.
+ */
+int mprStartReactors(int count)
+{
+#if MPR_EVENT_EPOLL
+    MprReactor      *reactor;
+    MprThread       *tp;
+    int             i;
+
+    if (count < 0) {
+        count = mprGetMemStats()->numCpu;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (MPR->reactors) {
+        mprError("Reactors already started");
+        return MPR_ERR_BAD_STATE;
+    }
+    MPR->reactors = mprCreateList(count, 0);
+    for (i = 0; i < count; i++) {
+        if ((reactor = mprAllocObj(MprReactor, manageReactor)) == 0) {
+            return MPR_ERR_MEMORY;
+        }
+        reactor->index = i;
+        if ((reactor->eventService = createEventService()) == 0) {
+            return MPR_ERR_MEMORY;
+        }
+        if ((reactor->waitService = mprCreatePrivateWaitService()) == 0) {
+            return MPR_ERR_CANT_INITIALIZE;
+        }
+        reactor->eventService->waitService = reactor->waitService;
+        reactor->eventService->reactor = reactor;
+        if ((tp = mprCreateThread(sfmt("reactor.%d", i), serviceReactor, reactor, 0)) == 0) {
+            return MPR_ERR_CANT_CREATE;
+        }
+        reactor->thread = tp;
+        mprAddItem(MPR->reactors, reactor);
+        if (mprStartThread(tp) < 0) {
+            return MPR_ERR_CANT_INITIALIZE;
+        }
+    }
+    mprLog(MPR_CONFIG, "Started %d reactors", count);
+    return 0;
+#else
+    if (count != 0) {
+        mprError("Reactors require epoll");
+        return MPR_ERR_BAD_STATE;
+    }
+    return 0;
+#endif
+}
+
+
+void mprStopReactors()
+{
+    MprReactor      *reactor;
+    int             next;
+
+    for (ITERATE_ITEMS(MPR->reactors, reactor, next)) {
+        mprWakeWaitService(reactor->waitService);
+    }
+}
+
+
+static void manageReactor(MprReactor *reactor, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(reactor->eventService);
+        mprMark(reactor->waitService);
+        mprMark(reactor->thread);
+    }
+}
+
+
+int mprGetReactorCount()
+{
+    return MPR->reactors ? mprGetListLength(MPR->reactors) : 0;
+}
+
+
+/*
+    Pin a new dispatcher to the reactor with the fewest registered wait handlers
+ */
+MprDispatcher *mprCreateReactorDispatcher(cchar *name)
+{
+    MprReactor      *reactor, *rp;
+    MprDispatcher   *dispatcher;
+    int             next, load, best;
+
+    reactor = 0;
+    best = MAXINT;
+    for (ITERATE_ITEMS(MPR->reactors, rp, next)) {
+        if ((load = mprGetListLength(rp->waitService->handlers)) < best) {
+            best = load;
+            reactor = rp;
+        }
+    }
+    if (reactor == 0) {
+        return mprCreateDispatcher(name, 1);
+    }
+    if ((dispatcher = createDispatcher(reactor->eventService, name, 1)) != 0) {
+        mprAtomicAdd(&reactor->pinned, 1);
+    }
+    return dispatcher;
+}
+
+
+MprDispatcher *mprCreateSiblingDispatcher(MprDispatcher *dispatcher, cchar *name)
+{
+    MprReactor      *rp;
+    MprDispatcher   *sibling;
+    int             next;
+
+    for (ITERATE_ITEMS(MPR->reactors, rp, next)) {
+        if (dispatcher && dispatcher->service == rp->eventService) {
+            if ((sibling = createDispatcher(rp->eventService, name, 1)) != 0) {
+                mprAtomicAdd(&rp->pinned, 1);
+            }
+            return sibling;
+        }
+    }
+    return mprCreateDispatcher(name, 1);
+}
+
+
+int mprGetReactorStats(int index, MprReactorStats *stats)
+{
+    MprReactor      *reactor;
+    MprWaitStats    ws;
+
+    if ((reactor = mprGetItem(MPR->reactors, index)) == 0) {
+        return MPR_ERR_CANT_FIND;
+    }
+    mprGetWaitServiceStats(reactor->waitService, &ws);
+    stats->index = reactor->index;
+    stats->handlers = ws.handlers;
+    stats->pinned = reactor->pinned;
+    stats->ioEvents = ws.ioEvents;
+    stats->dispatches = reactor->dispatches;
+    stats->wakeups = reactor->wakeups;
+    return 0;
 }
 
 
-bool mprDispatcherHasEvents(MprDispatcher *dispatcher)
+/*
+    Reactor thread. Run ready dispatchers inline and then wait for I/O on the reactor's wait service.
+ */
+static void serviceReactor(MprReactor *reactor, MprThread *tp)
 {
-    if (dispatcher == 0) {
-        return 0;
+    MprEventService     *es;
+    MprDispatcher       *dp;
+    MprTime             delay;
+
+    es = reactor->eventService;
+    mprLog(MPR_CONFIG, "Reactor %d started", reactor->index);
+
+    while (!mprIsStoppingCore()) {
+        es->now = mprGetTime();
+        while ((dp = getNextReadyDispatcher(es)) != NULL) {
+            mprAssert(!dp->destroyed);
+            serviceDispatcherMain(dp);
+            reactor->dispatches++;
+        }
+        lock(es);
+        delay = getIdleTime(es, MPR_MAX_TIMEOUT);
+        if (delay > 0) {
+            es->waiting = 1;
+            es->willAwake = es->now + delay;
+            unlock(es);
+            mprWaitForIO(reactor->waitService, delay);
+            /*
+                Not waiting while running dispatchers. Avoids self-wakeups as other threads only need to wake
+                the reactor when it is blocked in mprWaitForIO.
+             */
+            es->waiting = 0;
+            reactor->wakeups++;
+        } else {
+            unlock(es);
+        }
     }
-    return !isEmpty(dispatcher);
 }
 
 
@@ -13499,6 +14815,26 @@ static int growEvents(MprWaitService *ws)
 }
 
 
+/*
+    Issue an epoll_ctl and account for it in the wait service stats
+ */
+static int epollCtl(MprWaitService *ws, int op, int fd, struct epoll_event *ev)
+{
+    if (op == EPOLL_CTL_ADD) {
+        ws->notifyAdds++;
+    } else if (op == EPOLL_CTL_MOD) {
+        ws->notifyMods++;
+    } else {
+        ws->notifyDels++;
+    }
+    return epoll_ctl(ws->epoll, op, fd, ev);
+}
+
+
+/*
+    Descriptors are registered once with EPOLLONESHOT. The kernel disables the descriptor after each event, so it is
+    re-armed with a single EPOLL_CTL_MOD rather than being deleted and re-added. A zero mask removes the descriptor.
+ */
 int mprNotifyOn(MprWaitService *ws, MprWaitHandler *wp, int mask)
 {
     struct epoll_event  ev;
@@ -13508,47 +14844,51 @@ int mprNotifyOn(MprWaitService *ws, MprWaitHandler *wp, int mask)
     fd = wp->fd;
 
     lock(ws);
-    if (wp->desiredMask != mask) {
-        memset(&ev, 0, sizeof(ev));
-        ev.data.fd = fd;
-        if (wp->desiredMask & MPR_READABLE) {
-            ev.events |= (EPOLLIN | EPOLLHUP);
-        }
-        if (wp->desiredMask & MPR_WRITABLE) {
-            ev.events |= EPOLLOUT;
+    memset(&ev, 0, sizeof(ev));
+    ev.data.fd = fd;
+    if (mask == 0) {
+        if (wp->flags & MPR_WAIT_REGISTERED) {
+            epollCtl(ws, EPOLL_CTL_DEL, fd, &ev);
+            wp->flags &= ~MPR_WAIT_REGISTERED;
         }
-        if (ev.events) {
-            rc = epoll_ctl(ws->epoll, EPOLL_CTL_DEL, fd, &ev);
-#if UNUSED && KEEP
-            if (rc != 0) {
-                mprError("Epoll del error %d on fd %d\n", errno, fd);
+    } else if (wp->desiredMask != mask) {
+        if (fd >= ws->handlerMax) {
+            ws->handlerMax = fd + 32;
+            if ((ws->handlerMap = mprRealloc(ws->handlerMap, sizeof(MprWaitHandler*) * ws->handlerMax)) == 0) {
+                unlock(ws);
+                mprAssert(!MPR_ERR_MEMORY);
+                return MPR_ERR_MEMORY;
             }
-#endif
         }
-        ev.events = 0;
+        ev.events = EPOLLONESHOT;
         if (mask & MPR_READABLE) {
             ev.events |= (EPOLLIN | EPOLLHUP);
         }
         if (mask & MPR_WRITABLE) {
             ev.events |= EPOLLOUT;
         }
-        if (ev.events) {
-            rc = epoll_ctl(ws->epoll, EPOLL_CTL_ADD, fd, &ev);
-            if (rc != 0) {
-                mprError("Epoll add error %d on fd %d\n", errno, fd);
+        if (wp->flags & MPR_WAIT_REGISTERED) {
+            if ((rc = epollCtl(ws, EPOLL_CTL_MOD, fd, &ev)) != 0 && errno == ENOENT) {
+                /* Descriptor was closed and reopened underneath the handler */
+                rc = epollCtl(ws, EPOLL_CTL_ADD, fd, &ev);
             }
-        }
-        if (mask && fd >= ws->handlerMax) {
-            ws->handlerMax = fd + 32;
-            if ((ws->handlerMap = mprRealloc(ws->handlerMap, sizeof(MprWaitHandler*) * ws->handlerMax)) == 0) {
-                mprAssert(!MPR_ERR_MEMORY);
-                return MPR_ERR_MEMORY;
+        } else {
+            if ((rc = epollCtl(ws, EPOLL_CTL_ADD, fd, &ev)) != 0 && errno == EEXIST) {
+                /* Descriptor still registered from a prior handler on the same descriptor */
+                rc = epollCtl(ws, EPOLL_CTL_MOD, fd, &ev);
             }
         }
+        if (rc != 0) {
+            mprError("Epoll add error %d on fd %d\n", errno, fd);
+        } else {
+            wp->flags |= MPR_WAIT_REGISTERED;
+        }
+    }
+    if (mask || fd < ws->handlerMax) {
         mprAssert(ws->handlerMap[fd] == 0 || ws->handlerMap[fd] == wp);
-        wp->desiredMask = mask;
+        ws->handlerMap[fd] = (mask) ? wp : 0;
     }
-    ws->handlerMap[fd] = (mask) ? wp : 0;
+    wp->desiredMask = mask;
     unlock(ws);
     return 0;
 }
@@ -13659,21 +14999,20 @@ static void serviceIO(MprWaitService *ws, int count)
         if (ev->events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
             mask |= MPR_READABLE;
         }
-        if (ev->events & EPOLLOUT) {
+        if (ev->events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
             mask |= MPR_WRITABLE;
         }
         if (mask == 0) {
             mprAssert(mask);
             continue;
         }
+        /*
+            The descriptor has been disabled by EPOLLONESHOT. It remains registered until re-armed via mprNotifyOn.
+         */
         wp->presentMask = mask & wp->desiredMask;
+        wp->desiredMask = 0;
+        ws->handlerMap[wp->fd] = 0;
         if (wp->presentMask) {
-            struct epoll_event  ev;
-            memset(&ev, 0, sizeof(ev));
-            ev.data.fd = fd;
-            wp->desiredMask = 0;
-            ws->handlerMap[wp->fd] = 0;
-            epoll_ctl(ws->epoll, EPOLL_CTL_DEL, wp->fd, &ev);
             mprQueueIOEvent(wp);
         }
     }
@@ -13687,10 +15026,17 @@ static void serviceIO(MprWaitService *ws, int count)
  */
 void mprWakeNotifier()
 {
-    MprWaitService  *ws;
-    int             c;
+    mprWakeWaitService(MPR->waitService);
+}
+
+
+/*
+    Wake a specific wait service. Reactors each have their own wait service and breakout pipe.
+ */
+void mprWakeWaitService(MprWaitService *ws)
+{
+    int     c;
 
-    ws = MPR->waitService;
     if (!ws->wakeRequested) {
         ws->wakeRequested = 1;
         c = 0;
@@ -13740,6 +15086,10 @@ void stubMmprEpoll() {}
 
 
 
+/*********************************** Locals ***********************************/
+
+static int eventSlab = -1;              /* Slab pool for events */
+
 /***************************** Forward Declarations ***************************/
 
 static void dequeueEvent(MprEvent *event);
@@ -13758,7 +15108,10 @@ MprEvent *mprCreateEventQueue()
 {
     MprEvent    *queue;
 
-    if ((queue = mprAllocObj(MprEvent, manageEvent)) == 0) {
+    if (eventSlab < 0) {
+        eventSlab = mprCreateSlab("MprEvent", sizeof(MprEvent), MPR_ALLOC_MANAGER);
+    }
+    if ((queue = mprAllocSlabObj(eventSlab, MprEvent, manageEvent)) == 0) {
         return 0;
     }
     initEventQ(queue);
@@ -13774,7 +15127,10 @@ MprEvent *mprCreateEvent(MprDispatcher *dispatcher, cchar *name, MprTime period,
 {
     MprEvent    *event;
 
-    if ((event = mprAllocObj(MprEvent, manageEvent)) == 0) {
+    if (eventSlab < 0) {
+        eventSlab = mprCreateSlab("MprEvent", sizeof(MprEvent), MPR_ALLOC_MANAGER);
+    }
+    if ((event = mprAllocSlabObj(eventSlab, MprEvent, manageEvent)) == 0) {
         return 0;
     }
     if (dispatcher == 0) {
@@ -14868,6 +16224,10 @@ void mprSetPathNewline(cchar *path, cchar *newline)
 
 
 
+/*********************************** Locals ***********************************/
+
+static int keySlab = -1;                /* Slab pool for hash keys */
+
 /**************************** Forward Declarations ****************************/
 
 static void *dupKey(MprHash *hash, MprKey *sp, cvoid *key);
@@ -14885,6 +16245,9 @@ MprHash *mprCreateHash(int hashSize, int flags)
     if ((hash = mprAllocObj(MprHash, manageHashTable)) == 0) {
         return 0;
     }
+    if (keySlab < 0) {
+        keySlab = mprCreateSlab("MprKey", sizeof(MprKey), 0);
+    }
     if (hashSize < MPR_DEFAULT_HASH_SIZE) {
         hashSize = MPR_DEFAULT_HASH_SIZE;
     }
@@ -14977,7 +16340,7 @@ MprKey *mprAddKey(MprHash *hash, cvoid *key, cvoid *ptr)
     /*
         Hash entries are managed by manageHashTable
      */
-    if ((sp = mprAllocStruct(MprKey)) == 0) {
+    if ((sp = mprAllocSlabStruct(keySlab, MprKey)) == 0) {
         unlock(hash);
         return 0;
     }
@@ -15021,7 +16384,7 @@ MprKey *mprAddDuplicateKey(MprHash *hash, cvoid *key, cvoid *ptr)
     mprAssert(hash);
     mprAssert(key);
 
-    if ((sp = mprAllocStruct(MprKey)) == 0) {
+    if ((sp = mprAllocSlabStruct(keySlab, MprKey)) == 0) {
         return 0;
     }
     sp->data = ptr;
@@ -23117,6 +24480,7 @@ static MprSocketProvider *createStandardProvider(MprSocketService *ss);
 static void disconnectSocket(MprSocket *sp);
 static ssize flushSocket(MprSocket *sp);
 static int getSocketIpAddr(struct sockaddr *addr, int addrlen, char *ip, int size, int *port);
+static void getSocketIpKey(struct sockaddr *addr, MprIpKey *key);
 static int ipv6(cchar *ip);
 static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags);
 static void manageSocket(MprSocket *sp, int flags);
@@ -23173,12 +24537,20 @@ MprSocketService *mprCreateSocketService()
 
 static void manageSocketService(MprSocketService *ss, int flags)
 {
+    char    *buf;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(ss->standardProvider);
         mprMark(ss->providers);
         mprMark(ss->defaultProvider);
         mprMark(ss->mutex);
         mprMark(ss->secureSockets);
+
+    } else if (flags & MPR_MANAGE_FREE) {
+        while ((buf = ss->recordBuffers) != 0) {
+            ss->recordBuffers = *(char**) buf;
+            mprVirtFree(buf, MPR_SSL_RECORD_SIZE);
+        }
     }
 }
 
@@ -23322,7 +24694,7 @@ static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
     sp->port = port;
     sp->flags = (initialFlags &
         (MPR_SOCKET_BROADCAST | MPR_SOCKET_DATAGRAM | MPR_SOCKET_BLOCK |
-         MPR_SOCKET_LISTENER | MPR_SOCKET_NOREUSE | MPR_SOCKET_NODELAY | MPR_SOCKET_THREAD));
+         MPR_SOCKET_LISTENER | MPR_SOCKET_NOREUSE | MPR_SOCKET_NODELAY | MPR_SOCKET_REUSEPORT | MPR_SOCKET_THREAD));
 
     datagram = sp->flags & MPR_SOCKET_DATAGRAM;
     if (mprGetSocketInfo(ip, port, &family, &protocol, &addr, &addrlen) < 0) {
@@ -23347,6 +24719,12 @@ static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
         rc = 1;
         setsockopt(sp->fd, SOL_SOCKET, SO_REUSEADDR, (char*) &rc, sizeof(rc));
     }
+#if defined(SO_REUSEPORT)
+    if (sp->flags & MPR_SOCKET_REUSEPORT) {
+        rc = 1;
+        setsockopt(sp->fd, SOL_SOCKET, SO_REUSEPORT, (char*) &rc, sizeof(rc));
+    }
+#endif
 #endif
     if (sp->service->prebind) {
         if ((sp->service->prebind)(sp) < 0) {
@@ -23371,7 +24749,7 @@ static int listenSocket(MprSocket *sp, cchar *ip, int port, int initialFlags)
     /* NOTE: Datagrams have not been used in a long while. Maybe broken */
     if (!datagram) {
         sp->flags |= MPR_SOCKET_LISTENER;
-        if (listen(sp->fd, SOMAXCONN) < 0) {
+        if (listen(sp->fd, sp->backlog > 0 ? sp->backlog : SOMAXCONN) < 0) {
             mprLog(3, "Listen error %d", mprGetOsError());
             closesocket(sp->fd);
             sp->fd = -1;
@@ -23670,7 +25048,15 @@ MprSocket *mprAcceptSocket(MprSocket *listen)
     if (listen->flags & MPR_SOCKET_BLOCK) {
         mprYield(MPR_YIELD_STICKY);
     }
+#if LINUX && defined(SOCK_CLOEXEC)
+    /*
+        Set close-on-exec and non-blocking mode atomically with the accept
+     */
+    fd = (int) accept4(listen->fd, addr, &addrlen, 
+        SOCK_CLOEXEC | ((listen->flags & MPR_SOCKET_BLOCK) ? 0 : SOCK_NONBLOCK));
+#else
     fd = (int) accept(listen->fd, addr, &addrlen);
+#endif
     if (listen->flags & MPR_SOCKET_BLOCK) {
         mprResetYield();
     }
@@ -23697,18 +25083,19 @@ MprSocket *mprAcceptSocket(MprSocket *listen)
     }
     mprUnlock(ss->mutex);
 
-#if !BIT_WIN_LIKE && !VXWORKS
-    /* Prevent children inheriting this socket */
-    fcntl(fd, F_SETFD, FD_CLOEXEC);         
-#endif
-
     nsp->fd = fd;
     nsp->port = listen->port;
     nsp->flags = listen->flags;
     nsp->flags &= ~MPR_SOCKET_LISTENER;
     nsp->listenSock = listen;
 
+#if !(LINUX && defined(SOCK_CLOEXEC))
+#if !BIT_WIN_LIKE && !VXWORKS
+    /* Prevent children inheriting this socket */
+    fcntl(fd, F_SETFD, FD_CLOEXEC);         
+#endif
     mprSetSocketBlockingMode(nsp, (nsp->flags & MPR_SOCKET_BLOCK) ? 1: 0);
+#endif
     if (nsp->flags & MPR_SOCKET_NODELAY) {
         mprSetSocketNoDelay(nsp, 1);
     }
@@ -23721,6 +25108,7 @@ MprSocket *mprAcceptSocket(MprSocket *listen)
         return 0;
     }
     nsp->ip = sclone(ip);
+    getSocketIpKey(addr, &nsp->ipKey);
     nsp->port = port;
 
     /*
@@ -23980,6 +25368,133 @@ static ssize localSendfile(MprSocket *sp, MprFile *file, MprOff offset, ssize le
 #endif
 
 
+/*
+    Get a TLS record buffer. Buffers are allocated outside the garbage collected heap so they are page aligned.
+ */
+static char *getRecordBuffer(MprSocketService *ss)
+{
+    char    *buf;
+
+    lock(ss);
+    if ((buf = ss->recordBuffers) != 0) {
+        ss->recordBuffers = *(char**) buf;
+        ss->recordBufferCount--;
+    }
+    unlock(ss);
+    if (buf == 0) {
+        buf = mprVirtAlloc(MPR_SSL_RECORD_SIZE, MPR_MAP_READ | MPR_MAP_WRITE);
+    }
+    return buf;
+}
+
+
+/*
+    Return a record buffer to the free list. Buffers beyond MPR_SSL_RECORD_BUFFERS are released.
+ */
+static void putRecordBuffer(MprSocketService *ss, char *buf)
+{
+    lock(ss);
+    if (ss->recordBufferCount < MPR_SSL_RECORD_BUFFERS) {
+        *(char**) buf = ss->recordBuffers;
+        ss->recordBuffers = buf;
+        ss->recordBufferCount++;
+        buf = 0;
+    }
+    unlock(ss);
+    if (buf) {
+        mprVirtFree(buf, MPR_SSL_RECORD_SIZE);
+    }
+}
+
+
+/*
+    Copy data from an I/O vector into a record buffer. The index and pos are updated to the next data to copy.
+ */
+static ssize packVector(char *buf, ssize size, MprIOVec *iovec, int count, int *index, ssize *pos)
+{
+    ssize   len, nbytes;
+
+    for (len = 0; *index < count && len < size; ) {
+        nbytes = min((ssize) iovec[*index].len - *pos, size - len);
+        memcpy(&buf[len], &iovec[*index].start[*pos], nbytes);
+        len += nbytes;
+        *pos += nbytes;
+        if (*pos >= (ssize) iovec[*index].len) {
+            (*index)++;
+            *pos = 0;
+        }
+    }
+    return len;
+}
+
+
+/*
+    Send a file to a secure socket. The data must be encrypted in user memory, so sendfile can't be used. Instead, the
+    headers, file data and trailers are packed into buffers of one TLS record and each is written by the SSL provider. 
+    This avoids sending short records for the headers and chunk boundaries.
+ */
+static MprOff sendFileToSecureSocket(MprSocket *sock, MprFile *file, MprOff offset, MprOff bytes, MprIOVec *beforeVec, 
+    int beforeCount, MprIOVec *afterVec, int afterCount)
+{
+    MprSocketService    *ss;
+    MprOff              written, toWriteFile;
+    ssize               i, len, nbytes, rc, beforePos, afterPos, toWriteBefore, toWriteAfter;
+    char                *buf;
+    int                 beforeIndex, afterIndex;
+
+    for (i = toWriteBefore = 0; i < beforeCount; i++) {
+        toWriteBefore += beforeVec[i].len;
+    }
+    for (i = toWriteAfter = 0; i < afterCount; i++) {
+        toWriteAfter += afterVec[i].len;
+    }
+    toWriteFile = (bytes - toWriteBefore - toWriteAfter);
+    mprAssert(toWriteFile >= 0);
+
+    if (toWriteFile > 0 && (file == 0 || mprSeekFile(file, SEEK_SET, offset) != offset)) {
+        return MPR_ERR_CANT_READ;
+    }
+    ss = sock->service;
+    if ((buf = getRecordBuffer(ss)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    beforeIndex = afterIndex = 0;
+    beforePos = afterPos = 0;
+    written = 0;
+    rc = 0;
+
+    while (written < bytes) {
+        len = packVector(buf, MPR_SSL_RECORD_SIZE, beforeVec, beforeCount, &beforeIndex, &beforePos);
+        if (beforeIndex >= beforeCount && toWriteFile > 0 && len < MPR_SSL_RECORD_SIZE) {
+            nbytes = (ssize) min(toWriteFile, MPR_SSL_RECORD_SIZE - len);
+            if ((nbytes = mprReadFile(file, &buf[len], nbytes)) <= 0) {
+                rc = MPR_ERR_CANT_READ;
+                break;
+            }
+            toWriteFile -= nbytes;
+            len += nbytes;
+        }
+        if (beforeIndex >= beforeCount && toWriteFile == 0) {
+            len += packVector(&buf[len], MPR_SSL_RECORD_SIZE - len, afterVec, afterCount, &afterIndex, &afterPos);
+        }
+        if (len == 0) {
+            break;
+        }
+        if ((rc = mprWriteSocket(sock, buf, len)) > 0) {
+            written += rc;
+        }
+        if (rc != len) {
+            break;
+        }
+    }
+    putRecordBuffer(ss, buf);
+    if (rc < 0 && written == 0) {
+        return rc;
+    }
+    return written;
+}
+
+
 /*  
     Write data from a file to a socket. Includes the ability to write header before and after the file data.
     Works even with a null "file" to just output the headers.
@@ -23994,6 +25509,9 @@ MprOff mprSendFileToSocket(MprSocket *sock, MprFile *file, MprOff offset, MprOff
     ssize           i, rc, toWriteBefore, toWriteAfter, nbytes;
     int             done;
 
+    if (sock->sslSocket) {
+        return sendFileToSecureSocket(sock, file, offset, bytes, beforeVec, beforeCount, afterVec, afterCount);
+    }
     rc = 0;
 
 #if MACOSX && __MAC_OS_X_VERSION_MIN_REQUIRED >= 1050
@@ -24200,6 +25718,55 @@ int mprSetSocketBlockingMode(MprSocket *sp, bool on)
 }
 
 
+/*  
+    Hold partial frames until uncorked (TCP_CORK or TCP_NOPUSH)
+ */
+int mprSetSocketCork(MprSocket *sp, bool on)
+{
+#if defined(TCP_CORK) || defined(TCP_NOPUSH)
+    int     cork, rc;
+
+    lock(sp);
+    if (on == ((sp->flags & MPR_SOCKET_CORKED) != 0)) {
+        unlock(sp);
+        return 0;
+    }
+    cork = on ? 1 : 0;
+#if defined(TCP_CORK)
+    rc = setsockopt(sp->fd, IPPROTO_TCP, TCP_CORK, (char*) &cork, sizeof(int));
+#else
+    rc = setsockopt(sp->fd, IPPROTO_TCP, TCP_NOPUSH, (char*) &cork, sizeof(int));
+#endif
+    if (rc == 0) {
+        if (on) {
+            sp->flags |= MPR_SOCKET_CORKED;
+        } else {
+            sp->flags &= ~MPR_SOCKET_CORKED;
+        }
+    }
+    unlock(sp);
+    return (rc < 0) ? MPR_ERR_CANT_WRITE : 0;
+#else
+    return MPR_ERR_BAD_STATE;
+#endif
+}
+
+
+int mprSetSocketDeferAccept(MprSocket *sp, int timeout)
+{
+#if defined(TCP_DEFER_ACCEPT)
+    int     rc;
+
+    lock(sp);
+    rc = setsockopt(sp->fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, (char*) &timeout, sizeof(int));
+    unlock(sp);
+    return (rc < 0) ? MPR_ERR_CANT_WRITE : 0;
+#else
+    return MPR_ERR_BAD_STATE;
+#endif
+}
+
+
 /*  
     Set the TCP delay behavior (nagle algorithm)
  */
@@ -24456,6 +26023,29 @@ static int getSocketIpAddr(struct sockaddr *addr, int addrlen, char *ip, int ipL
 }
 
 
+/*
+    Get the binary client address as an exact key. IPv4 addresses (including IPv4 mapped IPv6 addresses which have 
+    already been converted by getSocketIpAddr) are stored in IPv4 mapped form so they never equal a native IPv6 key.
+ */
+static void getSocketIpKey(struct sockaddr *addr, MprIpKey *key)
+{
+    uchar   bytes[16];
+
+    memset(bytes, 0, sizeof(bytes));
+    if (addr->sa_family == AF_INET) {
+        bytes[10] = bytes[11] = 0xFF;
+        memcpy(&bytes[12], &((struct sockaddr_in*) addr)->sin_addr.s_addr, 4);
+    }
+#if defined(AF_INET6)
+    else if (addr->sa_family == AF_INET6) {
+        memcpy(bytes, ((struct sockaddr_in6*) addr)->sin6_addr.s6_addr, sizeof(bytes));
+    }
+#endif
+    memcpy(&key->hi, bytes, sizeof(key->hi));
+    memcpy(&key->lo, &bytes[8], sizeof(key->lo));
+}
+
+
 /*
     Looks like an IPv6 address if it has 2 or more colons
  */
@@ -30065,15 +31655,31 @@ MprWaitService *mprCreateWaitService()
 {
     MprWaitService  *ws;
 
+    if ((ws = mprCreatePrivateWaitService()) == 0) {
+        return 0;
+    }
+    MPR->waitService = ws;
+    return ws;
+}
+
+
+/*
+    Create a wait service with its own notifier. Used by reactors.
+ */
+MprWaitService *mprCreatePrivateWaitService()
+{
+    MprWaitService  *ws;
+
     ws = mprAllocObj(MprWaitService, manageWaitService);
     if (ws == 0) {
         return 0;
     }
-    MPR->waitService = ws;
     ws->handlers = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
     ws->mutex = mprCreateLock();
     ws->spin = mprCreateSpinLock();
-    mprCreateNotifierService(ws);
+    if (mprCreateNotifierService(ws) < 0) {
+        return 0;
+    }
     return ws;
 }
 
@@ -30113,7 +31719,14 @@ static MprWaitHandler *initWaitHandler(MprWaitHandler *wp, int fd, int mask, Mpr
 
     mprAssert(fd >= 0);
 
-    ws = MPR->waitService;
+    /*
+        Handlers for dispatchers pinned to a reactor are registered with the reactor's wait service
+     */
+    if (dispatcher && dispatcher->service->waitService) {
+        ws = dispatcher->service->waitService;
+    } else {
+        ws = MPR->waitService;
+    }
     if (mprGetListLength(ws->handlers) == FD_SETSIZE) {
         mprError("io: Too many io handlers: %d\n", FD_SETSIZE);
         return 0;
@@ -30140,7 +31753,7 @@ static MprWaitHandler *initWaitHandler(MprWaitHandler *wp, int fd, int mask, Mpr
         }
         mprNotifyOn(ws, wp, mask);
         unlock(ws);
-        mprWakeNotifier();
+        mprWakeWaitService(ws);
     }
     return wp;
 }
@@ -30188,7 +31801,7 @@ void mprRemoveWaitHandler(MprWaitHandler *wp)
     ws = wp->service;
     lock(ws);
     if (wp->fd >= 0) {
-        if (wp->desiredMask) {
+        if (wp->desiredMask || (wp->flags & MPR_WAIT_REGISTERED)) {
             mprNotifyOn(ws, wp, 0);
         }
         mprRemoveItem(ws->handlers, wp);
@@ -30198,7 +31811,7 @@ void mprRemoveWaitHandler(MprWaitHandler *wp)
             wp->event = 0;
         }
     }
-    mprWakeNotifier();
+    mprWakeWaitService(ws);
     unlock(ws);
 }
 
@@ -30218,6 +31831,7 @@ void mprQueueIOEvent(MprWaitHandler *wp)
     event->fd = wp->fd;
     event->mask = wp->presentMask;
     event->handler = wp;
+    wp->service->ioEvents++;
     mprQueueEvent(dispatcher, event);
     unlock(wp->service);
 }
@@ -30237,12 +31851,37 @@ void mprWaitOn(MprWaitHandler *wp, int mask)
             wp->service->needRecall = 1;
         }
         mprNotifyOn(wp->service, wp, mask);
-        mprWakeNotifier();
+        mprWakeWaitService(wp->service);
     }
     unlock(wp->service);
 }
 
 
+void mprGetWaitServiceStats(MprWaitService *ws, MprWaitStats *stats)
+{
+    mprAssert(ws);
+
+    lock(ws);
+    stats->ioEvents = ws->ioEvents;
+    stats->notifyAdds = ws->notifyAdds;
+    stats->notifyMods = ws->notifyMods;
+    stats->notifyDels = ws->notifyDels;
+    stats->handlers = mprGetListLength(ws->handlers);
+    unlock(ws);
+}
+
+
+#if !MPR_EVENT_EPOLL
+/*
+    Reactors require epoll, so there is only one wait service to wake
+ */
+void mprWakeWaitService(MprWaitService *ws)
+{
+    mprWakeNotifier();
+}
+#endif
+
+
 /*
     Set a handler to be recalled without further I/O
  */
@@ -30270,11 +31909,11 @@ void mprRecallWaitHandler(MprWaitHandler *wp)
 {
     MprWaitService  *ws;
 
-    ws = MPR->waitService;
+    ws = wp->service;
     lock(ws);
     wp->flags |= MPR_WAIT_RECALL_HANDLER;
     ws->needRecall = 1;
-    mprWakeNotifier();
+    mprWakeWaitService(ws);
     unlock(ws);
 }
 
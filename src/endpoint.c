@@ -11,6 +11,10 @@
 
 static int manageEndpoint(HttpEndpoint *endpoint, int flags);
 static int destroyEndpointConnections(HttpEndpoint *endpoint);
+static void closeListeners(HttpEndpoint *endpoint);
+static MprSocket *getListener(HttpEndpoint *endpoint, MprEvent *event);
+static int addClient(HttpEndpoint *endpoint, MprIpKey *key);
+static int removeClient(HttpEndpoint *endpoint, MprIpKey *key);
 
 /************************************ Code ************************************/
 /*
@@ -19,15 +23,25 @@ static int destroyEndpointConnections(HttpEndpoint *endpoint);
 HttpEndpoint *httpCreateEndpoint(cchar *ip, int port, MprDispatcher *dispatcher)
 {
     HttpEndpoint    *endpoint;
+    HttpClientShard *shard;
     Http            *http;
+    int             i, size;
 
     if ((endpoint = mprAllocObj(HttpEndpoint, manageEndpoint)) == 0) {
         return 0;
     }
     http = MPR->httpService;
     endpoint->http = http;
-    endpoint->clientLoad = mprCreateHash(HTTP_CLIENTS_HASH, MPR_HASH_STATIC_VALUES);
+    mprGetRandomBytes((char*) &endpoint->clientSeed, sizeof(endpoint->clientSeed), 0);
+    for (size = 8; size * HTTP_CLIENT_SHARDS < HTTP_CLIENTS_HASH; size *= 2) ;
+    for (i = 0; i < HTTP_CLIENT_SHARDS; i++) {
+        shard = &endpoint->clientShards[i];
+        shard->mutex = mprCreateLock();
+        shard->clients = mprAllocZeroed(size * sizeof(HttpClientLoad));
+        shard->size = size;
+    }
     endpoint->async = 1;
+    endpoint->shards = 1;
     endpoint->http = MPR->httpService;
     endpoint->port = port;
     endpoint->ip = sclone(ip);
@@ -41,24 +55,27 @@ HttpEndpoint *httpCreateEndpoint(cchar *ip, int port, MprDispatcher *dispatcher)
 void httpDestroyEndpoint(HttpEndpoint *endpoint)
 {
     destroyEndpointConnections(endpoint);
-    if (endpoint->sock) {
-        mprCloseSocket(endpoint->sock, 0);
-        endpoint->sock = 0;
-    }
+    closeListeners(endpoint);
     httpRemoveEndpoint(MPR->httpService, endpoint);
 }
 
 
 static int manageEndpoint(HttpEndpoint *endpoint, int flags)
 {
+    int     i;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(endpoint->http);
         mprMark(endpoint->hosts);
         mprMark(endpoint->limits);
-        mprMark(endpoint->clientLoad);
+        for (i = 0; i < HTTP_CLIENT_SHARDS; i++) {
+            mprMark(endpoint->clientShards[i].mutex);
+            mprMark(endpoint->clientShards[i].clients);
+        }
         mprMark(endpoint->ip);
         mprMark(endpoint->context);
         mprMark(endpoint->sock);
+        mprMark(endpoint->listeners);
         mprMark(endpoint->dispatcher);
         mprMark(endpoint->ssl);
 
@@ -119,18 +136,16 @@ HttpEndpoint *httpCreateConfiguredEndpoint(cchar *home, cchar *documents, cchar
 
 static int destroyEndpointConnections(HttpEndpoint *endpoint)
 {
-    HttpConn    *conn;
+    HttpConn    *conn, *next;
     Http        *http;
-    int         next;
 
     http = endpoint->http;
     lock(http);
 
-    for (next = 0; (conn = mprGetNextItem(http->connections, &next)) != 0; ) {
+    for (ITERATE_CONNS(http, conn, next)) {
         if (conn->endpoint == endpoint) {
             conn->endpoint = 0;
             httpDestroyConn(conn);
-            next--;
         }
     }
     unlock(http);
@@ -150,33 +165,100 @@ static bool validateEndpoint(HttpEndpoint *endpoint)
 }
 
 
-int httpStartEndpoint(HttpEndpoint *endpoint)
+/*
+    Open the listening sockets. With more than one shard, each listener sets SO_REUSEPORT and the O/S distributes
+    incoming connections across them.
+ */
+static int openListeners(HttpEndpoint *endpoint)
 {
-    HttpHost    *host;
-    cchar       *proto, *ip;
+    MprSocket   *sock;
+    int         i, shards, flags;
+
+    shards = max(endpoint->shards, 1);
+#if !defined(SO_REUSEPORT)
+    if (shards > 1) {
+        mprLog(2, "SO_REUSEPORT not supported, using one listener for %s:%d", endpoint->ip, endpoint->port);
+        shards = 1;
+    }
+#endif
+    flags = MPR_SOCKET_NODELAY | MPR_SOCKET_THREAD;
+    if (shards > 1) {
+        flags |= MPR_SOCKET_REUSEPORT;
+    }
+    endpoint->listeners = mprCreateList(shards, 0);
+    for (i = 0; i < shards; i++) {
+        if ((sock = mprCreateSocket(endpoint->ssl)) == 0) {
+            return MPR_ERR_MEMORY;
+        }
+        sock->backlog = endpoint->backlog;
+        if (mprListenOnSocket(sock, endpoint->ip, endpoint->port, flags) < 0) {
+            mprError("Can't open a socket on %s:%d", *endpoint->ip ? endpoint->ip : "*", endpoint->port);
+            return MPR_ERR_CANT_OPEN;
+        }
+        if (i == 0) {
+            endpoint->sock = sock;
+        }
+        if (endpoint->deferAccept > 0 && mprSetSocketDeferAccept(sock, endpoint->deferAccept) < 0) {
+            mprLog(2, "Can't set deferred accept for %s:%d", endpoint->ip, endpoint->port);
+        }
+        mprAddItem(endpoint->listeners, sock);
+    }
+    return 0;
+}
+
+
+static void closeListeners(HttpEndpoint *endpoint)
+{
+    MprSocket   *sock;
     int         next;
 
+    for (ITERATE_ITEMS(endpoint->listeners, sock, next)) {
+        if (sock != endpoint->sock) {
+            mprCloseSocket(sock, 0);
+        }
+    }
+    endpoint->listeners = 0;
+    if (endpoint->sock) {
+        mprCloseSocket(endpoint->sock, 0);
+        endpoint->sock = 0;
+    }
+}
+
+
+int httpStartEndpoint(HttpEndpoint *endpoint)
+{
+    HttpHost        *host;
+    MprSocket       *sock;
+    MprDispatcher   *dispatcher;
+    cchar           *proto, *ip;
+    int             next, rc, sharded;
+
     if (!validateEndpoint(endpoint)) {
         return MPR_ERR_BAD_ARGS;
     }
     for (ITERATE_ITEMS(endpoint->hosts, host, next)) {
         httpStartHost(host);
     }
-    if ((endpoint->sock = mprCreateSocket(endpoint->ssl)) == 0) {
-        return MPR_ERR_MEMORY;
-    }
-    if (mprListenOnSocket(endpoint->sock, endpoint->ip, endpoint->port, MPR_SOCKET_NODELAY | MPR_SOCKET_THREAD) < 0) {
-        mprError("Can't open a socket on %s:%d", *endpoint->ip ? endpoint->ip : "*", endpoint->port);
-        return MPR_ERR_CANT_OPEN;
+    if ((rc = openListeners(endpoint)) < 0) {
+        closeListeners(endpoint);
+        return rc;
     }
     if (endpoint->http->listenCallback && (endpoint->http->listenCallback)(endpoint) < 0) {
         return MPR_ERR_CANT_OPEN;
     }
-    if (endpoint->async && !endpoint->sock->handler) {
-        mprAddSocketHandler(endpoint->sock, MPR_SOCKET_READABLE, endpoint->dispatcher, httpAcceptConn, endpoint, 
-            (endpoint->dispatcher) ? 0 : MPR_WAIT_NEW_DISPATCHER);
-    } else {
-        mprSetSocketBlockingMode(endpoint->sock, 1);
+    sharded = mprGetListLength(endpoint->listeners) > 1;
+    for (ITERATE_ITEMS(endpoint->listeners, sock, next)) {
+        if (endpoint->async && !sock->handler) {
+            dispatcher = endpoint->dispatcher;
+            if (!dispatcher && sharded && mprGetReactorCount() > 0) {
+                /* Run each listener on its own reactor. Accepted connections stay on the listener's reactor. */
+                dispatcher = mprCreateReactorDispatcher("listen");
+            }
+            mprAddSocketHandler(sock, MPR_SOCKET_READABLE, dispatcher, httpAcceptConn, endpoint, 
+                (dispatcher) ? 0 : MPR_WAIT_NEW_DISPATCHER);
+        } else {
+            mprSetSocketBlockingMode(sock, 1);
+        }
     }
     proto = endpoint->ssl ? "HTTPS" : "HTTP ";
     ip = *endpoint->ip ? endpoint->ip : "*";
@@ -185,6 +267,9 @@ int httpStartEndpoint(HttpEndpoint *endpoint)
     } else {
         mprLog(2, "Started %s service on \"%s:%d\"", proto, ip, endpoint->port);
     }
+    if (sharded) {
+        mprLog(2, "Listening with %d sharded sockets", mprGetListLength(endpoint->listeners));
+    }
     return 0;
 }
 
@@ -197,22 +282,133 @@ void httpStopEndpoint(HttpEndpoint *endpoint)
     for (ITERATE_ITEMS(endpoint->hosts, host, next)) {
         httpStopHost(host);
     }
-    if (endpoint->sock) {
-        mprCloseSocket(endpoint->sock, 0);
-        endpoint->sock = 0;
+    closeListeners(endpoint);
+}
+
+
+/*
+    Client IP table. The address key is hashed once: the top bits select the shard and the next bits the slot.
+    The hash is seeded per endpoint so clients can't choose addresses that pile into one probe sequence. Entries
+    match on the full address.
+ */
+#define CLIENT_MATCH(a, b)          ((a)->hi == (b)->hi && (a)->lo == (b)->lo)
+#define CLIENT_SHARD(hash)          ((int) ((hash) >> 56) % HTTP_CLIENT_SHARDS)
+#define CLIENT_SLOT(hash, size)     ((int) ((hash) >> 24) & ((size) - 1))
+
+static uint64 clientHash(HttpEndpoint *endpoint, MprIpKey *key)
+{
+    uint64      hash;
+
+    hash = (key->hi ^ endpoint->clientSeed) * 0x9E3779B97F4A7C15ULL;
+    hash = ((hash ^ (hash >> 32)) + key->lo) * 0xC2B2AE3D27D4EB4FULL;
+    return hash ^ (hash >> 29);
+}
+
+
+/*
+    Increment the connection count for a client. Return 1 if this is a new client, 0 if the client already has
+    connections or a negative MPR error code.
+ */
+static int addClient(HttpEndpoint *endpoint, MprIpKey *key)
+{
+    HttpClientShard *shard;
+    HttpClientLoad  *clients, *cp;
+    uint64          hash;
+    int             i, slot, size;
+
+    hash = clientHash(endpoint, key);
+    shard = &endpoint->clientShards[CLIENT_SHARD(hash)];
+    lock(shard);
+    for (slot = CLIENT_SLOT(hash, shard->size); shard->clients[slot].count; slot = (slot + 1) & (shard->size - 1)) {
+        if (CLIENT_MATCH(&shard->clients[slot].key, key)) {
+            shard->clients[slot].count++;
+            unlock(shard);
+            return 0;
+        }
     }
+    if ((shard->length + 1) * 4 > shard->size * 3) {
+        /* Grow to keep the load factor under 3/4 */
+        size = shard->size * 2;
+        if ((clients = mprAllocZeroed(size * sizeof(HttpClientLoad))) == 0) {
+            unlock(shard);
+            return MPR_ERR_MEMORY;
+        }
+        for (i = 0; i < shard->size; i++) {
+            cp = &shard->clients[i];
+            if (cp->count) {
+                for (slot = CLIENT_SLOT(clientHash(endpoint, &cp->key), size); clients[slot].count; slot = (slot + 1) & (size - 1)) ;
+                clients[slot] = *cp;
+            }
+        }
+        shard->clients = clients;
+        shard->size = size;
+        for (slot = CLIENT_SLOT(hash, size); clients[slot].count; slot = (slot + 1) & (size - 1)) ;
+    }
+    shard->clients[slot].key = *key;
+    shard->clients[slot].count = 1;
+    shard->length++;
+    unlock(shard);
+    return 1;
+}
+
+
+/*
+    Decrement the connection count for a client. Return 1 if the client has no more connections and was removed.
+ */
+static int removeClient(HttpEndpoint *endpoint, MprIpKey *key)
+{
+    HttpClientShard *shard;
+    HttpClientLoad  *clients;
+    uint64          hash;
+    int             slot, next, home, mask;
+
+    hash = clientHash(endpoint, key);
+    shard = &endpoint->clientShards[CLIENT_SHARD(hash)];
+    lock(shard);
+    clients = shard->clients;
+    mask = shard->size - 1;
+    for (slot = CLIENT_SLOT(hash, shard->size); clients[slot].count; slot = (slot + 1) & mask) {
+        if (CLIENT_MATCH(&clients[slot].key, key)) {
+            break;
+        }
+    }
+    if (clients[slot].count == 0) {
+        unlock(shard);
+        return 0;
+    }
+    if (--clients[slot].count > 0) {
+        unlock(shard);
+        return 0;
+    }
+    /*
+        Backward shift deletion. Move later entries of the probe sequence into the hole unless their home slot lies
+        cyclically between the hole and their current slot.
+     */
+    for (next = (slot + 1) & mask; clients[next].count; next = (next + 1) & mask) {
+        home = CLIENT_SLOT(clientHash(endpoint, &clients[next].key), shard->size);
+        if ((next > slot && (home <= slot || home > next)) || (next < slot && (home <= slot && home > next))) {
+            clients[slot] = clients[next];
+            clients[next].count = 0;
+            slot = next;
+        }
+    }
+    shard->length--;
+    unlock(shard);
+    return 1;
 }
 
 
 /*
-    OPT
+    Validate and account for resource limits. Counters are updated atomically and the client table is lock striped
+    so connections on different threads do not serialize on the Http lock. A counter is speculatively incremented 
+    and backed out if the limit is exceeded.
  */
 bool httpValidateLimits(HttpEndpoint *endpoint, int event, HttpConn *conn)
 {
     HttpLimits      *limits;
     Http            *http;
     cchar           *action;
-    int             count, level, dir;
+    int             level, dir;
 
     limits = conn->limits;
     dir = HTTP_TRACE_RX;
@@ -220,48 +416,50 @@ bool httpValidateLimits(HttpEndpoint *endpoint, int event, HttpConn *conn)
     mprAssert(conn->endpoint == endpoint);
     http = endpoint->http;
 
-    lock(http);
-
     switch (event) {
     case HTTP_VALIDATE_OPEN_CONN:
         /*
             This measures active client systems with unique IP addresses.
          */
         if (endpoint->clientCount >= limits->clientMax) {
-            unlock(http);
             /*  Abort connection */
             httpError(conn, HTTP_ABORT | HTTP_CODE_SERVICE_UNAVAILABLE, 
                 "Too many concurrent clients %d/%d", endpoint->clientCount, limits->clientMax);
             return 0;
         }
-        count = (int) PTOL(mprLookupKey(endpoint->clientLoad, conn->ip));
-        mprAddKey(endpoint->clientLoad, conn->ip, ITOP(count + 1));
-        endpoint->clientCount = (int) mprGetHashLength(endpoint->clientLoad);
+        if (addClient(endpoint, &conn->ipKey) > 0) {
+            mprAtomicAdd(&endpoint->clientCount, 1);
+            if (endpoint->clientCount > limits->clientMax) {
+                /* Another connection from this client may have been added meanwhile and now holds the entry */
+                if (removeClient(endpoint, &conn->ipKey)) {
+                    mprAtomicAdd(&endpoint->clientCount, -1);
+                }
+                httpError(conn, HTTP_ABORT | HTTP_CODE_SERVICE_UNAVAILABLE, 
+                    "Too many concurrent clients %d/%d", endpoint->clientCount, limits->clientMax);
+                return 0;
+            }
+        }
         action = "open conn";
         dir = HTTP_TRACE_RX;
         break;
 
     case HTTP_VALIDATE_CLOSE_CONN:
-        count = (int) PTOL(mprLookupKey(endpoint->clientLoad, conn->ip));
-        if (count > 1) {
-            mprAddKey(endpoint->clientLoad, conn->ip, ITOP(count - 1));
-        } else {
-            mprRemoveKey(endpoint->clientLoad, conn->ip);
+        if (removeClient(endpoint, &conn->ipKey)) {
+            mprAtomicAdd(&endpoint->clientCount, -1);
         }
-        endpoint->clientCount = (int) mprGetHashLength(endpoint->clientLoad);
         action = "close conn";
         dir = HTTP_TRACE_TX;
         break;
     
     case HTTP_VALIDATE_OPEN_REQUEST:
         mprAssert(conn->rx);
-        if (endpoint->requestCount >= limits->requestMax) {
-            unlock(http);
+        mprAtomicAdd(&endpoint->requestCount, 1);
+        if (endpoint->requestCount > limits->requestMax) {
+            mprAtomicAdd(&endpoint->requestCount, -1);
             httpError(conn, HTTP_CODE_SERVICE_UNAVAILABLE, "Server overloaded");
             mprLog(2, "Too many concurrent requests %d/%d", endpoint->requestCount, limits->requestMax);
             return 0;
         }
-        endpoint->requestCount++;
         conn->rx->flags |= HTTP_LIMITS_OPENED;
         action = "open request";
         dir = HTTP_TRACE_RX;
@@ -270,7 +468,7 @@ bool httpValidateLimits(HttpEndpoint *endpoint, int event, HttpConn *conn)
     case HTTP_VALIDATE_CLOSE_REQUEST:
         if (conn->rx && conn->rx->flags & HTTP_LIMITS_OPENED) {
             /* Requests incremented only when conn->rx is assigned */
-            endpoint->requestCount--;
+            mprAtomicAdd(&endpoint->requestCount, -1);
             mprAssert(endpoint->requestCount >= 0);
             action = "close request";
             dir = HTTP_TRACE_TX;
@@ -279,73 +477,63 @@ bool httpValidateLimits(HttpEndpoint *endpoint, int event, HttpConn *conn)
         break;
 
     case HTTP_VALIDATE_OPEN_PROCESS:
-        if (http->processCount >= limits->processMax) {
-            unlock(http);
+        mprAtomicAdd(&http->processCount, 1);
+        if (http->processCount > limits->processMax) {
+            mprAtomicAdd(&http->processCount, -1);
             httpError(conn, HTTP_CODE_SERVICE_UNAVAILABLE, "Server overloaded");
             mprLog(2, "Too many concurrent processes %d/%d", http->processCount, limits->processMax);
             return 0;
         }
-        http->processCount++;
         action = "start process";
         dir = HTTP_TRACE_RX;
         break;
 
     case HTTP_VALIDATE_CLOSE_PROCESS:
-        http->processCount--;
+        mprAtomicAdd(&http->processCount, -1);
         mprAssert(http->processCount >= 0);
         break;
     }
     if (event == HTTP_VALIDATE_CLOSE_CONN || event == HTTP_VALIDATE_CLOSE_REQUEST) {
         if ((level = httpShouldTrace(conn, dir, HTTP_TRACE_LIMITS, NULL)) >= 0) {
             LOG(4, "Validate request for %s. Active connections %d, active requests: %d/%d, active client IP %d/%d", 
-                action, mprGetListLength(http->connections), endpoint->requestCount, limits->requestMax, 
+                action, http->activeConns, endpoint->requestCount, limits->requestMax, 
                 endpoint->clientCount, limits->clientMax);
         }
     }
-    unlock(http);
     return 1;
 }
 
 
-/*  
-    Accept a new client connection on a new socket. If multithreaded, this will come in on a worker thread 
-    dedicated to this connection. This is called from the listen wait handler.
+/*
+    Create a connection for an accepted socket. Returns the connection and sets *pinned if the connection has been
+    moved to a reactor dispatcher. If the given dispatcher is null, a new dispatcher is created.
  */
-HttpConn *httpAcceptConn(HttpEndpoint *endpoint, MprEvent *event)
+static HttpConn *acceptConn(HttpEndpoint *endpoint, MprSocket *listenSock, MprSocket *sock, 
+    MprDispatcher *dispatcher, int *pinned)
 {
-    HttpConn        *conn;
-    MprSocket       *sock;
-    MprDispatcher   *dispatcher;
-    MprEvent        e;
-    int             level;
-
-    mprAssert(endpoint);
-    mprAssert(event);
+    HttpConn    *conn;
+    int         level;
 
-    /*
-        This will block in sync mode until a connection arrives
-     */
-    if ((sock = mprAcceptSocket(endpoint->sock)) == 0) {
-        if (endpoint->sock->handler) {
-            mprEnableSocketEvents(endpoint->sock, MPR_READABLE);
-        }
-        return 0;
-    }
+    *pinned = 0;
     if (endpoint->ssl) {
         if (mprUpgradeSocket(sock, endpoint->ssl, 1) < 0) {
             mprCloseSocket(sock, 0);
             return 0;
         }
     }
-    if (endpoint->sock->handler) {
-        /* Re-enable events on the listen socket */
-        mprEnableSocketEvents(endpoint->sock, MPR_READABLE);
-    }
-    dispatcher = event->dispatcher;
-
-    if (mprShouldDenyNewRequests()) {
-        mprCloseSocket(sock, 0);
-        return 0;
+    if (endpoint->async && !endpoint->dispatcher && mprGetReactorCount() > 0) {
+        /*
+            Pin the connection to a reactor. All further I/O and events for the connection run on the reactor thread.
+            Sharded listeners are already pinned, so keep the connection on the listener's reactor.
+         */
+        if (listenSock->handler && !(listenSock->handler->flags & MPR_WAIT_NEW_DISPATCHER)) {
+            dispatcher = mprCreateSiblingDispatcher(listenSock->handler->dispatcher, "IO");
+        } else {
+            dispatcher = mprCreateReactorDispatcher("IO");
+        }
+        *pinned = 1;
+    } else if (dispatcher == 0) {
+        dispatcher = mprCreateDispatcher("IO", 1);
     }
     if ((conn = httpCreateConn(endpoint->http, endpoint, dispatcher)) == 0) {
         mprCloseSocket(sock, 0);
@@ -357,6 +545,7 @@ HttpConn *httpAcceptConn(HttpEndpoint *endpoint, MprEvent *event)
     conn->sock = sock;
     conn->port = sock->port;
     conn->ip = sclone(sock->ip);
+    conn->ipKey = sock->ipKey;
     conn->secure = (endpoint->ssl != 0);
 
     if (!httpValidateLimits(endpoint, HTTP_VALIDATE_OPEN_CONN, conn)) {
@@ -368,16 +557,91 @@ HttpConn *httpAcceptConn(HttpEndpoint *endpoint, MprEvent *event)
     httpSetState(conn, HTTP_STATE_CONNECTED);
 
     if ((level = httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_CONN, NULL)) >= 0) {
-        mprLog(level, "### Incoming connection from %s:%d to %s:%d %s", 
+        mprLog(level, "### Incoming connection %Ld from %s:%d to %s:%d %s", conn->seqno,
             conn->ip, conn->port, sock->acceptIp, sock->acceptPort, conn->secure ? "(secure)" : "");
     }
-    e.mask = MPR_READABLE;
-    e.timestamp = conn->http->now;
-    (conn->ioCallback)(conn, &e);
     return conn;
 }
 
 
+/*  
+    Accept new client connections. If multithreaded, this will come in on a worker thread dedicated to the first 
+    connection. This is called from the listen wait handler. In async mode, pending connections are drained in a 
+    bounded batch to save a wait round trip per connection. The first connection is serviced inline on the event's 
+    dispatcher. Subsequent connections get their own dispatchers and are serviced via I/O events.
+ */
+HttpConn *httpAcceptConn(HttpEndpoint *endpoint, MprEvent *event)
+{
+    HttpConn        *conn, *first;
+    MprSocket       *sock, *listenSock;
+    MprEvent        e;
+    int             batch, count, pinned, firstPinned;
+
+    mprAssert(endpoint);
+    mprAssert(event);
+
+    listenSock = getListener(endpoint, event);
+    batch = (endpoint->async && listenSock->handler) ? HTTP_ACCEPT_BATCH : 1;
+    first = 0;
+    firstPinned = 0;
+    mprAtomicAdd64(&endpoint->acceptEvents, 1);
+
+    for (count = 0; count < batch; count++) {
+        /*
+            This will block in sync mode until a connection arrives
+         */
+        if ((sock = mprAcceptSocket(listenSock)) == 0) {
+            break;
+        }
+        mprAtomicAdd64(&endpoint->accepts, 1);
+        if (mprShouldDenyNewRequests()) {
+            mprCloseSocket(sock, 0);
+            break;
+        }
+        if (count == 0) {
+            first = acceptConn(endpoint, listenSock, sock, event->dispatcher, &firstPinned);
+        } else if ((conn = acceptConn(endpoint, listenSock, sock, endpoint->dispatcher, &pinned)) != 0) {
+            /* The connection's dispatcher will service the first read */
+            httpEnableConnEvents(conn);
+        }
+    }
+    if (listenSock->handler) {
+        /* Re-enable events on the listen socket */
+        mprEnableSocketEvents(listenSock, MPR_READABLE);
+    }
+    if (first) {
+        if (firstPinned) {
+            /* The reactor thread will service the first read */
+            httpEnableConnEvents(first);
+        } else {
+            e.mask = MPR_READABLE;
+            e.timestamp = first->http->now;
+            (first->ioCallback)(first, &e);
+        }
+    }
+    return first;
+}
+
+
+/*
+    Find the listening socket that signalled the event. Sharded listeners are only used in async mode.
+ */
+static MprSocket *getListener(HttpEndpoint *endpoint, MprEvent *event)
+{
+    MprSocket   *sock;
+    int         next;
+
+    if (mprGetListLength(endpoint->listeners) > 1) {
+        for (ITERATE_ITEMS(endpoint->listeners, sock, next)) {
+            if (sock->handler && sock->handler == event->handler) {
+                return sock;
+            }
+        }
+    }
+    return endpoint->sock;
+}
+
+
 void httpMatchHost(HttpConn *conn)
 { 
     MprSocket       *listenSock;
@@ -440,18 +704,49 @@ void httpSetEndpointAddress(HttpEndpoint *endpoint, cchar *ip, int port)
 
 void httpSetEndpointAsync(HttpEndpoint *endpoint, int async)
 {
-    if (endpoint->sock) {
+    MprSocket   *sock;
+    int         next;
+
+    for (ITERATE_ITEMS(endpoint->listeners, sock, next)) {
         if (endpoint->async && !async) {
-            mprSetSocketBlockingMode(endpoint->sock, 1);
+            mprSetSocketBlockingMode(sock, 1);
         }
         if (!endpoint->async && async) {
-            mprSetSocketBlockingMode(endpoint->sock, 0);
+            mprSetSocketBlockingMode(sock, 0);
         }
     }
     endpoint->async = async;
 }
 
 
+void httpSetEndpointBacklog(HttpEndpoint *endpoint, int backlog)
+{
+    mprAssert(endpoint);
+    endpoint->backlog = max(backlog, 0);
+}
+
+
+void httpSetEndpointDeferAccept(HttpEndpoint *endpoint, int timeout)
+{
+    mprAssert(endpoint);
+    endpoint->deferAccept = max(timeout, 0);
+}
+
+
+void httpSetEndpointShards(HttpEndpoint *endpoint, int count)
+{
+    mprAssert(endpoint);
+    endpoint->shards = max(count, 1);
+}
+
+
+void httpSetEndpointArena(HttpEndpoint *endpoint, ssize size)
+{
+    mprAssert(endpoint);
+    endpoint->arenaSize = max(size, 0);
+}
+
+
 void httpSetEndpointContext(HttpEndpoint *endpoint, void *context)
 {
     mprAssert(endpoint);
@@ -16,6 +16,10 @@ static void formatErrorv(HttpConn *conn, int status, cchar *fmt, va_list args);
 
 void httpDisconnect(HttpConn *conn)
 {
+    if (conn->heldOutput) {
+        /* Best effort to send the responses of completed pipelined requests */
+        httpWriteHeldOutput(conn);
+    }
     if (conn->sock) {
         mprDisconnectSocket(conn->sock);
     }
@@ -237,8 +237,8 @@ void httpSetHostProtocol(HttpHost *host, cchar *protocol)
 
 int httpAddRoute(HttpHost *host, HttpRoute *route)
 {
-    HttpRoute   *prev, *item, *lastRoute;
-    int         i, thisRoute;
+    HttpRoute   *next, *item, *lastRoute;
+    int         i;
 
     mprAssert(route);
     
@@ -248,23 +248,23 @@ int httpAddRoute(HttpHost *host, HttpRoute *route)
     if (mprLookupItem(host->routes, route) < 0) {
         if ((lastRoute = mprGetLastItem(host->routes)) && lastRoute->pattern[0] == '\0') {
             /* Insert before default route */
-            thisRoute = mprInsertItemAtPos(host->routes, mprGetListLength(host->routes) - 1, route);
+            mprInsertItemAtPos(host->routes, mprGetListLength(host->routes) - 1, route);
         } else {
-            thisRoute = mprAddItem(host->routes, route);
+            mprAddItem(host->routes, route);
         }
-        if (thisRoute > 0) {
-            prev = mprGetItem(host->routes, thisRoute - 1);
-            if (!smatch(prev->startSegment, route->startSegment)) {
-                prev->nextGroup = thisRoute;
-                for (i = thisRoute - 2; i >= 0; i--) {
-                    item = mprGetItem(host->routes, i);
-                    if (smatch(item->startSegment, prev->startSegment)) {
-                        item->nextGroup = thisRoute;
-                    } else {
-                        break;
-                    }
-                }
+        /*
+            Set the index of the next route with a different starting segment. Inserting shifts the following 
+            routes, so recompute all groups.
+         */
+        next = 0;
+        for (i = mprGetListLength(host->routes) - 1; i >= 0; i--) {
+            item = mprGetItem(host->routes, i);
+            if (next && smatch(item->startSegment, next->startSegment)) {
+                item->nextGroup = next->nextGroup;
+            } else {
+                item->nextGroup = i + 1;
             }
+            next = item;
         }
     }
     httpSetRouteHost(route, host);
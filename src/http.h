@@ -43,6 +43,10 @@ struct HttpUser;
 #define HTTP_NAME "Embedthis-http/" BIT_VERSION             /**< Default library name used in Http headers */
 #endif
 
+#ifndef BIT_HTTP_SIMD
+#define BIT_HTTP_SIMD 1                                     /**< Scan headers with SSE2/AVX2 instructions if available */
+#endif
+
 #if BIT_TUNE == MPR_TUNE_SIZE || DOXYGEN
     /*  
         Tune for size
@@ -52,6 +56,8 @@ struct HttpUser;
     #define HTTP_MAX_CHUNK             (8 * 1024)           /**< Maximum chunk size for transfer chunk encoding */
     #define HTTP_MAX_HEADERS           4096                 /**< Maximum size of the headers */
     #define HTTP_MAX_IOVEC             16                   /**< Number of fragments in a single socket write */
+    #define HTTP_MAX_PIPELINE_HOLD     (16 * 1024)          /**< Maximum pipelined response output held for one write */
+    #define HTTP_MAX_PACKET_POOL       2                    /**< Maximum idle packets retained by a connection */
     #define HTTP_MAX_NUM_HEADERS       20                   /**< Maximum number of header lines */
     #define HTTP_MAX_RECEIVE_FORM      (1024 * 1024)        /**< Maximum incoming form size */
     #define HTTP_MAX_RECEIVE_BODY      (128 * 1024 * 1024)  /**< Maximum incoming body size */
@@ -60,7 +66,9 @@ struct HttpUser;
     #define HTTP_MAX_SESSIONS          100                  /**< Maximum concurrent sessions */
     #define HTTP_MAX_STAGE_BUFFER      (32 * 1024)          /**< Maximum buffer for any stage */
     #define HTTP_CLIENTS_HASH          (131)                /**< Hash table for client IP addresses */
+    #define HTTP_CLIENT_SHARDS         4                    /**< Lock stripes for the client IP table */
     #define HTTP_MAX_ROUTE_MATCHES     32                   /**< Maximum number of submatches in routes */
+    #define HTTP_ACCEPT_BATCH          8                    /**< Maximum connections accepted per listen event */
 
 #elif BIT_TUNE == MPR_TUNE_BALANCED
     /*  
@@ -71,6 +79,8 @@ struct HttpUser;
     #define HTTP_MAX_CHUNK             (8 * 1024)
     #define HTTP_MAX_HEADERS           (8 * 1024)
     #define HTTP_MAX_IOVEC             24
+    #define HTTP_MAX_PIPELINE_HOLD     (32 * 1024)
+    #define HTTP_MAX_PACKET_POOL       4
     #define HTTP_MAX_NUM_HEADERS       40
     #define HTTP_MAX_RECEIVE_FORM      (8 * 1024 * 1024)
     #define HTTP_MAX_RECEIVE_BODY      (128 * 1024 * 1024)
@@ -79,7 +89,9 @@ struct HttpUser;
     #define HTTP_MAX_SESSIONS          500
     #define HTTP_MAX_STAGE_BUFFER      (64 * 1024)
     #define HTTP_CLIENTS_HASH          (257)
+    #define HTTP_CLIENT_SHARDS         8
     #define HTTP_MAX_ROUTE_MATCHES     64
+    #define HTTP_ACCEPT_BATCH          16
 
 #else
     /*  
@@ -90,6 +102,8 @@ struct HttpUser;
     #define HTTP_MAX_CHUNK             (16 * 1024) 
     #define HTTP_MAX_HEADERS           (8 * 1024)
     #define HTTP_MAX_IOVEC             32
+    #define HTTP_MAX_PIPELINE_HOLD     (64 * 1024)
+    #define HTTP_MAX_PACKET_POOL       4
     #define HTTP_MAX_NUM_HEADERS       256
     #define HTTP_MAX_RECEIVE_FORM      (16 * 1024 * 1024)
     #define HTTP_MAX_RECEIVE_BODY      (256 * 1024 * 1024)
@@ -98,7 +112,9 @@ struct HttpUser;
     #define HTTP_MAX_SESSIONS          5000
     #define HTTP_MAX_STAGE_BUFFER      (128 * 1024)
     #define HTTP_CLIENTS_HASH          (1009)
+    #define HTTP_CLIENT_SHARDS         16
     #define HTTP_MAX_ROUTE_MATCHES     128
+    #define HTTP_ACCEPT_BATCH          32
 #endif
 
 #define HTTP_MAX_TX_BODY           (INT_MAX)        /**< Maximum buffer for response data */
@@ -115,7 +131,9 @@ struct HttpUser;
 #define HTTP_RANGE_BUFSIZE        128               /**< Size of a range boundary */
 #define HTTP_RETRIES              3                 /**< Default number of retries for client requests */
 #define HTTP_TIMER_PERIOD         1000              /**< Timer checks ever 1 second */
+#define HTTP_TIMEOUT_SLOTS        64                /**< Slots in the connection timeout wheel (one per timer period) */
 #define HTTP_MAX_REWRITE          20                /**< Maximum URI rewrites */
+#define HTTP_ARENA_SIZE           (8 * 1024)        /**< Suggested request arena chunk size */
 
 #define HTTP_INACTIVITY_TIMEOUT   (60  * 1000)      /**< Keep connection alive timeout */
 #define HTTP_SESSION_TIMEOUT      (3600 * 1000)     /**< One hour */
@@ -231,6 +249,17 @@ typedef int (*HttpListenCallback)(struct HttpEndpoint *endpoint);
 extern void httpSetForkCallback(struct Http *http, MprForkCallback proc, void *arg);
 
 /************************************ Http **********************************/
+/**
+    Packet pool statistics
+    @ingroup HttpPacket
+ */
+typedef struct HttpPacketStats {
+    int64       allocated;                  /**< Pool packets created because the connection pool was empty */
+    int64       reused;                     /**< Packets taken from a connection pool */
+    int64       recycled;                   /**< Packets returned to a connection pool */
+    int64       released;                   /**< Packets left to the collector (pool full or buffer resized) */
+} HttpPacketStats;
+
 /** 
     Http service object
     @description The Http service is managed by a single service object.
@@ -244,7 +273,7 @@ extern void httpSetForkCallback(struct Http *http, MprForkCallback proc, void *a
 typedef struct Http {
     MprList         *endpoints;             /**< Currently configured listening endpoints */
     MprList         *hosts;                 /**< List of host objects */
-    MprList         *connections;           /**< Currently open connection requests */
+    struct HttpConn *connList;              /**< Currently open connections. Linked via HttpConn.nextConn */
     MprHash         *stages;                /**< Possible stages in connection pipelines */
     MprCache        *sessionCache;          /**< Session state cache */
     MprHash         *statusCodes;           /**< Http status codes */
@@ -281,6 +310,8 @@ typedef struct Http {
 
     MprEvent        *timer;                 /**< Admin service timer */
     MprEvent        *timestamp;             /**< Timestamp timer */
+    struct HttpConn *timeouts[HTTP_TIMEOUT_SLOTS]; /**< Timeout wheel. Lists of connections by deadline tick */
+    MprTime         timeoutTick;            /**< Last timeout wheel tick serviced by the timer */
     MprTime         booted;                 /**< Time the server started */
     MprTime         now;                    /**< When was the currentDate last computed */
     MprMutex        *mutex;
@@ -289,7 +320,8 @@ typedef struct Http {
     void            *forkData;
 
     int             nextAuth;               /**< Auth object version vector */
-    int             connCount;              /**< Count of connections */
+    int64           connCount;              /**< Count of connections ever created. Source of HttpConn.seqno */
+    int             activeConns;            /**< Count of currently open connections in connList */
     int             sessionCount;           /**< Count of sessions */
     void            *context;               /**< Embedding context */
     MprTime         currentTime;            /**< When currentDate was last calculated */
@@ -305,7 +337,8 @@ typedef struct Http {
     char            *protocol;              /**< HTTP/1.0 or HTTP/1.1 */
     char            *proxyHost;             /**< Proxy ip address */
     int             proxyPort;              /**< Proxy port */
-    int             processCount;           /**< Count of current active external processes */
+    volatile int    processCount;           /**< Count of current active external processes. Updated atomically */
+    HttpPacketStats packetStats;            /**< Packet pool statistics. Updated atomically */
 
     /*
         Callbacks
@@ -436,10 +469,22 @@ extern struct HttpEndpoint *httpLookupEndpoint(Http *http, cchar *ip, int port);
  */
 extern void httpSetSoftware(Http *http, cchar *description);
 
+/**
+    Iterate over the open connections
+    @description This is safe against removal of the current connection during iteration. The Http object must
+        be locked while iterating.
+    @param http Http object created via #httpCreate
+    @param conn HttpConn variable set to each connection in turn
+    @param next HttpConn variable used to hold the next connection
+ */
+#define ITERATE_CONNS(http, conn, next) \
+    conn = (http)->connList, next = 0; conn && ((next = conn->nextConn) != 0 || 1); conn = next
+
 /* Internal APIs */
 extern void httpAddConn(Http *http, struct HttpConn *conn);
 extern struct HttpEndpoint *httpGetFirstEndpoint(Http *http);
 extern void httpRemoveConn(Http *http, struct HttpConn *conn);
+extern void httpScheduleConnTimeout(struct HttpConn *conn);
 extern void httpAddEndpoint(Http *http, struct HttpEndpoint *endpoint);
 extern void httpRemoveEndpoint(Http *http, struct HttpEndpoint *endpoint);
 extern void httpAddHost(Http *http, struct HttpHost *host);
@@ -718,6 +763,7 @@ typedef struct HttpRange {
 #define HTTP_PACKET_RANGE     0x2               /**< Packet is a range boundary packet */
 #define HTTP_PACKET_DATA      0x4               /**< Packet contains actual content data */
 #define HTTP_PACKET_END       0x8               /**< End of stream packet */
+#define HTTP_PACKET_POOLED    0x10              /**< Packet owns a HTTP_BUFSIZE buffer and may be recycled */
 
 /**
     Callback procedure to fill a packet with data
@@ -743,8 +789,8 @@ typedef ssize (*HttpFillProc)(struct HttpQueue *q, struct HttpPacket *packet, Mp
     @defgroup HttpPacket HttpPacket
     @see HttpFillProc HttpPacket HttpQueue httpAdjustPacketEnd httpAdjustPacketStart httpClonePacket 
         httpCreateDataPacket httpCreateEndPacket httpCreateEntityPacket httpCreateHeaderPacket httpCreatePacket 
-        httpGetPacket httpGetPacketLength httpJoinPacket 
-        httpPutBackPacket httpPutForService httpPutPacket httpPutPacketToNext httpSplitPacket 
+        httpCreatePoolPacket httpGetPacket httpGetPacketLength httpGetPacketStats httpJoinPacket 
+        httpPutBackPacket httpPutForService httpPutPacket httpPutPacketToNext httpRecyclePacket httpSplitPacket 
  */
 typedef struct HttpPacket {
     MprBuf          *prefix;                /**< Prefix message to be emitted before the content */
@@ -836,6 +882,27 @@ extern HttpPacket *httpCreateHeaderPacket();
  */
 extern HttpPacket *httpCreatePacket(ssize size);
 
+/** 
+    Create a packet from the connection packet pool
+    @description Take an idle packet from the connection packet pool, or create a new one if the pool is empty. 
+        Pool packets have an empty, fixed size buffer of HTTP_BUFSIZE bytes and the HTTP_PACKET_POOLED flag.
+        They are returned to the pool via #httpRecyclePacket.
+    @param conn HttpConn connection object
+    @param flags Packet flags. Typically HTTP_PACKET_DATA or HTTP_PACKET_HEADER.
+    @return HttpPacket object.
+    @ingroup HttpPacket
+ */
+extern HttpPacket *httpCreatePoolPacket(struct HttpConn *conn, int flags);
+
+/**
+    Get the packet pool statistics
+    @description Get counters for packet pool use summed over all connections. The counters are updated atomically
+        and are cumulative since the Http service was created.
+    @param stats Reference to a HttpPacketStats structure to receive the statistics
+    @ingroup HttpPacket
+ */
+extern void httpGetPacketStats(HttpPacketStats *stats);
+
 /** 
     Get the next packet from a queue
     @description Get the next packet. This will remove the packet from the queue and adjust the queue counts
@@ -846,6 +913,20 @@ extern HttpPacket *httpCreatePacket(ssize size);
  */
 extern HttpPacket *httpGetPacket(struct HttpQueue *q);
 
+/** 
+    Recycle a packet
+    @description Return a packet that has been fully written or consumed to the connection packet pool. Only 
+        packets with the HTTP_PACKET_POOLED flag whose buffer is still HTTP_BUFSIZE bytes are retained, and at most 
+        HTTP_MAX_PACKET_POOL packets are retained per connection. The buffer of a templated header packet is held 
+        as the packet prefix and is reclaimed from there. Other packets are left to the garbage collector. The pool
+        is emptied when the connection goes idle waiting for the next request.
+        The caller must not use the packet or its buffer afterwards.
+    @param conn HttpConn connection object
+    @param packet Packet to recycle. The packet must not be on a queue.
+    @ingroup HttpPacket
+ */
+extern void httpRecyclePacket(struct HttpConn *conn, HttpPacket *packet);
+
 #if DOXYGEN
 /** 
     Get the length of the packet data contents.
@@ -930,12 +1011,15 @@ typedef void (*HttpQueueService)(struct HttpQueue *q);
         it's service() method to be invoked. 
         \n\n
         If a queue does not define a put() method, the default put() method will 
-        be used which queues data onto the service queue. The default incoming put() method joins incoming packets
-        into a single packet on the service queue.
+        be used which queues data onto the service queue. The default incoming put() method chains incoming packets
+        on the service queue without copying. The queued packets act as a chained buffer: their data can be exported
+        as an I/O vector via #httpGetQueueVec and only needs to be joined via #httpLinearizePacket when a parser 
+        requires contiguous data.
     @stability Evolving
     @defgroup HttpQueue HttpQueue
     @see HttpConn HttpPacket HttpQueue httpDisableQueue httpDiscardQueueData httpEnableQueue httpFlushQueue httpGetQueueRoom
-        httpIsEof httpIsPacketTooBig httpIsQueueEmpty httpJoinPacketForService httpJoinPackets httpOpenQueue
+        httpGetQueueVec httpIsEof httpIsPacketTooBig httpIsQueueEmpty httpJoinPacketForService httpJoinPackets 
+        httpLinearizePacket httpOpenQueue
         httpPutBackPacket httpPutForService httpPutPacket httpPutPacketToNext httpRemoveQueue httpResizePacket
         httpResumeQueue httpScheduleQueue httpServiceQueue httpSuspendQueue
         httpWillNextQueueAccept httpWillNextQueueAcceptSize httpWrite httpWriteBlock httpWriteBody httpWriteString 
@@ -1025,6 +1109,18 @@ extern bool httpFlushQueue(HttpQueue *q, bool block);
  */
 extern ssize httpGetQueueRoom(HttpQueue *q);
 
+/** 
+    Get an I/O vector for the queued data
+    @description Describe the data of the packets on the queue as an I/O vector without copying. Header packets,
+        entity packets and packets without data are skipped.
+    @param q Queue reference
+    @param iovec Vector to fill
+    @param max Maximum number of vector elements to fill
+    @return A count of the vector elements filled
+    @ingroup HttpQueue
+ */
+extern int httpGetQueueVec(HttpQueue *q, MprIOVec *iovec, int max);
+
 /**
     Test if the connection has received all incoming content
     @description This tests if the connection is at an "End of File condition.
@@ -1077,6 +1173,18 @@ extern void httpJoinPackets(HttpQueue *q, ssize size);
  */
 extern void httpJoinPacketForService(struct HttpQueue *q, HttpPacket *packet, bool serviceQ);
 
+/** 
+    Make queue data contiguous in the first packet
+    @description Ensure the first packet on the queue holds at least the given number of bytes of contiguous data.
+        Data is only copied when the first packet is short, and then only as much as is required. Following packets
+        that are emptied are removed from the queue. The queue count is not changed.
+    @param q Queue reference
+    @param size Required length of contiguous data. Set to -1 to join all queued data into the first packet.
+    @return The first packet on the queue. Returns null if the queue is empty or memory can't be allocated.
+    @ingroup HttpQueue
+ */
+extern HttpPacket *httpLinearizePacket(HttpQueue *q, ssize size);
+
 /** 
     Open the queue. Call the queue open entry point.
     @param q Queue reference
@@ -1724,7 +1832,7 @@ extern void httpSetIOCallback(struct HttpConn *conn, HttpIOCallback fn);
         httpServiceQueues httpSetAsync httpSetChunkSize httpSetConnContext httpSetConnHost httpSetConnNotifier
         httpSetCredentials httpSetKeepAliveCount httpSetPipelineHandler httpSetProtocol httpSetRetries
         httpSetSendConnector httpSetState httpSetTimeout httpSetTimestamp httpShouldTrace httpStartPipeline
-        httpNotifyWritable 
+        httpNotifyWritable httpWriteHeldOutput
  */
 typedef struct HttpConn {
     /*  Ordered for debugability */
@@ -1755,15 +1863,29 @@ typedef struct HttpConn {
     MprSocket       *sock;                  /**< Underlying socket handle */
 
     struct HttpQueue *serviceq;             /**< List of queues that require service for request pipeline */
+    MprArena        *arena;                 /**< Request arena. Reset for each request. Null if disabled */
     struct HttpQueue *currentq;             /**< Current queue being serviced (just for GC) */
 
     HttpPacket      *input;                 /**< Header packet */
+    int             *headerIndex;           /**< Input offsets of each header line and its colon while scanning */
+    int             headerIndexMax;         /**< Count of header lines that headerIndex can hold */
+    HttpPacket      *packetPool;            /**< Idle packets for reuse. Linked via HttpPacket.next */
+    int             packetPoolCount;        /**< Count of packets in packetPool */
+    HttpPacket      *heldOutput;            /**< Packets of responses held to write with the next pipelined response */
+    HttpPacket      *heldLast;              /**< Last held packet. Held packets are linked via HttpPacket.next */
+    ssize           heldCount;              /**< Count of held bytes not yet written */
+    int             heldVecs;               /**< Count of I/O vector entries required to write the held packets */
     HttpQueue       *readq;                 /**< End of the read pipeline */
     HttpQueue       *writeq;                /**< Start of the write pipeline */
     HttpQueue       *connectorq;            /**< Connector write queue */
     MprTime         started;                /**< When the connection started */
     MprTime         lastActivity;           /**< Last activity on the connection */
     MprEvent        *timeoutEvent;          /**< Connection or request timeout event */
+    MprTime         timeoutTick;            /**< Timer tick to next check for timeouts. Zero if not scheduled */
+    struct HttpConn *timeoutNext;           /**< Next connection in the timeout wheel slot */
+    struct HttpConn *timeoutPrev;           /**< Previous connection in the timeout wheel slot */
+    struct HttpConn *nextConn;              /**< Next open connection in Http.connList */
+    struct HttpConn *prevConn;              /**< Previous open connection in Http.connList */
     MprEvent        *workerEvent;           /**< Event for running connection via a worker thread */
     void            *context;               /**< Embedding context (EjsRequest) */
     void            *ejs;                   /**< Embedding VM */
@@ -1775,6 +1897,7 @@ typedef struct HttpConn {
     char            *boundary;              /**< File upload boundary */
     char            *errorMsg;              /**< Error message for the last request (if any) */
     char            *ip;                    /**< Remote client IP address */
+    MprIpKey        ipKey;                  /**< Remote client binary address. See MprSocket.ipKey */
     char            *protocol;              /**< HTTP protocol */
     int             async;                  /**< Connection is in async mode (non-blocking) */
     int             canProceed;             /**< State machine should continue to process the request */
@@ -1785,7 +1908,7 @@ typedef struct HttpConn {
     int             port;                   /**< Remote port */
     int             retries;                /**< Client request retries */
     int             secure;                 /**< Using https */
-    int             seqno;                  /**< Unique connection sequence number */
+    int64           seqno;                  /**< Unique connection id. Never reused, use in log messages */
     int             writeBlocked;           /**< Transmission writing is blocked */
     int             worker;                 /**< Use worker */
 
@@ -2257,6 +2380,20 @@ extern void httpStartPipeline(HttpConn *conn);
  */
 extern MprSocket *httpStealConn(HttpConn *conn);
 
+/**
+    Write responses held for pipelined requests
+    @description When pipelined requests are received, the complete responses of all but the last request are held 
+        and written together with the next response using one vectored write. This writes any held responses 
+        without blocking. It is called when there is no more input to process and when the socket becomes writable.
+        While the connector's I/O vector is in use, the connector is the only writer and completes the held output.
+    @param conn HttpConn object created via $httpCreateConn
+    @return True if all held output has been written or the connector owns it. The caller may then service the 
+        connector.
+    @ingroup HttpConn
+    @internal
+ */
+extern bool httpWriteHeldOutput(HttpConn *conn);
+
 /** Internal APIs */
 extern struct HttpConn *httpAccept(struct HttpEndpoint *endpoint);
 extern void httpEnableConnEvents(HttpConn *conn);
@@ -2813,6 +2950,19 @@ typedef void (*HttpProc)(HttpConn *conn);
  */
 extern void httpDefineProc(cchar *uri, HttpProc fun);
 
+/**
+    Add a route that serves heap and garbage collector statistics
+    @description This creates a procHandler route that responds with a JSON snapshot from mprGetHeapStats. The 
+        response includes collection counts and times, heap growth, free memory fragmentation, per-generation
+        block counts and the GC pause histogram. Times are in microseconds. Building the snapshot walks the heap, so 
+        restrict access to this route and scrape it periodically rather than per request.
+    @param parent Parent route from which to inherit
+    @param uri URI pattern for the statistics route. For example: "/heapStats"
+    @return Newly created route
+    @ingroup HttpProc
+ */
+extern struct HttpRoute *httpAddHeapStatsRoute(struct HttpRoute *parent, cchar *uri);
+
 /********************************** HttpRoute  *********************************/
 /*
     Misc route API flags
@@ -2895,6 +3045,7 @@ typedef struct HttpRoute {
     ssize           logSize;                /**< Max log size */
     HttpLimits      *limits;                /**< Host resource limits */
     MprHash         *mimeTypes;             /**< Hash table of mime types (key is extension) */
+    MprHash         *headerTemplates;       /**< Pre-rendered response headers (key is mime type) */
 
     HttpTrace       trace[2];               /**< Default route request tracing */
     int             traceMask;              /**< Request/response trace mask */
@@ -4044,6 +4195,54 @@ extern void httpRemoveUploadFile(HttpConn *conn, cchar *id);
 #define HTTP_CHUNK_DATA       2             /**< Start of chunk data */
 #define HTTP_CHUNK_EOF        3             /**< End of last chunk */
 
+/*
+    Well-known header ids. These index HttpRx.knownHeaders. See httpGetHeaderId.
+ */
+#define HTTP_HDR_ACCEPT                       0    /**< Accept */
+#define HTTP_HDR_ACCEPT_CHARSET               1    /**< Accept-Charset */
+#define HTTP_HDR_ACCEPT_ENCODING              2    /**< Accept-Encoding */
+#define HTTP_HDR_ACCEPT_LANGUAGE              3    /**< Accept-Language */
+#define HTTP_HDR_AUTHORIZATION                4    /**< Authorization */
+#define HTTP_HDR_CACHE_CONTROL                5    /**< Cache-Control */
+#define HTTP_HDR_CONNECTION                   6    /**< Connection */
+#define HTTP_HDR_CONTENT_ENCODING             7    /**< Content-Encoding */
+#define HTTP_HDR_CONTENT_LENGTH               8    /**< Content-Length */
+#define HTTP_HDR_CONTENT_RANGE                9    /**< Content-Range */
+#define HTTP_HDR_CONTENT_TYPE                10    /**< Content-Type */
+#define HTTP_HDR_COOKIE                      11    /**< Cookie */
+#define HTTP_HDR_DATE                        12    /**< Date */
+#define HTTP_HDR_ETAG                        13    /**< ETag */
+#define HTTP_HDR_EXPECT                      14    /**< Expect */
+#define HTTP_HDR_HOST                        15    /**< Host */
+#define HTTP_HDR_IF_MATCH                    16    /**< If-Match */
+#define HTTP_HDR_IF_MODIFIED_SINCE           17    /**< If-Modified-Since */
+#define HTTP_HDR_IF_NONE_MATCH               18    /**< If-None-Match */
+#define HTTP_HDR_IF_RANGE                    19    /**< If-Range */
+#define HTTP_HDR_IF_UNMODIFIED_SINCE         20    /**< If-Unmodified-Since */
+#define HTTP_HDR_KEEP_ALIVE                  21    /**< Keep-Alive */
+#define HTTP_HDR_LAST_MODIFIED               22    /**< Last-Modified */
+#define HTTP_HDR_LOCATION                    23    /**< Location */
+#define HTTP_HDR_ORIGIN                      24    /**< Origin */
+#define HTTP_HDR_PRAGMA                      25    /**< Pragma */
+#define HTTP_HDR_RANGE                       26    /**< Range */
+#define HTTP_HDR_REFERER                     27    /**< Referer */
+#define HTTP_HDR_SEC_WEBSOCKET_ACCEPT        28    /**< Sec-WebSocket-Accept */
+#define HTTP_HDR_SEC_WEBSOCKET_KEY           29    /**< Sec-WebSocket-Key */
+#define HTTP_HDR_SEC_WEBSOCKET_PROTOCOL      30    /**< Sec-WebSocket-Protocol */
+#define HTTP_HDR_SEC_WEBSOCKET_VERSION       31    /**< Sec-WebSocket-Version */
+#define HTTP_HDR_SERVER                      32    /**< Server */
+#define HTTP_HDR_SET_COOKIE                  33    /**< Set-Cookie */
+#define HTTP_HDR_TRANSFER_ENCODING           34    /**< Transfer-Encoding */
+#define HTTP_HDR_UPGRADE                     35    /**< Upgrade */
+#define HTTP_HDR_USER_AGENT                  36    /**< User-Agent */
+#define HTTP_HDR_VARY                        37    /**< Vary */
+#define HTTP_HDR_WWW_AUTHENTICATE            38    /**< WWW-Authenticate */
+#define HTTP_HDR_X_CHUNK_SIZE                39    /**< X-Chunk-Size */
+#define HTTP_HDR_X_FORWARDED_FOR             40    /**< X-Forwarded-For */
+#define HTTP_HDR_X_HTTP_METHOD_OVERRIDE      41    /**< X-HTTP-Method-Override */
+#define HTTP_HDR_X_REQUESTED_WITH            42    /**< X-Requested-With */
+#define HTTP_HDR_MAX                         43    /**< Count of well-known headers */
+
 /** 
     Http Rx
     @description Most of the APIs in the rx group still take a HttpConn object as their first parameter. This is
@@ -4052,9 +4251,9 @@ extern void httpRemoveUploadFile(HttpConn *conn, cchar *id);
     @defgroup HttpRx HttpRx
     @see HttpConn HttpRx HttpTx httpAddBodyVars httpAddParamsFromBuf httpAddParamsFromQueue httpContentNotModified 
         httpCreateCGIParams httpGetContentLength httpGetCookies httpGetParam httpGetParams httpGetHeader 
-        httpGetHeaderHash httpGetHeaders httpGetIntParam httpGetLanguage httpGetQueryString httpGetStatus 
-        httpGetStatusMessage httpMatchParam httpRead httpReadString httpSetParam httpSetIntParam httpSetUri 
-        httpTestParam httpTrimExtraPath 
+        httpGetHeaderHash httpGetHeaderId httpGetHeaders httpGetIntParam httpGetLanguage httpGetQueryString 
+        httpGetStatus httpGetStatusMessage httpMatchParam httpParseMessage httpRead httpReadString httpScanHeader 
+        httpSetParam httpSetIntParam httpSetUri httpTestParam httpTrimExtraPath 
  */
 typedef struct HttpRx {
     /* Ordered for debugging */
@@ -4074,8 +4273,16 @@ typedef struct HttpRx {
     int             sessionProbed;          /**< Session has been resolved */
 
     MprList         *etags;                 /**< Document etag to uniquely identify the document version */
-    HttpPacket      *headerPacket;          /**< HTTP headers */
-    MprHash         *headers;               /**< Header variables */
+    HttpPacket      *headerPacket;          /**< HTTP headers. Header keys and values reference this packet */
+    MprList         *headerCopies;          /**< Merged or modified header values that can't reference headerPacket */
+    ssize           headerScan;             /**< Offset in the input of the next byte to scan for a line end */
+    ssize           headerStart;            /**< Offset in the input of the first header after the first line */
+    ssize           lineStart;              /**< Offset in the input of the current (incomplete) header line */
+    ssize           lineColon;              /**< Offset in the input of the first colon in the current line. Zero if none */
+    int             headerLines;            /**< Count of header lines received including the first line */
+    int             keepAlive;              /**< Headers permit connection keep-alive */
+    MprHash         *headers;               /**< Header variables that are not well-known headers */
+    char            *knownHeaders[HTTP_HDR_MAX]; /**< Well-known header values indexed by HTTP_HDR_ id */
     MprList         *inputPipeline;         /**< Input processing */
     HttpUri         *parsedUri;             /**< Parsed request uri */
     MprHash         *requestData;           /**< General request data storage. Users must create hash table if required */
@@ -4091,6 +4298,7 @@ typedef struct HttpRx {
 
     bool            ifModified;             /**< If-Modified processing requested */
     bool            ifMatch;                /**< If-Match processing requested */
+    bool            knownMerged;            /**< Well-known headers have been added to the headers hash */
 
     /*  
         Incoming response line if a client request 
@@ -4099,7 +4307,7 @@ typedef struct HttpRx {
     char            *statusMessage;         /**< HTTP Response status message */
 
     /* 
-        Header values
+        Header values. These reference the header packet and are not separately allocated or marked.
      */
     char            *accept;                /**< Accept header */
     char            *acceptCharset;         /**< Accept-Charset header */
@@ -4237,7 +4445,7 @@ extern char *httpGetParamsString(HttpConn *conn);
     Get an rx http header.
     @description Get a http response header for a given header key.
     @param conn HttpConn connection object created via $httpCreateConn
-    @param key Name of the header to retrieve. This should be a lower case header name. For example: "Connection"
+    @param key Name of the header to retrieve. The name is not case sensitive. For example: "Connection"
     @return Value associated with the header key or null if the key did not exist in the response.
     @ingroup HttpRx
  */
@@ -4245,13 +4453,43 @@ extern cchar *httpGetHeader(HttpConn *conn, cchar *key);
 
 /** 
     Get the hash table of rx Http headers
-    @description Get the internal hash table of rx headers
+    @description Get the internal hash table of rx headers. Well-known headers are stored separately from the hash and
+        are added to the hash on the first call. Keys and values reference the header packet and are 
+        not managed by the hash. Values added to the hash must persist for the life of the request.
     @param conn HttpConn connection object created via $httpCreateConn
     @return Hash table. See MprHash for how to access the hash table.
     @ingroup HttpRx
  */
 extern MprHash *httpGetHeaderHash(HttpConn *conn);
 
+/**
+    Get the id of a well-known header
+    @description Well-known headers are recognized via a perfect hash of the header name and are stored by id in
+        HttpRx.knownHeaders rather than in the generic headers hash.
+    @param key Header name. The name is not case sensitive.
+    @param len Length of the key. Set to -1 if the key is null terminated.
+    @return A HTTP_HDR_ id or -1 if the key is not a well-known header.
+    @ingroup HttpRx
+ */
+extern int httpGetHeaderId(cchar *key, ssize len);
+
+/**
+    Parse a HTTP message from a packet without I/O
+    @description This runs the receive parser over a complete request (for server-side connections) or response 
+        (for client connections) held in memory. The first line and headers are parsed and any body data is decoded 
+        by the chunk filter and then discarded. Host matching, routing and the request pipeline are not invoked and 
+        no response is generated. Any prior message on the connection is discarded first. This is used by parser 
+        benchmarks and fuzzers. The connection should be created via $httpCreateConn without a socket.
+    @param conn HttpConn connection object created via $httpCreateConn
+    @param packet Packet containing the message. Parsed data is consumed from the packet. Remaining data belongs to 
+        the next pipelined message.
+    @return The count of body bytes decoded. Returns MPR_ERR_NOT_READY if the message is incomplete and 
+        MPR_ERR_BAD_FORMAT if the message is invalid. The parsed message is available via conn->rx.
+    @ingroup HttpRx
+    @internal
+ */
+extern ssize httpParseMessage(HttpConn *conn, HttpPacket *packet);
+
 /** 
     Get all the request http headers.
     @description Get all the rx headers. The returned string formats all the headers in the form:
@@ -4351,6 +4589,22 @@ extern ssize httpRead(HttpConn *conn, char *buffer, ssize size);
  */
 extern char *httpReadString(HttpConn *conn);
 
+/**
+    Scan HTTP header text for the end of a line
+    @description Scan forward for the newline that terminates a request, response or header line. The scan stops early
+        at any control character that is not permitted in a header line. Tabs and carriage returns are permitted. 
+        The first colon in the line is also located. The scan uses SSE2 or AVX2 vector instructions if the compiler 
+        targets them and BIT_HTTP_SIMD is enabled, otherwise it uses a portable byte scan.
+    @param start Text to scan
+    @param end End of the text to scan (one past the last byte)
+    @param colon Reference to a colon pointer. If *colon is null on entry, it is set to the first colon in the
+        scanned text before the returned character. Initialize to null before scanning a new line.
+    @return A reference to the terminating newline or to the first illegal control character. Returns null if
+        neither are found before end.
+    @ingroup HttpRx
+ */
+extern char *httpScanHeader(cchar *start, cchar *end, cchar **colon);
+
 /**
     Set a request param value
     @description Set the value of a named request param to a string value. Form variables are define via 
@@ -4884,6 +5138,28 @@ extern ssize httpWriteUploadData(HttpConn *conn, MprList *formData, MprList *fil
  */
 #define HTTP_NAMED_VHOST    0x1             /**< Using named virtual hosting */
 
+/**
+    Active connection count for one client IP address
+    @ingroup HttpEndpoint
+ */
+typedef struct HttpClientLoad {
+    MprIpKey        key;                    /**< Client binary address. See MprSocket.ipKey */
+    int             count;                  /**< Count of open connections. Zero if the slot is free */
+} HttpClientLoad;
+
+/**
+    One stripe of the endpoint client IP table. Clients are spread over HTTP_CLIENT_SHARDS stripes by address so
+    connections from different clients rarely contend for the same lock. Each stripe is an open addressed hash
+    table with linear probing.
+    @ingroup HttpEndpoint
+ */
+typedef struct HttpClientShard {
+    MprMutex        *mutex;                 /**< Stripe lock */
+    HttpClientLoad  *clients;               /**< Hash table of clients */
+    int             size;                   /**< Size of the clients table. Always a power of two */
+    int             length;                 /**< Count of clients in the table */
+} HttpClientShard;
+
 /** 
     Listening endpoints. Endpoints may have multiple virtual named hosts.
     @stability Evolving
@@ -4891,22 +5167,30 @@ extern ssize httpWriteUploadData(HttpConn *conn, MprList *formData, MprList *fil
     @see HttpEndpoint httpAcceptConn httpAddHostToEndpoint httpCreateConfiguredEndpoint httpCreateEndpoint 
         httpDestroyEndpoint httpGetEndpointContext httpHasNamedVirtualHosts httpIsEndpointAsync
         httpLookupHostOnEndpoint httpSecureEndpoint httpSecureEndpointByName httpSetEndpointAddress 
-        httpSetEndpointAsync httpSetEndpointContext httpSetEndpointNotifier httpSetHasNamedVirtualHosts 
-        httpStartEndpoint httpStopEndpoint httpValidateLimits 
+        httpSetEndpointArena httpSetEndpointAsync httpSetEndpointBacklog httpSetEndpointContext httpSetEndpointDeferAccept
+        httpSetEndpointNotifier httpSetEndpointShards httpSetHasNamedVirtualHosts httpStartEndpoint httpStopEndpoint httpValidateLimits 
  */
 typedef struct HttpEndpoint {
     Http            *http;                  /**< Http service object */
     MprList         *hosts;                 /**< List of host objects */
     HttpLimits      *limits;                /**< Alias for first host, default route resource limits */
-    MprHash         *clientLoad;            /**< Table of active client IPs and connection counts */
+    HttpClientShard clientShards[HTTP_CLIENT_SHARDS]; /**< Lock striped table of active client IPs */
+    uint64          clientSeed;             /**< Random seed for hashing client addresses into the table */
     char            *ip;                    /**< Listen IP address. May be null if listening on all interfaces. */
     int             port;                   /**< Listen port */
     int             async;                  /**< Listening is in async mode (non-blocking) */
-    int             clientCount;            /**< Count of current active clients */
-    int             requestCount;           /**< Count of current active requests */
+    volatile int    clientCount;            /**< Count of current active clients. Updated atomically */
+    volatile int    requestCount;           /**< Count of current active requests. Updated atomically */
     int             flags;                  /**< Endpoint control flags */
     void            *context;               /**< Embedding context */
-    MprSocket       *sock;                  /**< Listening socket */
+    int             backlog;                /**< Listen backlog. Zero for the O/S default */
+    int             deferAccept;            /**< TCP_DEFER_ACCEPT timeout in seconds. Zero if disabled */
+    int64           acceptEvents;           /**< Count of listen events serviced */
+    int64           accepts;                /**< Count of connections accepted. Divide by acceptEvents for batching */
+    int             shards;                 /**< Count of SO_REUSEPORT listening sockets to open */
+    ssize           arenaSize;              /**< Connection request arena chunk size. Zero if disabled */
+    MprSocket       *sock;                  /**< Listening socket. First listener when sharded */
+    MprList         *listeners;             /**< All listening sockets (including sock) */
     MprDispatcher   *dispatcher;            /**< Event dispatcher */
     HttpNotifier    notifier;               /**< Default connection notifier callback */
     struct MprSsl   *ssl;                   /**< Endpoint SSL configuration */
@@ -4922,10 +5206,12 @@ typedef struct HttpEndpoint {
 /**
     Accept a new connection.
     Accept a new client connection on a new socket. If multithreaded, this will come in on a worker thread 
-        dedicated to this connection. This is called from the listen wait handler.
+        dedicated to this connection. This is called from the listen wait handler. In async mode, this drains
+        up to HTTP_ACCEPT_BATCH pending connections. Connections after the first are serviced via I/O events
+        on their own dispatchers.
     @param endpoint The endpoint on which the server was listening
     @param event Mpr event object
-    @return A HttpConn object representing the new connection.
+    @return A HttpConn object representing the first new connection.
     @internal
  */
 extern HttpConn *httpAcceptConn(HttpEndpoint *endpoint, MprEvent *event);
@@ -5043,6 +5329,48 @@ extern void httpSetEndpointAddress(HttpEndpoint *endpoint, cchar *ip, int port);
  */
 extern void httpSetEndpointAsync(HttpEndpoint *endpoint, int enable);
 
+/**
+    Set the endpoint listen backlog
+    @description This defines the maximum length of the queue of pending connections for the endpoint's listening
+        sockets. Must be called before the endpoint is started.
+    @param endpoint HttpEndpoint object created via #httpCreateEndpoint
+    @param backlog Maximum pending connections. Set to zero for the O/S default (SOMAXCONN).
+ */
+extern void httpSetEndpointBacklog(HttpEndpoint *endpoint, int backlog);
+
+/**
+    Defer accepting connections until request data arrives
+    @description This sets TCP_DEFER_ACCEPT on the endpoint's listening sockets so connections are only accepted
+        once the client has sent data. Only supported on Linux. Must be called before the endpoint is started.
+    @param endpoint HttpEndpoint object created via #httpCreateEndpoint
+    @param timeout Maximum time in seconds to defer a connection. Set to zero to disable.
+ */
+extern void httpSetEndpointDeferAccept(HttpEndpoint *endpoint, int timeout);
+
+/**
+    Set the number of listening sockets for the endpoint
+    @description This opens multiple SO_REUSEPORT listening sockets on the endpoint's address so the O/S spreads
+        new connections over several acceptors. Each listener has its own wait handler and dispatcher. If reactors
+        are running, each listener is pinned to a reactor and connections it accepts remain on that reactor.
+        For best results, set the count to the number of reactors. Must be called before the endpoint is started.
+        If SO_REUSEPORT is not supported, a single listener is used.
+    @param endpoint HttpEndpoint object created via #httpCreateEndpoint
+    @param count Number of listening sockets. Defaults to one.
+ */
+extern void httpSetEndpointShards(HttpEndpoint *endpoint, int count);
+
+/**
+    Enable per-connection request arenas
+    @description Connections accepted on the endpoint allocate request and response header strings, parameter values and
+        routing temporaries from an arena that is reset when the connection is prepared for the next request. This
+        reduces garbage collection under keep-alive load. Handlers must not retain these strings (as returned by 
+        httpGetHeader and httpGetParam) beyond the request without copying them. Use mprEscapeArena(conn->arena, ptr)
+        or sclone to preserve a value.
+    @param endpoint HttpEndpoint object created via #httpCreateEndpoint
+    @param size Arena chunk size in bytes. Set to zero to disable. HTTP_ARENA_SIZE is a good default.
+ */
+extern void httpSetEndpointArena(HttpEndpoint *endpoint, ssize size);
+
 /**
     Set the endpoint context object
     @param endpoint HttpEndpoint object created via #httpCreateEndpoint
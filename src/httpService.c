@@ -66,10 +66,14 @@ HttpStatusCode HttpStatusCodes[] = {
 
 /****************************** Forward Declarations **************************/
 
+static void checkTimeouts(Http *http, int slot, MprTime tick);
+static MprTime getTimeoutTick(Http *http, HttpConn *conn);
 static void httpTimer(Http *http, MprEvent *event);
 static bool isIdle();
+static void linkTimeout(Http *http, HttpConn *conn, MprTime tick);
 static void manageHttp(Http *http, int flags);
 static void terminateHttp(int how, int status);
+static void unlinkTimeout(Http *http, HttpConn *conn);
 static void updateCurrentDate(Http *http);
 
 /*********************************** Code *************************************/
@@ -98,7 +102,6 @@ Http *httpCreate()
     http->routeUpdates = mprCreateHash(-1, MPR_HASH_STATIC_VALUES);
     http->hosts = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
     http->endpoints = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
-    http->connections = mprCreateList(-1, MPR_LIST_STATIC_VALUES);
     http->authTypes = mprCreateHash(-1, MPR_HASH_CASELESS | MPR_HASH_UNIQUE);
     http->authStores = mprCreateHash(-1, MPR_HASH_CASELESS | MPR_HASH_UNIQUE);
     http->defaultClientHost = sclone("127.0.0.1");
@@ -136,13 +139,11 @@ Http *httpCreate()
 
 static void manageHttp(Http *http, int flags)
 {
-    HttpConn    *conn;
-    int         next;
+    HttpConn    *conn, *next;
 
     if (flags & MPR_MANAGE_MARK) {
         mprMark(http->endpoints);
         mprMark(http->hosts);
-        mprMark(http->connections);
         mprMark(http->stages);
         mprMark(http->statusCodes);
         mprMark(http->routeTargets);
@@ -175,7 +176,7 @@ static void manageHttp(Http *http, int flags)
             Endpoints keep connections alive until a timeout. Keep marking even if no other references.
          */
         lock(http);
-        for (next = 0; (conn = mprGetNextItem(http->connections, &next)) != 0; ) {
+        for (ITERATE_CONNS(http, conn, next)) {
             if (conn->endpoint) {
                 mprMark(conn);
             }
@@ -380,18 +381,123 @@ void httpSetListenCallback(Http *http, HttpListenCallback fn)
 }
 
 
+/*
+    Connection timeouts are kept in a timer wheel with one slot per timer period. Each connection is linked into the
+    slot for the tick when its inactivity or request timeout will next expire. Activity only updates conn->lastActivity.
+    The wheel is corrected lazily when a slot comes due: connections that have not expired are relinked at their 
+    new deadline. So the timer only visits connections that may have expired. Must be called locked.
+ */
+static void linkTimeout(Http *http, HttpConn *conn, MprTime tick)
+{
+    HttpConn    **slot;
+
+    mprAssert(conn->timeoutTick == 0);
+    slot = &http->timeouts[tick % HTTP_TIMEOUT_SLOTS];
+    conn->timeoutTick = tick;
+    conn->timeoutPrev = 0;
+    conn->timeoutNext = *slot;
+    if (*slot) {
+        (*slot)->timeoutPrev = conn;
+    }
+    *slot = conn;
+}
+
+
+static void unlinkTimeout(Http *http, HttpConn *conn)
+{
+    if (conn->timeoutTick) {
+        if (conn->timeoutPrev) {
+            conn->timeoutPrev->timeoutNext = conn->timeoutNext;
+        } else {
+            http->timeouts[conn->timeoutTick % HTTP_TIMEOUT_SLOTS] = conn->timeoutNext;
+        }
+        if (conn->timeoutNext) {
+            conn->timeoutNext->timeoutPrev = conn->timeoutPrev;
+        }
+        conn->timeoutNext = conn->timeoutPrev = 0;
+        conn->timeoutTick = 0;
+    }
+}
+
+
+/*
+    Get the timer tick after which the connection's inactivity or request timeout will have expired
+ */
+static MprTime getTimeoutTick(Http *http, HttpConn *conn)
+{
+    HttpLimits  *limits;
+    MprTime     deadline;
+
+    limits = conn->limits;
+    deadline = min(conn->lastActivity + limits->inactivityTimeout, conn->started + limits->requestTimeout);
+    return max(deadline / HTTP_TIMER_PERIOD + 1, http->timeoutTick + 1);
+}
+
+
+/*
+    Reschedule the timeout check for a connection. Call after changing the connection limits.
+ */
+void httpScheduleConnTimeout(HttpConn *conn)
+{
+    Http    *http;
+
+    if ((http = conn->http) == 0) {
+        return;
+    }
+    lock(http);
+    unlinkTimeout(http, conn);
+    linkTimeout(http, conn, getTimeoutTick(http, conn));
+    unlock(http);
+}
+
+
+/*
+    Check connections in one timeout wheel slot. Connections that have expired are timed out. Others are relinked at
+    their current deadline. Must be called locked.
+ */
+static void checkTimeouts(Http *http, int slot, MprTime tick)
+{
+    HttpConn    *conn, *next;
+
+    for (conn = http->timeouts[slot]; conn; conn = next) {
+        next = conn->timeoutNext;
+        if (conn->timeoutTick > tick) {
+            /* Due in a later revolution of the wheel */
+            continue;
+        }
+        unlinkTimeout(http, conn);
+        if (!conn->timeoutEvent && (
+            (conn->lastActivity + conn->limits->inactivityTimeout) < http->now || 
+            (conn->started + conn->limits->requestTimeout) < http->now)) {
+            if (conn->rx) {
+                /*
+                    Don't call APIs on the conn directly (thread-race). Schedule a timer on the connection's dispatcher
+                 */
+                conn->timeoutEvent = mprCreateEvent(conn->dispatcher, "connTimeout", 0, httpConnTimeout, conn, 0);
+            } else {
+                mprLog(6, "Idle connection %Ld timed out", conn->seqno);
+                httpDisconnect(conn);
+                httpDiscardQueueData(conn->writeq, 1);
+                httpEnableConnEvents(conn);
+                conn->lastActivity = conn->started = http->now;
+            }
+        }
+        /* Relinking to this slot puts the connection before next, so it is not revisited */
+        linkTimeout(http, conn, conn->timeoutEvent ? (tick + 1) : getTimeoutTick(http, conn));
+    }
+}
+
+
 /*  
     The http timer does maintenance activities and will fire per second while there are active requests.
     This is run in both servers and clients.
-    NOTE: Because we lock the http here, connections cannot be deleted while we are modifying the list.
+    NOTE: Because we lock the http here, connections cannot be deleted while we are modifying the timeout wheel.
  */
 static void httpTimer(Http *http, MprEvent *event)
 {
-    HttpConn    *conn;
     HttpStage   *stage;
-    HttpRx      *rx;
-    HttpLimits  *limits;
     MprModule   *module;
+    MprTime     tick;
     int         next, active;
 
     mprAssert(event);
@@ -401,37 +507,25 @@ static void httpTimer(Http *http, MprEvent *event)
         return;
     }
     /* 
-       Check for any inactive connections or expired requests (inactivityTimeout and requestTimeout)
+       Check for any inactive connections or expired requests (inactivityTimeout and requestTimeout).
+       Only the wheel slots for the ticks since the last run are examined.
      */
     lock(http);
-    mprLog(6, "httpTimer: %d active connections", mprGetListLength(http->connections));
-    for (active = 0, next = 0; (conn = mprGetNextItem(http->connections, &next)) != 0; active++) {
-        rx = conn->rx;
-        limits = conn->limits;
-        if (!conn->timeoutEvent && (
-            (conn->lastActivity + limits->inactivityTimeout) < http->now || 
-            (conn->started + limits->requestTimeout) < http->now)) {
-            if (rx) {
-                /*
-                    Don't call APIs on the conn directly (thread-race). Schedule a timer on the connection's dispatcher
-                 */
-                if (!conn->timeoutEvent) {
-                    conn->timeoutEvent = mprCreateEvent(conn->dispatcher, "connTimeout", 0, httpConnTimeout, conn, 0);
-                }
-            } else {
-                mprLog(6, "Idle connection timed out");
-                httpDisconnect(conn);
-                httpDiscardQueueData(conn->writeq, 1);
-                httpEnableConnEvents(conn);
-                conn->lastActivity = conn->started = http->now;
-            }
-        }
+    active = http->activeConns;
+    mprLog(6, "httpTimer: %d active connections", active);
+    tick = http->now / HTTP_TIMER_PERIOD;
+    if (http->timeoutTick == 0 || (tick - http->timeoutTick) > HTTP_TIMEOUT_SLOTS) {
+        http->timeoutTick = tick - HTTP_TIMEOUT_SLOTS;
+    }
+    while (http->timeoutTick < tick) {
+        http->timeoutTick++;
+        checkTimeouts(http, (int) (http->timeoutTick % HTTP_TIMEOUT_SLOTS), tick);
     }
 
     /*
         Check for unloadable modules
      */
-    if (mprGetListLength(http->connections) == 0) {
+    if (http->activeConns == 0) {
         for (next = 0; (module = mprGetNextItem(MPR->moduleService->modules, &next)) != 0; ) {
             if (module->timeout) {
                 if (module->lastActivity + module->timeout < http->now) {
@@ -504,17 +598,16 @@ static void terminateHttp(int how, int status)
 
 static bool isIdle()
 {
-    HttpConn        *conn;
+    HttpConn        *conn, *next;
     Http            *http;
     MprTime         now;
-    int             next;
     static MprTime  lastTrace = 0;
 
     http = (Http*) mprGetMpr()->httpService;
     now = http->now;
 
     lock(http);
-    for (next = 0; (conn = mprGetNextItem(http->connections, &next)) != 0; ) {
+    for (ITERATE_CONNS(http, conn, next)) {
         if (conn->state != HTTP_STATE_BEGIN) {
             if (lastTrace < now) {
                 mprLog(1, "Waiting for request %s to complete", conn->rx->uri ? conn->rx->uri : conn->rx->pathInfo);
@@ -536,14 +629,25 @@ static bool isIdle()
 }
 
 
+/*
+    Open connections are kept in an intrusive doubly linked list so add and remove are O(1). The list does not
+    retain connections for the GC, manageHttp marks connections owned by endpoints.
+ */
 void httpAddConn(Http *http, HttpConn *conn)
 {
     conn->started = http->now;
-    mprAddItem(http->connections, conn);
 
     lock(http);
     conn->seqno = http->connCount++;
+    conn->prevConn = 0;
+    conn->nextConn = http->connList;
+    if (http->connList) {
+        http->connList->prevConn = conn;
+    }
+    http->connList = conn;
+    http->activeConns++;
     updateCurrentDate(http);
+    linkTimeout(http, conn, getTimeoutTick(http, conn));
     if (!http->timer) {
         http->timer = mprCreateTimerEvent(NULL, "httpTimer", HTTP_TIMER_PERIOD, httpTimer, http, 
             MPR_EVENT_CONTINUOUS | MPR_EVENT_QUICK);
@@ -554,7 +658,21 @@ void httpAddConn(Http *http, HttpConn *conn)
 
 void httpRemoveConn(Http *http, HttpConn *conn)
 {
-    mprRemoveItem(http->connections, conn);
+    lock(http);
+    unlinkTimeout(http, conn);
+    if (conn->prevConn || http->connList == conn) {
+        if (conn->prevConn) {
+            conn->prevConn->nextConn = conn->nextConn;
+        } else {
+            http->connList = conn->nextConn;
+        }
+        if (conn->nextConn) {
+            conn->nextConn->prevConn = conn->prevConn;
+        }
+        conn->nextConn = conn->prevConn = 0;
+        http->activeConns--;
+    }
+    unlock(http);
 }
 
 
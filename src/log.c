@@ -112,7 +112,7 @@ void httpLogRequest(HttpConn *conn)
     HttpTx      *tx;
     HttpRoute   *route;
     MprBuf      *buf;
-    char        keyBuf[80], *timeText, *fmt, *cp, *qualifier, *value, c;
+    char        *timeText, *fmt, *cp, *qualifier, *value, c;
     int         len;
 
     if ((rx = conn->rx) == 0) {
@@ -192,11 +192,9 @@ void httpLogRequest(HttpConn *conn)
                 fmt = &cp[1];
                 *cp = '\0';
                 c = *fmt++;
-                scopy(keyBuf, sizeof(keyBuf), "HTTP_");
-                scopy(&keyBuf[5], sizeof(keyBuf) - 5, qualifier);
                 switch (c) {
                 case 'i':
-                    value = (char*) mprLookupKey(rx->headers, supper(keyBuf));
+                    value = (char*) httpGetHeader(conn, qualifier);
                     mprPutStringToBuf(buf, value ? value : "-");
                     break;
                 default:
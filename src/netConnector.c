@@ -14,9 +14,12 @@
 /**************************** Forward Declarations ****************************/
 
 static void addPacketForNet(HttpQueue *q, HttpPacket *packet);
+static void addToNetVector(HttpQueue *q, char *ptr, ssize bytes);
 static void adjustNetVec(HttpQueue *q, ssize written);
 static MprOff buildNetVec(HttpQueue *q);
+static ssize freeHeldPackets(HttpConn *conn, ssize written);
 static void freeNetPackets(HttpQueue *q, ssize written);
+static bool holdForPipeline(HttpQueue *q);
 static void netClose(HttpQueue *q);
 static void netOutgoingService(HttpQueue *q);
 
@@ -92,6 +95,9 @@ static void netOutgoingService(HttpQueue *q)
             return;
         }
     }
+    if (holdForPipeline(q)) {
+        return;
+    }
     while (q->first || q->ioIndex) {
         if (q->ioIndex == 0 && buildNetVec(q) <= 0) {
             break;
@@ -122,9 +128,13 @@ static void netOutgoingService(HttpQueue *q)
             break;
 
         } else if (written > 0) {
+            adjustNetVec(q, written);
+            if (conn->heldOutput) {
+                /* Held responses of prior pipelined requests lead the vector */
+                written = freeHeldPackets(conn, written);
+            }
             tx->bytesWritten += written;
             freeNetPackets(q, written);
-            adjustNetVec(q, written);
         }
     }
     if (q->ioCount == 0) {
@@ -149,6 +159,18 @@ static MprOff buildNetVec(HttpQueue *q)
     conn = q->conn;
     tx = conn->tx;
 
+    /*
+        Responses held for prior pipelined requests must be written first. The hold limits the held packets so they
+        always fit in the vector with room to spare.
+     */
+    for (packet = conn->heldOutput; packet; packet = packet->next) {
+        if (packet->prefix && mprGetBufLength(packet->prefix) > 0) {
+            addToNetVector(q, mprGetBufStart(packet->prefix), mprGetBufLength(packet->prefix));
+        }
+        if (packet->content && mprGetBufLength(packet->content) > 0) {
+            addToNetVector(q, mprGetBufStart(packet->content), mprGetBufLength(packet->content));
+        }
+    }
     /*
         Examine each packet and accumulate as many packets into the I/O vector as possible. Leave the packets on the queue 
         for now, they are removed after the IO is complete for the entire packet.
@@ -219,6 +241,181 @@ static void addPacketForNet(HttpQueue *q, HttpPacket *packet)
 }
 
 
+/*
+    Hold a complete response if more pipelined requests have already been received. The rendered packets are moved
+    from the queue to conn->heldOutput and are written with the response of the next request so that several pipelined
+    responses are sent with one vectored write. Any held output is written when httpPump has no more input to process. 
+    Return true if the response was held.
+ */
+static bool holdForPipeline(HttpQueue *q)
+{
+    HttpConn    *conn;
+    HttpTx      *tx;
+    HttpPacket  *packet;
+    int         item, vecs;
+
+    conn = q->conn;
+    tx = conn->tx;
+
+    /*
+        The keep-alive count is decremented when the headers are rendered. Don't hold the last response before the 
+        connection is closed.
+     */
+    if (!conn->endpoint || !conn->inHttpProcess || conn->error || conn->keepAliveCount <= 1 || q->ioIndex || 
+            tx->bytesWritten || !conn->rx->eof || !conn->input || httpGetPacketLength(conn->input) == 0) {
+        return 0;
+    }
+    /*
+        Only hold small responses that are entirely in the queue. The header packet is not yet rendered so allow for it.
+     */
+    if ((conn->heldCount + q->count + HTTP_MAX_HEADERS) > HTTP_MAX_PIPELINE_HOLD || !q->last || 
+            !(q->last->flags & HTTP_PACKET_END)) {
+        return 0;
+    }
+    if (tx->chunkSize <= 0 && tx->length < 0 && q->count > 0) {
+        /* Without chunking or a content length, the connection will be closed after the response */
+        return 0;
+    }
+    /*
+        Render the headers to count the vector entries required. Leave room for the headers, body and end of the next
+        response: buildNetVec stops adding packets when fewer than two entries remain. Rendering is done once, so if 
+        not held, the response is written as usual.
+     */
+    vecs = 0;
+    for (packet = q->first; packet; packet = packet->next) {
+        if (packet->flags & HTTP_PACKET_HEADER) {
+            httpWriteHeaders(conn, packet);
+        }
+        vecs += (packet->prefix && mprGetBufLength(packet->prefix) > 0) + (httpGetPacketLength(packet) > 0);
+    }
+    if ((conn->heldVecs + vecs) > (HTTP_MAX_IOVEC - 6)) {
+        return 0;
+    }
+    while ((packet = q->first) != 0) {
+        if (packet->flags & HTTP_PACKET_HEADER) {
+            /* Rendered headers don't count in the q->count until added to the vector */
+            q->count += httpGetPacketLength(packet);
+        }
+        httpGetPacket(q);
+        if ((packet->prefix == 0 || mprGetBufLength(packet->prefix) == 0) && httpGetPacketLength(packet) == 0) {
+            httpRecyclePacket(conn, packet);
+            continue;
+        }
+        item = (packet->flags & HTTP_PACKET_HEADER) ? HTTP_TRACE_HEADER : HTTP_TRACE_BODY;
+        if (httpShouldTrace(conn, HTTP_TRACE_TX, item, tx->ext) >= 0) {
+            httpTraceContent(conn, HTTP_TRACE_TX, item, packet, 0, (ssize) tx->bytesWritten);
+        }
+        packet->next = 0;
+        if (conn->heldLast) {
+            conn->heldLast->next = packet;
+        } else {
+            conn->heldOutput = packet;
+        }
+        conn->heldLast = packet;
+        conn->heldCount += (packet->prefix ? mprGetBufLength(packet->prefix) : 0) + httpGetPacketLength(packet);
+        tx->bytesWritten += (packet->prefix ? mprGetBufLength(packet->prefix) : 0) + httpGetPacketLength(packet);
+    }
+    conn->heldVecs += vecs;
+    q->count = 0;
+    httpConnectorComplete(conn);
+    return 1;
+}
+
+
+/*
+    Consume written bytes from the held packets and recycle packets that have been entirely written. Return the count 
+    of written bytes that remain after the held output.
+ */
+static ssize freeHeldPackets(HttpConn *conn, ssize written)
+{
+    HttpPacket  *packet;
+    ssize       len;
+
+    while (written > 0 && (packet = conn->heldOutput) != 0) {
+        if (packet->prefix) {
+            len = min(mprGetBufLength(packet->prefix), written);
+            mprAdjustBufStart(packet->prefix, len);
+            conn->heldCount -= len;
+            written -= len;
+            if (mprGetBufLength(packet->prefix) == 0) {
+                packet->prefix = 0;
+            }
+        }
+        if (packet->content) {
+            len = min(mprGetBufLength(packet->content), written);
+            mprAdjustBufStart(packet->content, len);
+            conn->heldCount -= len;
+            written -= len;
+        }
+        if (packet->prefix == 0 && httpGetPacketLength(packet) == 0) {
+            if ((conn->heldOutput = packet->next) == 0) {
+                conn->heldLast = 0;
+                conn->heldVecs = 0;
+            }
+            httpRecyclePacket(conn, packet);
+        }
+    }
+    return written;
+}
+
+
+/*
+    Write responses held for pipelined requests. This does not block. If the socket is full, the remaining output is
+    written on the next writable event. While the connector's I/O vector is in use, the connector is the only writer 
+    and completes the write of the held output. Return true if the caller may proceed to service the connector.
+ */
+bool httpWriteHeldOutput(HttpConn *conn)
+{
+    HttpPacket  *packet;
+    MprIOVec    iovec[HTTP_MAX_IOVEC];
+    ssize       written;
+    int         errCode, index;
+
+    if (conn->heldOutput == 0) {
+        return 1;
+    }
+    if (!conn->sock) {
+        return 0;
+    }
+    if (conn->tx && conn->connectorq && conn->connectorq->ioIndex > 0) {
+        /* The connector has the held output in its I/O vector and will complete the write */
+        return 1;
+    }
+    while (conn->heldOutput) {
+        index = 0;
+        for (packet = conn->heldOutput; packet && index < (HTTP_MAX_IOVEC - 1); packet = packet->next) {
+            if (packet->prefix && mprGetBufLength(packet->prefix) > 0) {
+                iovec[index].start = mprGetBufStart(packet->prefix);
+                iovec[index++].len = mprGetBufLength(packet->prefix);
+            }
+            if (httpGetPacketLength(packet) > 0) {
+                iovec[index].start = mprGetBufStart(packet->content);
+                iovec[index++].len = mprGetBufLength(packet->content);
+            }
+        }
+        if ((written = mprWriteSocketVector(conn->sock, iovec, index)) < 0) {
+            errCode = mprGetError();
+            if (errCode == EAGAIN || errCode == EWOULDBLOCK) {
+                break;
+            }
+            conn->heldOutput = conn->heldLast = 0;
+            conn->heldCount = conn->heldVecs = 0;
+            httpDisconnect(conn);
+            return 0;
+        } else if (written == 0) {
+            break;
+        }
+        freeHeldPackets(conn, written);
+    }
+    if (conn->heldOutput) {
+        conn->writeBlocked = 1;
+        httpEnableConnEvents(conn);
+        return 0;
+    }
+    return 1;
+}
+
+
 static void freeNetPackets(HttpQueue *q, ssize bytes)
 {
     HttpPacket    *packet;
@@ -251,6 +448,7 @@ static void freeNetPackets(HttpQueue *q, ssize bytes)
                 This will remove the packet from the queue and will re-enable upstream disabled queues.
              */
             httpGetPacket(q);
+            httpRecyclePacket(q->conn, packet);
         }
     }
 }
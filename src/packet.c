@@ -8,6 +8,10 @@
 
 #include    "http.h"
 
+/*********************************** Locals ***********************************/
+
+static int packetSlab = -1;             /* Slab pool for packets */
+
 /********************************** Forwards **********************************/
 
 static void managePacket(HttpPacket *packet, int flags);
@@ -22,7 +26,10 @@ HttpPacket *httpCreatePacket(ssize size)
 {
     HttpPacket  *packet;
 
-    if ((packet = mprAllocObj(HttpPacket, managePacket)) == 0) {
+    if (packetSlab < 0) {
+        packetSlab = mprCreateSlab("HttpPacket", sizeof(HttpPacket), MPR_ALLOC_MANAGER);
+    }
+    if ((packet = mprAllocSlabObj(packetSlab, HttpPacket, managePacket)) == 0) {
         return 0;
     }
     if (size != 0) {
@@ -44,6 +51,68 @@ static void managePacket(HttpPacket *packet, int flags)
 }
 
 
+/*
+    Take a packet from the connection pool. The caller (re)sets the packet flags, so a recycled header packet may
+    be reused as a data packet and vice-versa.
+ */
+HttpPacket *httpCreatePoolPacket(HttpConn *conn, int flags)
+{
+    HttpPacket  *packet;
+
+    if ((packet = conn->packetPool) != 0) {
+        conn->packetPool = packet->next;
+        conn->packetPoolCount--;
+        packet->next = 0;
+        mprAtomicAdd64(&conn->http->packetStats.reused, 1);
+    } else {
+        if ((packet = httpCreatePacket(HTTP_BUFSIZE)) == 0) {
+            return 0;
+        }
+        mprAtomicAdd64(&conn->http->packetStats.allocated, 1);
+    }
+    packet->flags = flags | HTTP_PACKET_POOLED;
+    return packet;
+}
+
+
+void httpRecyclePacket(HttpConn *conn, HttpPacket *packet)
+{
+    MprBuf      *content;
+
+    if (!(packet->flags & HTTP_PACKET_POOLED)) {
+        return;
+    }
+    content = packet->content;
+    if (packet->prefix && mprGetBufSize(packet->prefix) == HTTP_BUFSIZE) {
+        /* Templated header packets hold their own buffer as the prefix. The content is a view of the template. */
+        content = packet->content = packet->prefix;
+    }
+    if (content == 0 || mprGetBufSize(content) != HTTP_BUFSIZE || conn->packetPoolCount >= HTTP_MAX_PACKET_POOL) {
+        mprAtomicAdd64(&conn->http->packetStats.released, 1);
+        return;
+    }
+    mprFlushBuf(content);
+    packet->prefix = 0;
+    packet->esize = 0;
+    packet->epos = 0;
+    packet->fill = 0;
+    packet->flags = 0;
+    packet->next = conn->packetPool;
+    conn->packetPool = packet;
+    conn->packetPoolCount++;
+    mprAtomicAdd64(&conn->http->packetStats.recycled, 1);
+}
+
+
+void httpGetPacketStats(HttpPacketStats *stats)
+{
+    Http    *http;
+
+    http = MPR->httpService;
+    *stats = http->packetStats;
+}
+
+
 HttpPacket *httpCreateDataPacket(ssize size)
 {
     HttpPacket    *packet;
@@ -244,6 +313,16 @@ void httpJoinPackets(HttpQueue *q, ssize size)
             /* Step over a header packet */
             first = first->next;
         }
+        /* Grow the first packet once for all the data rather than once per joined packet */
+        for (len = 0, packet = first->next; packet; packet = packet->next) {
+            if (packet->content == 0 || httpGetPacketLength(packet) == 0) {
+                break;
+            }
+            len += httpGetPacketLength(packet);
+        }
+        if (first->content && len > mprGetBufSpace(first->content)) {
+            mprGrowBuf(first->content, len - mprGetBufSpace(first->content));
+        }
         for (packet = first->next; packet; packet = packet->next) {
             if (packet->content == 0 || (len = httpGetPacketLength(packet)) == 0) {
                 break;
@@ -257,6 +336,58 @@ void httpJoinPackets(HttpQueue *q, ssize size)
 }
 
 
+/*
+    Make the first packet on the queue hold at least "size" bytes of contiguous data. Only the data required is copied 
+    from the following packets. Emptied packets are unlinked and recycled.
+    WARNING: this will not update the queue count.
+ */
+HttpPacket *httpLinearizePacket(HttpQueue *q, ssize size)
+{
+    HttpPacket  *first, *packet;
+    MprBuf      *content;
+    ssize       len, need, count;
+
+    if ((first = q->first) == 0 || (content = first->content) == 0 || first->esize) {
+        return first;
+    }
+    if (size < 0) {
+        size = MAXSSIZE;
+    }
+    len = httpGetPacketLength(first);
+    for (need = 0, packet = first->next; packet && len + need < size; packet = packet->next) {
+        if (packet->content == 0 || packet->esize || (packet->flags & (HTTP_PACKET_HEADER | HTTP_PACKET_END)) ||
+                (count = httpGetPacketLength(packet)) == 0) {
+            break;
+        }
+        need += count;
+    }
+    need = min(need, size - len);
+    if (need <= 0) {
+        return first;
+    }
+    if (mprGetBufSpace(content) < need) {
+        mprCompactBuf(content);
+        if (mprGetBufSpace(content) < need && mprGrowBuf(content, need - mprGetBufSpace(content)) < 0) {
+            return 0;
+        }
+    }
+    while (need > 0 && (packet = first->next) != 0) {
+        count = min(need, httpGetPacketLength(packet));
+        mprPutBlockToBuf(content, mprGetBufStart(packet->content), count);
+        mprAdjustBufStart(packet->content, count);
+        need -= count;
+        if (httpGetPacketLength(packet) == 0) {
+            first->next = packet->next;
+            if (q->last == packet) {
+                q->last = first;
+            }
+            httpRecyclePacket(q->conn, packet);
+        }
+    }
+    return first;
+}
+
+
 void httpPutPacket(HttpQueue *q, HttpPacket *packet)
 {
     mprAssert(packet);
@@ -48,8 +48,12 @@ void httpCreateTxPipeline(HttpConn *conn, HttpRoute *route)
         }
     }
     if (tx->connector == 0) {
+        /*
+            Secure connections also use the send connector. mprSendFileToSocket packs file data into TLS record sized 
+            buffers for the SSL provider rather than copying it through data packets.
+         */
         if (tx->handler == http->fileHandler && (rx->flags & HTTP_GET) && !hasOutputFilters && 
-                !conn->secure && httpShouldTrace(conn, HTTP_TRACE_TX, HTTP_TRACE_BODY, tx->ext) < 0) {
+                httpShouldTrace(conn, HTTP_TRACE_TX, HTTP_TRACE_BODY, tx->ext) < 0) {
             tx->connector = http->sendConnector;
         } else if (route && route->connector) {
             tx->connector = route->connector;
@@ -73,7 +77,7 @@ void httpCreateTxPipeline(HttpConn *conn, HttpRoute *route)
         Put the header before opening the queues incase an open routine actually services and completes the request
         httpHandleOptionsTrace does this when called from openFile() in fileHandler.
      */
-    httpPutForService(conn->writeq, httpCreateHeaderPacket(), HTTP_DELAY_SERVICE);
+    httpPutForService(conn->writeq, httpCreatePoolPacket(conn, HTTP_PACKET_HEADER), HTTP_DELAY_SERVICE);
     openQueues(conn);
 
     /*
@@ -10,6 +10,11 @@
 
 #include    "http.h"
 
+/********************************** Forwards **********************************/
+
+static void heapStatsProc(HttpConn *conn);
+static void putGenStats(MprBuf *buf, cchar *name, MprGenStats *gp);
+
 /*********************************** Code *************************************/
 
 static void startProc(HttpQueue *q)
@@ -41,6 +46,65 @@ void httpDefineProc(cchar *name, HttpProc proc)
 }
 
 
+/*
+    Add a route that serves a JSON snapshot of the heap and garbage collector statistics
+ */
+HttpRoute *httpAddHeapStatsRoute(HttpRoute *parent, cchar *uri)
+{
+    return httpCreateProcRoute(parent, uri, heapStatsProc);
+}
+
+
+static void heapStatsProc(HttpConn *conn)
+{
+    MprHeapStats    stats;
+    MprGCPauses     *pp;
+    MprBuf          *buf;
+    int             i;
+
+    mprGetHeapStats(&stats);
+    pp = &stats.pauses;
+    buf = mprCreateBuf(0, 0);
+    mprPutFmtToBuf(buf, "{\n  \"collections\": %Ld,\n  \"syncTime\": %Ld,\n  \"markTime\": %Ld,\n"
+        "  \"sweepTime\": %Ld,\n  \"freed\": %Ld,\n", stats.collections, stats.syncTime, stats.markTime, 
+        stats.sweepTime, stats.freed);
+    mprPutFmtToBuf(buf, "  \"growths\": %Ld,\n  \"growBytes\": %Ld,\n  \"releases\": %Ld,\n  \"released\": %Ld,\n"
+        "  \"advised\": %Ld,\n",
+        stats.growths, stats.growBytes, stats.releases, stats.released, stats.advised);
+    mprPutFmtToBuf(buf, "  \"bytesAllocated\": %Ld,\n  \"bytesFree\": %Ld,\n  \"heapSize\": %Ld,\n  \"regions\": %d,\n"
+        "  \"largestFree\": %Ld,\n  \"fragmentation\": %d,\n", stats.bytesAllocated, stats.bytesFree, stats.heapSize, 
+        stats.regions, stats.largestFree, stats.fragmentation);
+    mprPutStringToBuf(buf, "  \"generations\": {\n");
+    putGenStats(buf, "eternal", &stats.eternal);
+    mprPutStringToBuf(buf, ",\n");
+    putGenStats(buf, "active", &stats.active);
+    mprPutStringToBuf(buf, ",\n");
+    putGenStats(buf, "dead", &stats.dead);
+    mprPutStringToBuf(buf, ",\n");
+    putGenStats(buf, "free", &stats.free);
+    mprPutStringToBuf(buf, ",\n");
+    putGenStats(buf, "slabFree", &stats.slabFree);
+    mprPutFmtToBuf(buf, "\n  },\n  \"pauses\": {\n    \"count\": %Ld,\n    \"total\": %Ld,\n    \"max\": %Ld,\n"
+        "    \"aborted\": %Ld,\n    \"histogram\": [", pp->count, pp->total, pp->max, pp->aborted);
+    for (i = 0; i < MPR_GC_PAUSE_BUCKETS; i++) {
+        mprPutFmtToBuf(buf, "%s%Ld", i ? ", " : "", pp->histogram[i]);
+    }
+    mprPutStringToBuf(buf, "]\n  }\n}\n");
+
+    httpSetContentType(conn, "application/json");
+    httpSetHeaderString(conn, "Cache-Control", "no-cache");
+    httpSetContentLength(conn, mprGetBufLength(buf));
+    httpWriteBlock(conn->writeq, mprGetBufStart(buf), mprGetBufLength(buf));
+    httpFinalize(conn);
+}
+
+
+static void putGenStats(MprBuf *buf, cchar *name, MprGenStats *gp)
+{
+    mprPutFmtToBuf(buf, "    \"%s\": { \"blocks\": %Ld, \"bytes\": %Ld }", name, gp->blocks, gp->bytes);
+}
+
+
 int httpOpenProcHandler(Http *http)
 {
     HttpStage     *stage;
@@ -7,6 +7,10 @@
 
 #include    "http.h"
 
+/*********************************** Locals ***********************************/
+
+static int queueSlab = -1;              /* Slab pool for queues */
+
 /********************************** Forwards **********************************/
 
 static void manageQueue(HttpQueue *q, int flags);
@@ -17,7 +21,10 @@ HttpQueue *httpCreateQueueHead(HttpConn *conn, cchar *name)
 {
     HttpQueue   *q;
 
-    if ((q = mprAllocObj(HttpQueue, manageQueue)) == 0) {
+    if (queueSlab < 0) {
+        queueSlab = mprCreateSlab("HttpQueue", sizeof(HttpQueue), MPR_ALLOC_MANAGER);
+    }
+    if ((q = mprAllocSlabObj(queueSlab, HttpQueue, manageQueue)) == 0) {
         return 0;
     }
     httpInitQueue(conn, q, name);
@@ -30,7 +37,10 @@ HttpQueue *httpCreateQueue(HttpConn *conn, HttpStage *stage, int dir, HttpQueue
 {
     HttpQueue   *q;
 
-    if ((q = mprAllocObj(HttpQueue, manageQueue)) == 0) {
+    if (queueSlab < 0) {
+        queueSlab = mprCreateSlab("HttpQueue", sizeof(HttpQueue), MPR_ALLOC_MANAGER);
+    }
+    if ((q = mprAllocSlabObj(queueSlab, HttpQueue, manageQueue)) == 0) {
         return 0;
     }
     q->conn = conn;
@@ -240,6 +250,26 @@ ssize httpGetQueueRoom(HttpQueue *q)
 }
 
 
+int httpGetQueueVec(HttpQueue *q, MprIOVec *iovec, int max)
+{
+    HttpPacket  *packet;
+    ssize       len;
+    int         count;
+
+    for (count = 0, packet = q->first; packet && count < max; packet = packet->next) {
+        if (packet->content == 0 || packet->esize || (packet->flags & HTTP_PACKET_HEADER)) {
+            continue;
+        }
+        if ((len = httpGetPacketLength(packet)) > 0) {
+            iovec[count].start = mprGetBufStart(packet->content);
+            iovec[count].len = len;
+            count++;
+        }
+    }
+    return count;
+}
+
+
 void httpInitSchedulerQueue(HttpQueue *q)
 {
     q->scheduleNext = q;
@@ -343,7 +373,7 @@ ssize httpRead(HttpConn *conn, char *buf, ssize size)
         mprAssert(q->count >= 0);
         nbytes += len;
         if (mprGetBufLength(content) == 0) {
-            httpGetPacket(q);
+            httpRecyclePacket(conn, httpGetPacket(q));
         }
     }
     mprAssert(q->count >= 0);
@@ -538,7 +568,13 @@ ssize httpWriteBlock(HttpQueue *q, cchar *buf, ssize size)
         }
         if (packet == 0 || mprGetBufSpace(packet->content) == 0) {
             packetSize = (tx->chunkSize > 0) ? tx->chunkSize : q->packetSize;
-            if ((packet = httpCreateDataPacket(packetSize)) == 0) {
+            if (packetSize >= HTTP_BUFSIZE) {
+                /* Pool packets are smaller than the packet size limit. Such packets are recycled once written. */
+                packet = httpCreatePoolPacket(conn, HTTP_PACKET_DATA);
+            } else {
+                packet = httpCreateDataPacket(packetSize);
+            }
+            if (packet == 0) {
                 return MPR_ERR_MEMORY;
             }
             httpPutForService(q, packet, HTTP_DELAY_SERVICE);
@@ -219,6 +219,7 @@ static void manageRoute(HttpRoute *route, int flags)
         mprMark(route->ssl);
         mprMark(route->limits);
         mprMark(route->mimeTypes);
+        mprMark(route->headerTemplates);
         httpManageTrace(&route->trace[0], flags);
         httpManageTrace(&route->trace[1], flags);
         mprMark(route->log);
@@ -386,7 +387,10 @@ void httpRouteRequest(HttpConn *conn)
         mprLog(4, "Select route \"%s\" target \"%s\"", route->name, route->targetRule);
     }
     rx->route = route;
-    conn->limits = route->limits;
+    if (conn->limits != route->limits) {
+        conn->limits = route->limits;
+        httpScheduleConnTimeout(conn);
+    }
 
     conn->trace[0] = route->trace[0];
     conn->trace[1] = route->trace[1];
@@ -429,7 +433,7 @@ int httpMatchRoute(HttpConn *conn, HttpRoute *route)
         if (*pathInfo == '\0') {
             pathInfo = "/";
         }
-        rx->pathInfo = sclone(pathInfo);
+        rx->pathInfo = mprArenaClone(conn->arena, pathInfo);
         rx->scriptName = route->prefix;
     }
     if ((rc = matchRequestUri(conn, route)) == HTTP_ROUTE_OK) {
@@ -7,17 +7,111 @@
 
 #include    "http.h"
 
+#if BIT_HTTP_SIMD && defined(__AVX2__)
+    #include    <immintrin.h>
+    #define HTTP_SCAN_AVX2 1
+    #define HTTP_SCAN_SSE2 1
+#elif BIT_HTTP_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include    <emmintrin.h>
+    #define HTTP_SCAN_SSE2 1
+#endif
+
+/*********************************** Locals ***********************************/
+/*
+    Well-known header names indexed by HTTP_HDR_ id
+ */
+typedef struct HttpHeaderName {
+    cchar   *name;                          /**< Canonical header name */
+    int     length;                         /**< Length of the name */
+} HttpHeaderName;
+
+static HttpHeaderName headerNames[HTTP_HDR_MAX] = {
+    { "Accept", 6 },
+    { "Accept-Charset", 14 },
+    { "Accept-Encoding", 15 },
+    { "Accept-Language", 15 },
+    { "Authorization", 13 },
+    { "Cache-Control", 13 },
+    { "Connection", 10 },
+    { "Content-Encoding", 16 },
+    { "Content-Length", 14 },
+    { "Content-Range", 13 },
+    { "Content-Type", 12 },
+    { "Cookie", 6 },
+    { "Date", 4 },
+    { "ETag", 4 },
+    { "Expect", 6 },
+    { "Host", 4 },
+    { "If-Match", 8 },
+    { "If-Modified-Since", 17 },
+    { "If-None-Match", 13 },
+    { "If-Range", 8 },
+    { "If-Unmodified-Since", 19 },
+    { "Keep-Alive", 10 },
+    { "Last-Modified", 13 },
+    { "Location", 8 },
+    { "Origin", 6 },
+    { "Pragma", 6 },
+    { "Range", 5 },
+    { "Referer", 7 },
+    { "Sec-WebSocket-Accept", 20 },
+    { "Sec-WebSocket-Key", 17 },
+    { "Sec-WebSocket-Protocol", 22 },
+    { "Sec-WebSocket-Version", 21 },
+    { "Server", 6 },
+    { "Set-Cookie", 10 },
+    { "Transfer-Encoding", 17 },
+    { "Upgrade", 7 },
+    { "User-Agent", 10 },
+    { "Vary", 4 },
+    { "WWW-Authenticate", 16 },
+    { "X-Chunk-Size", 12 },
+    { "X-Forwarded-For", 15 },
+    { "X-HTTP-Method-Override", 22 },
+    { "X-Requested-With", 16 }
+};
+
+/*
+    Perfect hash of well-known header names. Each slot holds the HTTP_HDR_ id plus one, or zero if empty. 
+    The slot for a name is HTTP_HEADER_HASH(name) which uses the name length and the lower case first and last 
+    characters. There are no collisions, so one name comparison confirms a match. The multipliers and table were 
+    generated by a search over headerNames. When adding a well-known header, regenerate them so that all names 
+    hash to distinct slots. 
+ */
+#define HTTP_HEADER_HASH(key, len) \
+    (((len) * 18 + tolower((uchar) (key)[0]) + tolower((uchar) (key)[(len) - 1]) * 15) & (HTTP_HEADER_SLOTS - 1))
+#define HTTP_HEADER_SLOTS       128
+#define HTTP_HEADER_MIN         4           /* Shortest well-known header name */
+#define HTTP_HEADER_MAX         22          /* Longest well-known header name */
+
+static const uchar headerSlots[HTTP_HEADER_SLOTS] = {
+     0,  0, 39,  0,  0,  0, 18,  0,  0,  7, 22, 26,  8, 33,  0,  0,
+     0, 17, 34,  0,  0,  0,  0, 13,  0,  1,  0,  0,  0, 15, 28,  0,
+     0,  6,  0,  0,  0,  0, 11, 29,  0,  2, 21,  0,  0,  0,  0, 35,
+    43,  0, 23,  0, 41,  0, 14, 27, 10,  0, 12, 40, 30,  5,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 25,  0,  0,
+     0,  0,  0, 31,  0, 38,  0,  0,  0,  0,  4,  0,  0,  0, 36, 32,
+     0,  0,  0,  0, 20,  0,  0,  0,  0,  0,  0, 19,  0,  0, 24, 42,
+     0,  0,  0,  0,  0, 37,  0,  9,  3,  0,  0,  0, 16,  0,  0,  0
+};
+
 /***************************** Forward Declarations ***************************/
 
 static void addMatchEtag(HttpConn *conn, char *etag);
-static char *getToken(HttpConn *conn, cchar *delim);
+static char *cloneLine(HttpConn *conn, cchar *line, ssize len);
+static int firstBit(uint mask);
+static char *getToken(char **cursor);
+static bool indexHeader(HttpConn *conn, int line, ssize offset, ssize colon);
 static void manageRange(HttpRange *range, int flags);
 static void manageRx(HttpRx *rx, int flags);
-static bool parseHeaders(HttpConn *conn, HttpPacket *packet);
+static char *keepValue(HttpConn *conn, char *value);
+static bool parseHeader(HttpConn *conn, char *key, ssize klen, char *value);
+static bool parseHeaderLine(HttpConn *conn, char *line, ssize len, char *colon);
+static bool parseHeaders(HttpConn *conn, cchar *input, ssize len);
 static bool parseIncoming(HttpConn *conn, HttpPacket *packet);
 static bool parseRange(HttpConn *conn, char *value);
-static bool parseRequestLine(HttpConn *conn, HttpPacket *packet);
-static bool parseResponseLine(HttpConn *conn, HttpPacket *packet);
+static bool parseRequestLine(HttpConn *conn, char *line, ssize len);
+static bool parseResponseLine(HttpConn *conn, char *line, ssize len);
 static bool processCompletion(HttpConn *conn);
 static bool processContent(HttpConn *conn, HttpPacket *packet);
 static void parseMethod(HttpConn *conn);
@@ -25,6 +119,8 @@ static bool processParsed(HttpConn *conn);
 static bool processReady(HttpConn *conn);
 static bool processRunning(HttpConn *conn);
 static void routeRequest(HttpConn *conn);
+static char *scanBytes(cchar *cp, cchar *end, cchar **colon);
+static bool scanHeaders(HttpConn *conn, HttpPacket *packet);
 
 /*********************************** Code *************************************/
 
@@ -42,7 +138,7 @@ HttpRx *httpCreateRx(HttpConn *conn)
     rx->pathInfo = sclone("/");
     rx->scriptName = mprEmptyString();
     rx->needInputPipeline = !conn->endpoint;
-    rx->headers = mprCreateHash(HTTP_SMALL_HASH_SIZE, MPR_HASH_CASELESS);
+    rx->headers = mprCreateHash(HTTP_SMALL_HASH_SIZE, MPR_HASH_CASELESS | MPR_HASH_STATIC_ALL);
     rx->chunkState = HTTP_CHUNK_UNCHUNKED;
     rx->traceLevel = -1;
     return rx;
@@ -61,28 +157,16 @@ static void manageRx(HttpRx *rx, int flags)
         mprMark(rx->route);
         mprMark(rx->etags);
         mprMark(rx->headerPacket);
+        mprMark(rx->headerCopies);
         mprMark(rx->headers);
         mprMark(rx->inputPipeline);
         mprMark(rx->parsedUri);
         mprMark(rx->requestData);
         mprMark(rx->statusMessage);
-        mprMark(rx->accept);
-        mprMark(rx->acceptCharset);
-        mprMark(rx->acceptEncoding);
-        mprMark(rx->acceptLanguage);
-        mprMark(rx->cookie);
-        mprMark(rx->connection);
-        mprMark(rx->contentLength);
-        mprMark(rx->hostHeader);
-        mprMark(rx->pragma);
-        mprMark(rx->mimeType);
         mprMark(rx->originalMethod);
         mprMark(rx->originalUri);
-        mprMark(rx->redirect);
-        mprMark(rx->referrer);
         mprMark(rx->securityToken);
         mprMark(rx->session);
-        mprMark(rx->userAgent);
         mprMark(rx->params);
         mprMark(rx->svars);
         mprMark(rx->inputRange);
@@ -94,11 +178,6 @@ static void manageRx(HttpRx *rx, int flags)
         mprMark(rx->target);
 
 #if WSS
-        mprMark(rx->upgrade);
-        mprMark(rx->sockKey);
-        mprMark(rx->sockProtocol);
-        mprMark(rx->sockVersion);
-        mprMark(rx->origin);
 #endif
 
     } else if (flags & MPR_MANAGE_FREE) {
@@ -135,6 +214,7 @@ void httpPump(HttpConn *conn, HttpPacket *packet)
         switch (conn->state) {
         case HTTP_STATE_BEGIN:
         case HTTP_STATE_CONNECTED:
+        case HTTP_STATE_FIRST:
             conn->canProceed = parseIncoming(conn, packet);
             break;
 
@@ -165,6 +245,70 @@ void httpPump(HttpConn *conn, HttpPacket *packet)
         packet = conn->input;
     }
     conn->inHttpProcess = 0;
+    if (conn->heldOutput) {
+        /* Write responses held for pipelined requests now there is no more input to process */
+        httpWriteHeldOutput(conn);
+    }
+}
+
+
+/*
+    Parse a message held in memory without I/O, host matching or routing. See http.h for details.
+ */
+ssize httpParseMessage(HttpConn *conn, HttpPacket *packet)
+{
+    HttpRx      *rx;
+    HttpQueue   *q;
+    ssize       nbytes, total, result;
+
+    mprAssert(conn);
+    mprAssert(packet);
+
+    if (conn->rx) {
+        conn->rx->conn = 0;
+        conn->tx->conn = 0;
+        conn->rx = 0;
+        conn->tx = 0;
+    }
+    if (conn->endpoint) {
+        httpPrepServerConn(conn);
+        conn->rx = httpCreateRx(conn);
+        conn->tx = httpCreateTx(conn, NULL);
+    } else {
+        httpPrepClientConn(conn, 0);
+    }
+    conn->input = packet;
+    rx = conn->rx;
+    result = MPR_ERR_NOT_READY;
+
+    if (scanHeaders(conn, packet)) {
+        httpSetState(conn, HTTP_STATE_PARSED);
+        /*
+            Decode body data as analyseContent would, but consume it rather than passing it to the Rx pipeline
+         */
+        q = conn->tx->queue[HTTP_QUEUE_RX];
+        for (total = 0; !rx->eof && !conn->error && httpGetPacketLength(packet) > 0; total += nbytes) {
+            if ((nbytes = httpFilterChunkData(q, packet)) <= 0) {
+                break;
+            }
+            rx->remainingContent -= nbytes;
+            rx->bytesRead += nbytes;
+            mprAdjustBufStart(packet->content, nbytes);
+            if (rx->remainingContent == 0 && !(rx->flags & HTTP_CHUNKED)) {
+                rx->eof = 1;
+            }
+        }
+        if (rx->eof) {
+            result = total;
+        }
+    }
+    if (conn->error) {
+        result = MPR_ERR_BAD_FORMAT;
+    }
+    if (conn->endpoint) {
+        httpValidateLimits(conn->endpoint, HTTP_VALIDATE_CLOSE_REQUEST, conn);
+    }
+    return result;
 }
 
 
@@ -175,8 +319,6 @@ void httpPump(HttpConn *conn, HttpPacket *packet)
 static bool parseIncoming(HttpConn *conn, HttpPacket *packet)
 {
     HttpRx      *rx;
-    ssize       len;
-    char        *start, *end;
 
     if (packet == NULL) {
         return 0;
@@ -189,49 +331,11 @@ static bool parseIncoming(HttpConn *conn, HttpPacket *packet)
         conn->rx = httpCreateRx(conn);
         conn->tx = httpCreateTx(conn, NULL);
     }
-    rx = conn->rx;
-    if ((len = httpGetPacketLength(packet)) == 0) {
+    if (!scanHeaders(conn, packet)) {
         return 0;
     }
-    start = mprGetBufStart(packet->content);
-
-#if FUTURE
-    while (*start == '\r' || *start == '\n') {
-        mprGetCharFromBuf(packet->content);
-        start = mprGetBufStart(packet->content);
-    }
-#endif
-
-    /*
-        Don't start processing until all the headers have been received (delimited by two blank lines)
-        MOB - should be tolerant and allow '\n\n'
-     */
-    if ((end = sncontains(start, "\r\n\r\n", len)) == 0) {
-        if (len >= conn->limits->headerSize) {
-            httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE, 
-                "Header too big. Length %d vs limit %d", len, conn->limits->headerSize);
-        }
-        return 0;
-    }
-    len = end - start;
-    mprAddNullToBuf(packet->content);
+    rx = conn->rx;
 
-    if (len >= conn->limits->headerSize) {
-        httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE, 
-            "Header too big. Length %d vs limit %d", len, conn->limits->headerSize);
-        return 0;
-    }
-    if (conn->endpoint) {
-        /* This will set conn->error if it does not validate - keep going to generate a response */
-        if (!parseRequestLine(conn, packet)) {
-            return 0;
-        }
-    } else if (!parseResponseLine(conn, packet)) {
-        return 0;
-    }
-    if (!parseHeaders(conn, packet)) {
-        return 0;
-    }
     if (conn->endpoint) {
         httpMatchHost(conn);
         if (httpSetUri(conn, rx->uri, "") < 0 || rx->pathInfo[0] != '/') {
@@ -243,7 +347,7 @@ static bool parseIncoming(HttpConn *conn, HttpPacket *packet)
         rx->parsedUri->port = conn->sock->listenSock->port;
 
         //  MOB - refactor what conn->host is set to
-        rx->parsedUri->host = rx->hostHeader ? rx->hostHeader : conn->host->name;
+        rx->parsedUri->host = rx->hostHeader ? mprArenaClone(conn->arena, rx->hostHeader) : conn->host->name;
         if (!rx->parsedUri->host) {
            rx->parsedUri->host = (conn->host->name[0] == '*') ? conn->sock->acceptIp : conn->host->name;
         }
@@ -259,6 +363,117 @@ static bool parseIncoming(HttpConn *conn, HttpPacket *packet)
 }
 
 
+/*  
+    Scan and parse the message header. Return true if the complete header has been received and parsed. Header lines 
+    are scanned as they arrive and the scan position is saved in the Rx object so that a slowly received header is not 
+    rescanned from the start on each read. The first line is parsed as soon as it is received. The offset of each 
+    following line and of its first colon are recorded in conn->headerIndex as the line is scanned, so the lines can be
+    parsed without rescanning once the blank line ending the header has been received. Lines may be terminated by 
+    "\r\n" or by a bare "\n". The buffer start is not advanced until the complete header has been received so the saved
+    offsets remain valid if the buffer is grown or compacted.
+ */
+static bool scanHeaders(HttpConn *conn, HttpPacket *packet)
+{
+    HttpRx      *rx;
+    MprBuf      *content;
+    cchar       *colon;
+    char        *start, *end, *line, *nl;
+    ssize       len;
+
+    rx = conn->rx;
+    if (httpGetPacketLength(packet) == 0) {
+        return 0;
+    }
+    content = packet->content;
+    start = mprGetBufStart(content);
+    end = mprGetBufEnd(content);
+
+    for (;;) {
+        /* A colon found in a partial line is retained so the scan can resume where it stopped */
+        colon = rx->lineColon ? &start[rx->lineColon] : 0;
+        if ((nl = httpScanHeader(&start[rx->headerScan], end, &colon)) == 0) {
+            rx->headerScan = end - start;
+            rx->lineColon = colon ? colon - start : 0;
+            if (rx->headerScan >= conn->limits->headerSize) {
+                httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE, 
+                    "Header too big. Length %d vs limit %d", rx->headerScan, conn->limits->headerSize);
+            }
+            return 0;
+        }
+        if (*nl != '\n') {
+            httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad header. Illegal character 0x%x", *nl & 0xFF);
+            return 0;
+        }
+        line = &start[rx->lineStart];
+        len = nl - line;
+        if (len > 0 && line[len - 1] == '\r') {
+            len--;
+        }
+        if (line - start >= conn->limits->headerSize) {
+            httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE, 
+                "Header too big. Length %d vs limit %d", line - start, conn->limits->headerSize);
+            return 0;
+        }
+        rx->headerScan = rx->lineStart = nl - start + 1;
+        rx->lineColon = 0;
+        if (len == 0) {
+            if (rx->headerLines > 0) {
+                break;
+            }
+            /* Ignore empty lines preceding the first line */
+            continue;
+        }
+        if (rx->headerLines++ == 0) {
+            if (conn->endpoint) {
+                /* This will set conn->error if it does not validate - keep going to generate a response */
+                if (!parseRequestLine(conn, line, len)) {
+                    return 0;
+                }
+            } else if (!parseResponseLine(conn, line, len)) {
+                return 0;
+            }
+            rx->keepAlive = (conn->http10) ? 0 : 1;
+            rx->headerStart = rx->lineStart;
+
+        } else if ((rx->headerLines - 1) > conn->limits->headerMax) {
+            httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Too many headers");
+            return 0;
+
+        } else if (!indexHeader(conn, rx->headerLines - 2, line - start, colon ? colon - start : 0)) {
+            return 0;
+        }
+    }
+    /*
+        The complete header has been received. If tracing the header, do the entire header including the first line.
+     */
+    if (rx->traceLevel >= 0) {
+        httpTraceContent(conn, HTTP_TRACE_RX, HTTP_TRACE_HEADER, packet, nl - start + 1, 0);
+    }
+    if (!conn->error && !parseHeaders(conn, start, line - start)) {
+        return 0;
+    }
+    /*
+        Don't stream input if a form or upload. NOTE: Upload needs the Files[] collection.
+     */
+    rx->streamInput = !(rx->form || rx->upload);
+    rx->eof = (rx->remainingContent == 0);
+    if (!rx->keepAlive) {
+        conn->keepAliveCount = 0;
+    }
+    mprAdjustBufStart(content, line - start);
+    if (!(rx->flags & HTTP_CHUNKED)) {
+        /*  
+            Step over the blank line after the headers. 
+            Don't do this if chunked so chunking can parse a single chunk delimiter of "\r\nSIZE ...\r\n". If the header
+            ended with a bare "\n", the chunk filter accepts "\nSIZE ...".
+         */
+        mprAdjustBufStart(content, nl - line + 1);
+    }
+    mprAddNullToBuf(content);
+    return 1;
+}
+
+
 static void mapMethod(HttpConn *conn)
 {
     HttpRx      *rx;
@@ -292,43 +507,32 @@ static void routeRequest(HttpConn *conn)
 
 
 /*
-    Only called by parseRequestLine
+    Only called by parseRequestLine. The line is a null terminated copy of the request line.
  */
-static void traceRequest(HttpConn *conn, HttpPacket *packet)
+static void traceRequest(HttpConn *conn, cchar *line)
 {
-    MprBuf  *content;
-    cchar   *endp, *ext, *cp;
-    int     len, level;
+    cchar   *ext, *cp;
+    int     level;
 
-    content = packet->content;
     ext = 0;
     /*
         Find the Uri extension:   "GET /path.ext HTTP/1.1"
      */
-    if ((cp = schr(content->start, ' ')) != 0) {
+    if ((cp = schr(line, ' ')) != 0) {
         if ((cp = schr(++cp, ' ')) != 0) {
-            for (ext = --cp; ext > content->start && *ext != '.'; ext--) ;
+            for (ext = --cp; ext > line && *ext != '.'; ext--) ;
             ext = (*ext == '.') ? snclone(&ext[1], cp - ext) : 0;
             conn->tx->ext = ext;
         }
     }
     /*
-        If tracing header, do entire header including first line
+        If tracing header, the entire header including the first line is traced once it has been received
      */
     if ((conn->rx->traceLevel = httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_HEADER, ext)) >= 0) {
         mprLog(4, "New request from %s:%d to %s:%d", conn->ip, conn->port, conn->sock->acceptIp, conn->sock->acceptPort);
-        endp = strstr((char*) content->start, "\r\n\r\n");
-        len = (endp) ? (int) (endp - mprGetBufStart(content) + 4) : 0;
-        httpTraceContent(conn, HTTP_TRACE_RX, HTTP_TRACE_HEADER, packet, len, 0);
 
     } else if ((level = httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_FIRST, ext)) >= 0) {
-        endp = strstr((char*) content->start, "\r\n");
-        len = (endp) ? (int) (endp - mprGetBufStart(content) + 2) : 0;
-        if (len > 0) {
-            content->start[len - 2] = '\0';
-            mprLog(level, "%s", content->start);
-            content->start[len - 2] = '\r';
-        }
+        mprLog(level, "%s", line);
     }
     httpValidateLimits(conn->endpoint, HTTP_VALIDATE_OPEN_REQUEST, conn);
 }
@@ -394,26 +598,29 @@ static void parseMethod(HttpConn *conn)
 
 
 /*  
-    Parse the first line of a http request. Return true if the first line parsed. This is only called once all the headers
-    have been read and buffered. Requests look like: METHOD URL HTTP/1.X.
+    Parse the first line of a http request. Return true if the first line parsed. This is called as soon as the first
+    line has been received. Requests look like: METHOD URL HTTP/1.X.
  */
-static bool parseRequestLine(HttpConn *conn, HttpPacket *packet)
+static bool parseRequestLine(HttpConn *conn, char *line, ssize len)
 {
     HttpRx      *rx;
-    char        *uri, *protocol;
-    ssize       len;
+    char        *uri, *protocol, *cursor;
 
     rx = conn->rx;
 #if BIT_DEBUG
     conn->startTime = conn->http->now;
     conn->startTicks = mprGetTicks();
 #endif
-    traceRequest(conn, packet);
+    if ((cursor = cloneLine(conn, line, len)) == 0) {
+        httpMemoryError(conn);
+        return 0;
+    }
+    traceRequest(conn, cursor);
 
-    rx->originalMethod = rx->method = supper(getToken(conn, 0));
+    rx->originalMethod = rx->method = supper(getToken(&cursor));
     parseMethod(conn);
 
-    uri = getToken(conn, 0);
+    uri = getToken(&cursor);
     len = slen(uri);
     if (*uri == '\0') {
         httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad HTTP request. Empty URI");
@@ -423,7 +630,7 @@ static bool parseRequestLine(HttpConn *conn, HttpPacket *packet)
             "Bad request. URI too long. Length %d vs limit %d", len, conn->limits->uriSize);
         return 0;
     }
-    protocol = conn->protocol = supper(getToken(conn, "\r\n"));
+    protocol = conn->protocol = supper(cursor);
     if (strcmp(protocol, "HTTP/1.0") == 0) {
         if (rx->flags & (HTTP_POST|HTTP_PUT)) {
             rx->remainingContent = MAXINT;
@@ -438,38 +645,36 @@ static bool parseRequestLine(HttpConn *conn, HttpPacket *packet)
         httpError(conn, HTTP_ABORT | HTTP_CODE_NOT_ACCEPTABLE, "Unsupported HTTP protocol");
         return 0;
     }
-    rx->originalUri = rx->uri = sclone(uri);
+    rx->originalUri = rx->uri = mprArenaClone(conn->arena, uri);
     httpSetState(conn, HTTP_STATE_FIRST);
     return 1;
 }
 
 
 /*  
-    Parse the first line of a http response. Return true if the first line parsed. This is only called once all the headers
-    have been read and buffered. Response status lines look like: HTTP/1.X CODE Message
+    Parse the first line of a http response. Return true if the first line parsed. This is called as soon as the first
+    line has been received. Response status lines look like: HTTP/1.X CODE Message
  */
-static bool parseResponseLine(HttpConn *conn, HttpPacket *packet)
+static bool parseResponseLine(HttpConn *conn, char *line, ssize len)
 {
     HttpRx      *rx;
     HttpTx      *tx;
-    MprBuf      *content;
-    cchar       *endp;
-    char        *protocol, *status;
-    ssize       len;
-    int         level, traced;
+    char        *protocol, *status, *cursor;
+    int         level;
 
     rx = conn->rx;
     tx = conn->tx;
-    traced = 0;
 
-    if (httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_HEADER, tx->ext) >= 0) {
-        content = packet->content;
-        endp = strstr((char*) content->start, "\r\n\r\n");
-        len = (endp) ? (int) (endp - mprGetBufStart(content) + 4) : 0;
-        httpTraceContent(conn, HTTP_TRACE_RX, HTTP_TRACE_HEADER, packet, len, 0);
-        traced = 1;
+    if ((cursor = cloneLine(conn, line, len)) == 0) {
+        httpMemoryError(conn);
+        return 0;
     }
-    protocol = conn->protocol = supper(getToken(conn, 0));
+    /*
+        If tracing header, the entire header including the first line is traced once it has been received
+     */
+    rx->traceLevel = httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_HEADER, tx->ext);
+
+    protocol = conn->protocol = supper(getToken(&cursor));
     if (strcmp(protocol, "HTTP/1.0") == 0) {
         conn->http10 = 1;
         if (!scaselessmatch(tx->method, "HEAD")) {
@@ -479,13 +684,13 @@ static bool parseResponseLine(HttpConn *conn, HttpPacket *packet)
         httpError(conn, HTTP_ABORT | HTTP_CODE_NOT_ACCEPTABLE, "Unsupported HTTP protocol");
         return 0;
     }
-    status = getToken(conn, 0);
+    status = getToken(&cursor);
     if (*status == '\0') {
         httpError(conn, HTTP_ABORT | HTTP_CODE_NOT_ACCEPTABLE, "Bad response status code");
         return 0;
     }
     rx->status = atoi(status);
-    rx->statusMessage = sclone(getToken(conn, "\r\n"));
+    rx->statusMessage = sclone(cursor);
 
     len = slen(rx->statusMessage);
     if (len >= conn->limits->uriSize) {
@@ -493,369 +698,396 @@ static bool parseResponseLine(HttpConn *conn, HttpPacket *packet)
             "Bad response. Status message too long. Length %d vs limit %d", len, conn->limits->uriSize);
         return 0;
     }
-    if (!traced && (level = httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_FIRST, tx->ext)) >= 0) {
+    if (rx->traceLevel < 0 && (level = httpShouldTrace(conn, HTTP_TRACE_RX, HTTP_TRACE_FIRST, tx->ext)) >= 0) {
         mprLog(level, "%s %d %s", protocol, rx->status, rx->statusMessage);
     }
     return 1;
 }
 
 
+/*
+    Record the input offset of a header line and of its first colon. The colon offset is zero if the line has no colon.
+    The index is retained by the connection and reused for subsequent requests.
+ */
+static bool indexHeader(HttpConn *conn, int line, ssize offset, ssize colon)
+{
+    int     *index, max;
+
+    if (line >= conn->headerIndexMax) {
+        max = conn->headerIndexMax ? conn->headerIndexMax * 2 : 16;
+        if ((index = mprRealloc(conn->headerIndex, max * 2 * sizeof(int))) == 0) {
+            httpMemoryError(conn);
+            return 0;
+        }
+        conn->headerIndex = index;
+        conn->headerIndexMax = max;
+    }
+    conn->headerIndex[line * 2] = (int) offset;
+    conn->headerIndex[line * 2 + 1] = (int) colon;
+    return 1;
+}
+
+
+/*
+    Parse the header lines once they have all been received. The input is the start of the input buffer and len is
+    the offset of the blank line ending the header. The lines are copied once into the header packet which is retained
+    by the Rx object for the life of the request. Each line is then parsed using the line and colon offsets recorded 
+    by scanHeaders. Header keys and values reference the packet directly. Return true if the headers parsed.
+ */
+static bool parseHeaders(HttpConn *conn, cchar *input, ssize len)
+{
+    HttpRx      *rx;
+    MprBuf      *content;
+    char        *headers, *line, *colon;
+    ssize       offset, next, llen;
+    int         i, count;
+
+    rx = conn->rx;
+    if ((rx->headerPacket = httpCreateDataPacket(len - rx->headerStart + 1)) == 0) {
+        httpMemoryError(conn);
+        return 0;
+    }
+    content = rx->headerPacket->content;
+    mprPutBlockToBuf(content, &input[rx->headerStart], len - rx->headerStart);
+    mprAddNullToBuf(content);
+    headers = mprGetBufStart(content);
+
+    count = rx->headerLines - 1;
+    for (i = 0; i < count && !conn->error; i++) {
+        offset = conn->headerIndex[i * 2];
+        next = (i + 1) < count ? conn->headerIndex[(i + 1) * 2] : len;
+        line = &headers[offset - rx->headerStart];
+        /* Lines end before the next line with "\n" or "\r\n" */
+        llen = next - offset - 1;
+        if (llen > 0 && line[llen - 1] == '\r') {
+            llen--;
+        }
+        colon = conn->headerIndex[i * 2 + 1] ? &headers[conn->headerIndex[i * 2 + 1] - rx->headerStart] : 0;
+        if (!parseHeaderLine(conn, line, llen, colon)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*  
+    Parse a single header line of the given length. The colon references the first colon in the line, if any.
+    The key and value are null terminated in-place in the header packet. Return true if the header parsed.
+ */
+static bool parseHeaderLine(HttpConn *conn, char *line, ssize len, char *colon)
+{
+    char    *key, *value;
+
+    for (key = line; *key == ' ' || *key == '\t'; key++) ;
+    if (colon == 0 || colon <= key) {
+        httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad header format");
+        return 0;
+    }
+    line[len] = '\0';
+    *colon = '\0';
+    for (value = colon + 1; *value == ' ' || *value == '\t'; value++) ;
+    return parseHeader(conn, key, colon - key, value);
+}
+
+
 /*  
-    Parse the request headers. Return true if the header parsed.
+    Parse one request header. The key and value reference the header packet and are stored without copying. 
+    They must not be modified as the headers also reference them. Well-known headers are stored by id in 
+    rx->knownHeaders and other headers are stored in the rx->headers hash. Return true if the header parsed.
  */
-static bool parseHeaders(HttpConn *conn, HttpPacket *packet)
+static bool parseHeader(HttpConn *conn, char *key, ssize klen, char *value)
 {
     HttpRx      *rx;
     HttpTx      *tx;
-    HttpLimits  *limits;
-    MprBuf      *content;
-    char        *cp, *key, *value, *tok, *hvalue;
+    char        *cp, *tok, *hvalue;
     cchar       *oldValue;
-    int         count, keepAlive;
+    int         id;
 
     rx = conn->rx;
     tx = conn->tx;
-    content = packet->content;
-    conn->rx->headerPacket = packet;
-    limits = conn->limits;
-    keepAlive = (conn->http10) ? 0 : 1;
 
-    for (count = 0; content->start[0] != '\r' && !conn->error; count++) {
-        if (count >= limits->headerMax) {
-            httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Too many headers");
-            return 0;
-        }
-        if ((key = getToken(conn, ":")) == 0 || *key == '\0') {
-            httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad header format");
-            return 0;
-        }
-        //  MOB - should be tolerant and allow '\n'
-        value = getToken(conn, "\r\n");
-        while (isspace((uchar) *value)) {
-            value++;
-        }
-        LOG(8, "Key %s, value %s", key, value);
-        if (strspn(key, "%<>/\\") > 0) {
-            httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad header key value");
-            return 0;
-        }
+    LOG(8, "Key %s, value %s", key, value);
+    if (strchr("%<>/\\", *key)) {
+        httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad header key value");
+        return 0;
+    }
+    if ((id = httpGetHeaderId(key, klen)) < 0) {
         if ((oldValue = mprLookupKey(rx->headers, key)) != 0) {
-            hvalue = sfmt("%s, %s", oldValue, value);
-        } else {
-            hvalue = sclone(value);
+            value = keepValue(conn, mprArenaFmt(conn->arena, "%s, %s", oldValue, value));
         }
-        mprAddKey(rx->headers, key, hvalue);
+        mprAddKey(rx->headers, key, value);
+        return 1;
+    }
+    if ((oldValue = rx->knownHeaders[id]) != 0) {
+        hvalue = keepValue(conn, mprArenaFmt(conn->arena, "%s, %s", oldValue, value));
+    } else {
+        hvalue = value;
+    }
+    rx->knownHeaders[id] = hvalue;
 
-        switch (tolower((uchar) key[0])) {
-        case 'a':
-            if (strcasecmp(key, "authorization") == 0) {
-                value = sclone(value);
-                conn->authType = slower(stok(value, " \t", &tok));
-                rx->authDetails = sclone(tok);
+    switch (id) {
+    case HTTP_HDR_ACCEPT:
+        rx->accept = value;
+        break;
 
-            } else if (strcasecmp(key, "accept-charset") == 0) {
-                rx->acceptCharset = sclone(value);
+    case HTTP_HDR_ACCEPT_CHARSET:
+        rx->acceptCharset = value;
+        break;
 
-            } else if (strcasecmp(key, "accept") == 0) {
-                rx->accept = sclone(value);
+    case HTTP_HDR_ACCEPT_ENCODING:
+        rx->acceptEncoding = value;
+        break;
 
-            } else if (strcasecmp(key, "accept-encoding") == 0) {
-                rx->acceptEncoding = sclone(value);
+    case HTTP_HDR_ACCEPT_LANGUAGE:
+        rx->acceptLanguage = value;
+        break;
 
-            } else if (strcasecmp(key, "accept-language") == 0) {
-                rx->acceptLanguage = sclone(value);
-            }
-            break;
+    case HTTP_HDR_AUTHORIZATION:
+    case HTTP_HDR_WWW_AUTHENTICATE:
+        for (cp = value; *cp && !isspace((uchar) *cp); cp++) ;
+        conn->authType = slower(snclone(value, cp - value));
+        for (; isspace((uchar) *cp); cp++) ;
+        rx->authDetails = cp;
+        break;
 
-        case 'c':
-            if (strcasecmp(key, "connection") == 0) {
-                rx->connection = sclone(value);
-                if (scaselesscmp(value, "KEEP-ALIVE") == 0) {
-                    keepAlive = 1;
-                } else if (scaselesscmp(value, "CLOSE") == 0) {
-                    /*  Not really required, but set to 0 to be sure */
-                    conn->keepAliveCount = 0;
+    case HTTP_HDR_CONNECTION:
+        rx->connection = value;
+        if (scaselesscmp(value, "KEEP-ALIVE") == 0) {
+            rx->keepAlive = 1;
+        } else if (scaselesscmp(value, "CLOSE") == 0) {
+            /*  Not really required, but set to 0 to be sure */
+            conn->keepAliveCount = 0;
 #if WSS
-                } else if (scaselesscmp(value, "upgrade") == 0) {
+        } else if (scaselesscmp(value, "upgrade") == 0) {
 #endif
-                }
-
-            } else if (strcasecmp(key, "content-length") == 0) {
-                if (rx->length >= 0) {
-                    httpError(conn, HTTP_CLOSE | HTTP_CODE_BAD_REQUEST, "Mulitple content length headers");
-                    break;
-                }
-                rx->length = stoi(value);
-                if (rx->length < 0) {
-                    httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad content length");
-                    return 0;
-                }
-                if (rx->length >= conn->limits->receiveBodySize) {
-                    httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE,
-                        "Request content length %,Ld bytes is too big. Limit %,Ld", 
-                        rx->length, conn->limits->receiveBodySize);
-                    return 0;
-                }
-                rx->contentLength = sclone(value);
-                mprAssert(rx->length >= 0);
-                if (conn->endpoint || !scaselessmatch(tx->method, "HEAD")) {
-                    rx->remainingContent = rx->length;
-                    rx->needInputPipeline = 1;
-                }
+        }
+        break;
 
-            } else if (strcasecmp(key, "content-range") == 0) {
-                /*
-                    This headers specifies the range of any posted body data
-                    Format is:  Content-Range: bytes n1-n2/length
-                    Where n1 is first byte pos and n2 is last byte pos
-                 */
-                char    *sp;
-                MprOff  start, end, size;
+    case HTTP_HDR_CONTENT_LENGTH:
+        if (rx->length >= 0) {
+            httpError(conn, HTTP_CLOSE | HTTP_CODE_BAD_REQUEST, "Mulitple content length headers");
+            break;
+        }
+        rx->length = stoi(value);
+        if (rx->length < 0) {
+            httpError(conn, HTTP_ABORT | HTTP_CODE_BAD_REQUEST, "Bad content length");
+            return 0;
+        }
+        if (rx->length >= conn->limits->receiveBodySize) {
+            httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE,
+                "Request content length %,Ld bytes is too big. Limit %,Ld",
+                rx->length, conn->limits->receiveBodySize);
+            return 0;
+        }
+        rx->contentLength = value;
+        mprAssert(rx->length >= 0);
+        if (conn->endpoint || !scaselessmatch(tx->method, "HEAD")) {
+            rx->remainingContent = rx->length;
+            rx->needInputPipeline = 1;
+        }
+        break;
 
-                start = end = size = -1;
-                sp = value;
-                while (*sp && !isdigit((uchar) *sp)) {
-                    sp++;
-                }
-                if (*sp) {
-                    start = stoi(sp);
-                    if ((sp = strchr(sp, '-')) != 0) {
-                        end = stoi(++sp);
-                    }
+    case HTTP_HDR_CONTENT_RANGE:
+        {
+            /*
+                This headers specifies the range of any posted body data
+                Format is:  Content-Range: bytes n1-n2/length
+                Where n1 is first byte pos and n2 is last byte pos
+             */
+            char    *sp;
+            MprOff  start, end, size;
+
+            start = end = size = -1;
+            sp = value;
+            while (*sp && !isdigit((uchar) *sp)) {
+                sp++;
+            }
+            if (*sp) {
+                start = stoi(sp);
+                if ((sp = strchr(sp, '-')) != 0) {
+                    end = stoi(++sp);
                     if ((sp = strchr(sp, '/')) != 0) {
                         /*
-                            Note this is not the content length transmitted, but the original size of the input of which
-                            the client is transmitting only a portion.
+                            Note this is not the content length transmitted, but the original size of the input of 
+                            which the client is transmitting only a portion.
                          */
                         size = stoi(++sp);
                     }
                 }
-                if (start < 0 || end < 0 || size < 0 || end <= start) {
-                    httpError(conn, HTTP_CLOSE | HTTP_CODE_RANGE_NOT_SATISFIABLE, "Bad content range");
-                    break;
-                }
-                rx->inputRange = httpCreateRange(conn, start, end);
-
-            } else if (strcasecmp(key, "content-type") == 0) {
-                rx->mimeType = sclone(value);
-                if (rx->flags & (HTTP_POST | HTTP_PUT)) {
-                    rx->form = scontains(rx->mimeType, "application/x-www-form-urlencoded") != 0;
-                    rx->upload = scontains(rx->mimeType, "multipart/form-data") != 0;
-                } else { 
-                    rx->form = rx->upload = 0;
-                }
-
-            } else if (strcasecmp(key, "cookie") == 0) {
-                if (rx->cookie && *rx->cookie) {
-                    rx->cookie = sjoin(rx->cookie, "; ", value, NULL);
-                } else {
-                    rx->cookie = sclone(value);
-                }
-            }
-            break;
-
-        case 'e':
-            if (strcasecmp(key, "expect") == 0) {
-                /*
-                    Handle 100-continue for HTTP/1.1 clients only. This is the only expectation that is currently supported.
-                 */
-                if (!conn->http10) {
-                    if (strcasecmp(value, "100-continue") != 0) {
-                        httpError(conn, HTTP_CODE_EXPECTATION_FAILED, "Expect header value \"%s\" is unsupported", value);
-                    } else {
-                        rx->flags |= HTTP_EXPECT_CONTINUE;
-                    }
-                }
             }
-            break;
-
-        case 'h':
-            if (strcasecmp(key, "host") == 0) {
-                rx->hostHeader = sclone(value);
+            if (start < 0 || end < 0 || size < 0 || end <= start) {
+                httpError(conn, HTTP_CLOSE | HTTP_CODE_RANGE_NOT_SATISFIABLE, "Bad content range");
+                break;
             }
-            break;
+            rx->inputRange = httpCreateRange(conn, start, end);
+        }
+        break;
 
-        case 'i':
-            if ((strcasecmp(key, "if-modified-since") == 0) || (strcasecmp(key, "if-unmodified-since") == 0)) {
-                MprTime     newDate = 0;
-                char        *cp;
-                bool        ifModified = (tolower((uchar) key[3]) == 'm');
+    case HTTP_HDR_CONTENT_TYPE:
+        rx->mimeType = value;
+        if (rx->flags & (HTTP_POST | HTTP_PUT)) {
+            rx->form = scontains(rx->mimeType, "application/x-www-form-urlencoded") != 0;
+            rx->upload = scontains(rx->mimeType, "multipart/form-data") != 0;
+        } else {
+            rx->form = rx->upload = 0;
+        }
+        break;
 
-                if ((cp = strchr(value, ';')) != 0) {
-                    *cp = '\0';
-                }
-                if (mprParseTime(&newDate, value, MPR_UTC_TIMEZONE, NULL) < 0) {
-                    mprAssert(0);
-                    break;
-                }
-                if (newDate) {
-                    rx->since = newDate;
-                    rx->ifModified = ifModified;
-                    rx->flags |= HTTP_IF_MODIFIED;
-                }
+    case HTTP_HDR_COOKIE:
+        if (rx->cookie && *rx->cookie) {
+            rx->cookie = keepValue(conn, mprArenaFmt(conn->arena, "%s; %s", rx->cookie, value));
+        } else {
+            rx->cookie = value;
+        }
+        break;
 
-            } else if ((strcasecmp(key, "if-match") == 0) || (strcasecmp(key, "if-none-match") == 0)) {
-                char    *word, *tok;
-                bool    ifMatch = (tolower((uchar) key[3]) == 'm');
+    case HTTP_HDR_EXPECT:
+        /*
+            Handle 100-continue for HTTP/1.1 clients only. This is the only expectation that is currently supported.
+         */
+        if (!conn->http10) {
+            if (strcasecmp(value, "100-continue") != 0) {
+                httpError(conn, HTTP_CODE_EXPECTATION_FAILED, "Expect header value \"%s\" is unsupported", value);
+            } else {
+                rx->flags |= HTTP_EXPECT_CONTINUE;
+            }
+        }
+        break;
 
-                if ((tok = strchr(value, ';')) != 0) {
-                    *tok = '\0';
-                }
-                rx->ifMatch = ifMatch;
-                rx->flags |= HTTP_IF_MODIFIED;
-                value = sclone(value);
-                word = stok(value, " ,", &tok);
-                while (word) {
-                    addMatchEtag(conn, word);
-                    word = stok(0, " ,", &tok);
-                }
+    case HTTP_HDR_HOST:
+        rx->hostHeader = value;
+        break;
 
-            } else if (strcasecmp(key, "if-range") == 0) {
-                char    *word, *tok;
+    case HTTP_HDR_IF_MODIFIED_SINCE:
+    case HTTP_HDR_IF_UNMODIFIED_SINCE:
+        {
+            MprTime     newDate = 0;
+            char        *cp;
+            bool        ifModified = (id == HTTP_HDR_IF_MODIFIED_SINCE);
 
-                if ((tok = strchr(value, ';')) != 0) {
-                    *tok = '\0';
-                }
-                rx->ifMatch = 1;
+            if ((cp = strchr(value, ';')) != 0) {
+                value = snclone(value, cp - value);
+            }
+            if (mprParseTime(&newDate, value, MPR_UTC_TIMEZONE, NULL) < 0) {
+                mprAssert(0);
+                break;
+            }
+            if (newDate) {
+                rx->since = newDate;
+                rx->ifModified = ifModified;
                 rx->flags |= HTTP_IF_MODIFIED;
-                value = sclone(value);
-                word = stok(value, " ,", &tok);
-                while (word) {
-                    addMatchEtag(conn, word);
-                    word = stok(0, " ,", &tok);
-                }
             }
-            break;
+        }
+        break;
 
-        case 'k':
-            /* Keep-Alive: timeout=N, max=1 */
-            if (strcasecmp(key, "keep-alive") == 0) {
-                keepAlive = 1;
-                if ((tok = scontains(value, "max=")) != 0) {
-                    conn->keepAliveCount = atoi(&tok[4]);
-                    /*  
-                        IMPORTANT: Deliberately close the connection one request early. This ensures a client-led 
-                        termination and helps relieve server-side TIME_WAIT conditions.
-                     */
-                    if (conn->keepAliveCount == 1) {
-                        conn->keepAliveCount = 0;
-                    }
-                }
+    case HTTP_HDR_IF_MATCH:
+    case HTTP_HDR_IF_NONE_MATCH:
+    case HTTP_HDR_IF_RANGE:
+        {
+            char    *word, *tok;
+
+            value = mprArenaClone(conn->arena, value);
+            if ((tok = strchr(value, ';')) != 0) {
+                *tok = '\0';
             }
-            break;                
-                
-        case 'l':
-            if (strcasecmp(key, "location") == 0) {
-                rx->redirect = sclone(value);
+            rx->ifMatch = (id != HTTP_HDR_IF_NONE_MATCH);
+            rx->flags |= HTTP_IF_MODIFIED;
+            word = stok(value, " ,", &tok);
+            while (word) {
+                addMatchEtag(conn, word);
+                word = stok(0, " ,", &tok);
             }
-            break;
+        }
+        break;
 
-#if WSS
-        case 'o':
-            if (strcasecmp(key, "origin") == 0) {
-                rx->origin = sclone(value);
+    case HTTP_HDR_KEEP_ALIVE:
+        /* Keep-Alive: timeout=N, max=1 */
+        rx->keepAlive = 1;
+        if ((tok = scontains(value, "max=")) != 0) {
+            conn->keepAliveCount = atoi(&tok[4]);
+            /*
+                IMPORTANT: Deliberately close the connection one request early. This ensures a client-led
+                termination and helps relieve server-side TIME_WAIT conditions.
+             */
+            if (conn->keepAliveCount == 1) {
+                conn->keepAliveCount = 0;
             }
-            break;
-#endif
+        }
+        break;
 
-        case 'p':
-            if (strcasecmp(key, "pragma") == 0) {
-                rx->pragma = sclone(value);
-            }
-            break;
+    case HTTP_HDR_LOCATION:
+        rx->redirect = value;
+        break;
 
-        case 'r':
-            if (strcasecmp(key, "range") == 0) {
-                if (!parseRange(conn, value)) {
-                    httpError(conn, HTTP_CLOSE | HTTP_CODE_RANGE_NOT_SATISFIABLE, "Bad range");
-                }
-            } else if (strcasecmp(key, "referer") == 0) {
-                /* NOTE: yes the header is misspelt in the spec */
-                rx->referrer = sclone(value);
-            }
-            break;
+    case HTTP_HDR_PRAGMA:
+        rx->pragma = value;
+        break;
 
-#if WSS
-        case 's':
-            if (strcasecmp(key, "sec-websocket-key") == 0) {
-                rx->sockKey = sclone(value);
-            } else if (strcasecmp(key, "sec-websocket-protocol") == 0) {
-                rx->sockProtocol = sclone(value);
-            } else if (strcasecmp(key, "sec-websocket-version") == 0) {
-                rx->sockVersion = sclone(value);
-            }
-            break;
-#endif
-        case 't':
-            if (strcasecmp(key, "transfer-encoding") == 0) {
-                if (scaselesscmp(value, "chunked") == 0) {
-                    /*  
-                        remainingContent will be revised by the chunk filter as chunks are processed and will 
-                        be set to zero when the last chunk has been received.
-                     */
-                    rx->flags |= HTTP_CHUNKED;
-                    rx->chunkState = HTTP_CHUNK_START;
-                    rx->remainingContent = MAXINT;
-                    rx->needInputPipeline = 1;
-                }
-            }
-            break;
+    case HTTP_HDR_RANGE:
+        if (!parseRange(conn, value)) {
+            httpError(conn, HTTP_CLOSE | HTTP_CODE_RANGE_NOT_SATISFIABLE, "Bad range");
+        }
+        break;
+
+    case HTTP_HDR_REFERER:
+        /* NOTE: yes the header is misspelt in the spec */
+        rx->referrer = value;
+        break;
+
+    case HTTP_HDR_TRANSFER_ENCODING:
+        if (scaselesscmp(value, "chunked") == 0) {
+            /*
+                remainingContent will be revised by the chunk filter as chunks are processed and will
+                be set to zero when the last chunk has been received.
+             */
+            rx->flags |= HTTP_CHUNKED;
+            rx->chunkState = HTTP_CHUNK_START;
+            rx->remainingContent = MAXINT;
+            rx->needInputPipeline = 1;
+        }
+        break;
+
+    case HTTP_HDR_USER_AGENT:
+        rx->userAgent = value;
+        break;
+
+    case HTTP_HDR_X_HTTP_METHOD_OVERRIDE:
+        httpSetMethod(conn, value);
+        break;
 
-        case 'x':
-            if (strcasecmp(key, "x-http-method-override") == 0) {
-                httpSetMethod(conn, value);
 #if BIT_DEBUG
-            } else if (strcasecmp(key, "x-chunk-size") == 0) {
-                tx->chunkSize = atoi(value);
-                if (tx->chunkSize <= 0) {
-                    tx->chunkSize = 0;
-                } else if (tx->chunkSize > conn->limits->chunkSize) {
-                    tx->chunkSize = conn->limits->chunkSize;
-                }
+    case HTTP_HDR_X_CHUNK_SIZE:
+        tx->chunkSize = atoi(value);
+        if (tx->chunkSize <= 0) {
+            tx->chunkSize = 0;
+        } else if (tx->chunkSize > conn->limits->chunkSize) {
+            tx->chunkSize = conn->limits->chunkSize;
+        }
+        break;
 #endif
-            }
-            break;
 
-        case 'u':
 #if WSS
-            if (scaselesscmp(key, "upgrade") == 0) {
-                rx->upgrade = sclone(value);
-            } else
-#endif
-            if (strcasecmp(key, "user-agent") == 0) {
-                rx->userAgent = sclone(value);
-            }
-            break;
+    case HTTP_HDR_ORIGIN:
+        rx->origin = value;
+        break;
 
-        case 'w':
-            if (strcasecmp(key, "www-authenticate") == 0) {
-                cp = value;
-                while (*value && !isspace((uchar) *value)) {
-                    value++;
-                }
-                *value++ = '\0';
-                conn->authType = slower(cp);
-                rx->authDetails = sclone(value);
-            }
-            break;
-        }
-    }
-    /*
-        Don't stream input if a form or upload. NOTE: Upload needs the Files[] collection.
-     */
-    rx->streamInput = !(rx->form || rx->upload);
-    rx->eof = (rx->remainingContent == 0);
-    if (!keepAlive) {
-        conn->keepAliveCount = 0;
-    }
-    if (!(rx->flags & HTTP_CHUNKED)) {
-        /*  
-            Step over "\r\n" after headers. 
-            Don't do this if chunked so chunking can parse a single chunk delimiter of "\r\nSIZE ...\r\n"
-         */
-        if (httpGetPacketLength(packet) >= 2) {
-            mprAdjustBufStart(content, 2);
-        }
+    case HTTP_HDR_SEC_WEBSOCKET_KEY:
+        rx->sockKey = value;
+        break;
+
+    case HTTP_HDR_SEC_WEBSOCKET_PROTOCOL:
+        rx->sockProtocol = value;
+        break;
+
+    case HTTP_HDR_SEC_WEBSOCKET_VERSION:
+        rx->sockVersion = value;
+        break;
+
+    case HTTP_HDR_UPGRADE:
+        rx->upgrade = value;
+        break;
+#endif
     }
     return 1;
 }
@@ -949,9 +1181,6 @@ static bool analyseContent(HttpConn *conn, HttpPacket *packet)
             "Request form of %,Ld bytes is too big. Limit %,Ld", rx->bytesRead, conn->limits->receiveFormSize);
         return 1;
     }
-    if (packet == rx->headerPacket && nbytes > 0) {
-        packet = httpSplitPacket(packet, 0);
-    }
     if (httpGetPacketLength(packet) > nbytes) {
         /*  Split excess data belonging to the next chunk or pipelined request */
         LOG(7, "processContent: Split packet of %d at %d", httpGetPacketLength(packet), nbytes);
@@ -966,6 +1195,8 @@ static bool analyseContent(HttpConn *conn, HttpPacket *packet)
         } else {
             httpPutPacketToNext(q, packet);
         }
+    } else {
+        httpRecyclePacket(conn, packet);
     }
     if (rx->remainingContent == 0 && !(rx->flags & HTTP_CHUNKED)) {
         rx->eof = 1;
@@ -1215,11 +1446,41 @@ cchar *httpGetCookies(HttpConn *conn)
 
 cchar *httpGetHeader(HttpConn *conn, cchar *key)
 {
+    int     id;
+
     if (conn->rx == 0) {
         mprAssert(conn->rx);
         return 0;
     }
-    return mprLookupKey(conn->rx->headers, slower(key));
+    if ((id = httpGetHeaderId(key, -1)) >= 0) {
+        return conn->rx->knownHeaders[id];
+    }
+    return mprLookupKey(conn->rx->headers, key);
+}
+
+
+/*
+    Map a header name to a well-known header id using the perfect hash
+ */
+int httpGetHeaderId(cchar *key, ssize len)
+{
+    HttpHeaderName  *hp;
+    int             slot;
+
+    if (len < 0) {
+        len = slen(key);
+    }
+    if (len < HTTP_HEADER_MIN || len > HTTP_HEADER_MAX) {
+        return -1;
+    }
+    if ((slot = headerSlots[HTTP_HEADER_HASH(key, len)]) == 0) {
+        return -1;
+    }
+    hp = &headerNames[slot - 1];
+    if (hp->length != len || sncaselesscmp(hp->name, key, len) != 0) {
+        return -1;
+    }
+    return slot - 1;
 }
 
 
@@ -1251,17 +1512,32 @@ char *httpGetHeadersFromHash(MprHash *hash)
 
 char *httpGetHeaders(HttpConn *conn)
 {
-    return httpGetHeadersFromHash(conn->rx->headers);
+    return httpGetHeadersFromHash(httpGetHeaderHash(conn));
 }
 
 
+/*
+    Well-known headers are not stored in the headers hash when parsed. Add them here for callers that need all the
+    headers in one hash.
+ */
 MprHash *httpGetHeaderHash(HttpConn *conn)
 {
-    if (conn->rx == 0) {
+    HttpRx      *rx;
+    int         id;
+
+    if ((rx = conn->rx) == 0) {
         mprAssert(conn->rx);
         return 0;
     }
-    return conn->rx->headers;
+    if (!rx->knownMerged) {
+        for (id = 0; id < HTTP_HDR_MAX; id++) {
+            if (rx->knownHeaders[id]) {
+                mprAddKey(rx->headers, headerNames[id].name, rx->knownHeaders[id]);
+            }
+        }
+        rx->knownMerged = 1;
+    }
+    return rx->headers;
 }
 
 
@@ -1426,40 +1702,176 @@ static void addMatchEtag(HttpConn *conn, char *etag)
     if (rx->etags == 0) {
         rx->etags = mprCreateList(-1, 0);
     }
-    mprAddItem(rx->etags, etag);
+    mprAddItem(rx->etags, sclone(etag));
+}
+
+
+/*
+    Get the next white space delimited token from a null terminated line. The cursor is advanced past the token and any
+    following white space. This routine always returns a non-zero token. The empty string means there are no more tokens.
+ */
+static char *getToken(char **cursor)
+{
+    char    *token, *cp;
+
+    for (token = *cursor; *token == ' ' || *token == '\t'; token++) {}
+    for (cp = token; *cp && *cp != ' ' && *cp != '\t'; cp++) {}
+    if (*cp) {
+        *cp++ = '\0';
+        cp += strspn(cp, " \t");
+    }
+    *cursor = cp;
+    return token;
 }
 
 
 /*
-    Get the next input token. The content buffer is advanced to the next token. This routine always returns a
-    non-zero token. The empty string means the delimiter was not found. The delimiter is a string to match and not
-    a set of characters. If null, it means use white space (space or tab) as a delimiter. 
+    Scan header text for a line terminator. See httpScanHeader for details. This scans a vector of bytes at a time
+    when SSE2 or AVX2 instructions are available. Control characters below 0x20 (except tab and carriage return) and
+    DEL stop the scan. Newline is a control character, so one comparison finds both the line end and illegal bytes.
  */
-static char *getToken(HttpConn *conn, cchar *delim)
+char *httpScanHeader(cchar *start, cchar *end, cchar **colon)
 {
-    MprBuf  *buf;
-    char    *token, *endToken, *nextToken;
+    cchar   *cp;
+
+    cp = start;
+#if HTTP_SCAN_AVX2
+    {
+        __m256i     v, ctl, ctlMax, tab, cr, del, colons;
+        uint        stop, found;
+
+        ctlMax = _mm256_set1_epi8(0x1f);
+        tab = _mm256_set1_epi8('\t');
+        cr = _mm256_set1_epi8('\r');
+        del = _mm256_set1_epi8(0x7f);
+        colons = _mm256_set1_epi8(':');
+        for (; (end - cp) >= 32; cp += 32) {
+            v = _mm256_loadu_si256((const __m256i*) cp);
+            ctl = _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctlMax), ctlMax);
+            ctl = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, tab), _mm256_cmpeq_epi8(v, cr)), ctl);
+            stop = (uint) _mm256_movemask_epi8(_mm256_or_si256(ctl, _mm256_cmpeq_epi8(v, del)));
+            if (*colon == 0) {
+                found = (uint) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, colons));
+                if (stop) {
+                    found &= (stop & -stop) - 1;
+                }
+                if (found) {
+                    *colon = &cp[firstBit(found)];
+                }
+            }
+            if (stop) {
+                return (char*) &cp[firstBit(stop)];
+            }
+        }
+    }
+#endif
+#if HTTP_SCAN_SSE2
+    {
+        __m128i     v, ctl, ctlMax, tab, cr, del, colons;
+        uint        stop, found;
+
+        ctlMax = _mm_set1_epi8(0x1f);
+        tab = _mm_set1_epi8('\t');
+        cr = _mm_set1_epi8('\r');
+        del = _mm_set1_epi8(0x7f);
+        colons = _mm_set1_epi8(':');
+        for (; (end - cp) >= 16; cp += 16) {
+            v = _mm_loadu_si128((const __m128i*) cp);
+            ctl = _mm_cmpeq_epi8(_mm_max_epu8(v, ctlMax), ctlMax);
+            ctl = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, cr)), ctl);
+            stop = (uint) _mm_movemask_epi8(_mm_or_si128(ctl, _mm_cmpeq_epi8(v, del)));
+            if (*colon == 0) {
+                found = (uint) _mm_movemask_epi8(_mm_cmpeq_epi8(v, colons));
+                if (stop) {
+                    found &= (stop & -stop) - 1;
+                }
+                if (found) {
+                    *colon = &cp[firstBit(found)];
+                }
+            }
+            if (stop) {
+                return (char*) &cp[firstBit(stop)];
+            }
+        }
+    }
+#endif
+    return scanBytes(cp, end, colon);
+}
 
-    buf = conn->input->content;
-    token = mprGetBufStart(buf);
-    nextToken = mprGetBufEnd(buf);
-    for (token = mprGetBufStart(buf); (*token == ' ' || *token == '\t') && token < mprGetBufEnd(buf); token++) {}
 
-    if (delim == 0) {
-        delim = " \t";
-        if ((endToken = strpbrk(token, delim)) != 0) {
-            nextToken = endToken + strspn(endToken, delim);
-            *endToken = '\0';
+/*
+    Portable byte at a time header scan. Also used for the tail of a vector scan.
+ */
+static char *scanBytes(cchar *cp, cchar *end, cchar **colon)
+{
+    int     c;
+
+    for (; cp < end; cp++) {
+        c = *(uchar*) cp;
+        if (c == ':') {
+            if (*colon == 0) {
+                *colon = cp;
+            }
+        } else if ((c < 0x20 && c != '\t' && c != '\r') || c == 0x7f) {
+            return (char*) cp;
         }
-    } else {
-        if ((endToken = strstr(token, delim)) != 0) {
-            *endToken = '\0';
-            /* Only eat one occurence of the delimiter */
-            nextToken = endToken + strlen(delim);
+    }
+    return 0;
+}
+
+
+/*
+    Return the index of the lowest set bit in a non-zero mask
+ */
+static MPR_INLINE int firstBit(uint mask)
+{
+#if __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int     i;
+
+    for (i = 0; !(mask & 1); i++) {
+        mask >>= 1;
+    }
+    return i;
+#endif
+}
+
+
+/*
+    Retain a header value that could not reference the header packet because it was merged or modified. Values inside
+    the request arena live as long as the request and need no further action. Not all arena formatted values are in 
+    the arena: long results are formatted onto the heap and large allocations bypass the arena. These and all values
+    when there is no arena must be referenced from rx->headerCopies as the headers hash does not mark its values.
+ */
+static char *keepValue(HttpConn *conn, char *value)
+{
+    HttpRx      *rx;
+
+    rx = conn->rx;
+    if (value && !mprIsArenaMem(conn->arena, value)) {
+        if (rx->headerCopies == 0) {
+            rx->headerCopies = mprCreateList(0, 0);
         }
+        mprAddItem(rx->headerCopies, value);
     }
-    buf->start = nextToken;
-    return token;
+    return value;
+}
+
+
+/*
+    Return a null terminated copy of a line from the input buffer. The copy is allocated from the request arena if
+    there is one.
+ */
+static char *cloneLine(HttpConn *conn, cchar *line, ssize len)
+{
+    char    *copy;
+
+    if ((copy = mprArenaAlloc(conn->arena, len + 1)) != 0) {
+        memcpy(copy, line, len);
+        copy[len] = '\0';
+    }
+    return copy;
 }
 
 
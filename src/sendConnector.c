@@ -4,6 +4,7 @@
     The Sendfile connector supports the optimized transmission of whole static files. It uses operating system 
     sendfile APIs to eliminate reading the document into user space and multiple socket writes. The send connector 
     is not a general purpose connector. It cannot handle dynamic data or ranged requests. It does support chunked requests.
+    For secure connections, the file is read into TLS record sized buffers that are passed directly to the SSL provider.
 
     Copyright (c) All Rights Reserved. See details at the end of the file.
  */
@@ -71,13 +72,18 @@ void httpSendOpen(HttpQueue *q)
 
 void httpSendClose(HttpQueue *q)
 {
-    HttpTx  *tx;
+    HttpConn    *conn;
+    HttpTx      *tx;
 
-    tx = q->conn->tx;
+    conn = q->conn;
+    tx = conn->tx;
     if (tx->file) {
         mprCloseFile(tx->file);
         tx->file = 0;
     }
+    if (conn->sock) {
+        mprSetSocketCork(conn->sock, 0);
+    }
 }
 
 
@@ -100,6 +106,19 @@ void httpSendOutgoingService(HttpQueue *q)
     if (tx->flags & HTTP_TX_NO_BODY) {
         httpDiscardQueueData(q, 1);
     }
+    if (tx->bytesWritten == 0 && tx->file) {
+        /*
+            Cork the socket so the headers, the file data and any chunk trailer are sent in full frames rather than
+            a short header frame followed by the file. Uncorked when the response is complete.
+         */
+        mprSetSocketCork(conn->sock, 1);
+    }
+    /*
+        Responses held for earlier pipelined requests must be written first
+     */
+    if (conn->heldOutput && !httpWriteHeldOutput(conn)) {
+        return;
+    }
     if ((tx->bytesWritten + q->ioCount) > conn->limits->transmissionBodySize) {
         httpError(conn, HTTP_ABORT | HTTP_CODE_REQUEST_TOO_LARGE | ((tx->bytesWritten) ? HTTP_ABORT : 0),
             "Http transmission aborted. Exceeded max body of %,Ld bytes", conn->limits->transmissionBodySize);
@@ -150,6 +169,7 @@ void httpSendOutgoingService(HttpQueue *q)
     }
     if (q->ioCount == 0) {
         if ((q->flags & HTTP_QUEUE_EOF)) {
+            mprSetSocketCork(conn->sock, 0);
             httpConnectorComplete(conn);
         } else {
             httpNotifyWritable(conn);
@@ -295,6 +315,7 @@ static void adjustPacketData(HttpQueue *q, MprOff bytes)
         }
         if (httpGetPacketLength(packet) == 0) {
             httpGetPacket(q);
+            httpRecyclePacket(q->conn, packet);
         }
         mprAssert(bytes >= 0);
         if (bytes == 0 && (q->first == NULL || !(q->first->flags & HTTP_PACKET_END))) {
@@ -69,7 +69,8 @@ static void incoming(HttpQueue *q, HttpPacket *packet)
         /* This queue is the last queue in the pipeline */
         //  MOB - should this call WillAccept?
         if (httpGetPacketLength(packet) > 0) {
-            httpJoinPacketForService(q, packet, 0);
+            /* Chain the packet without copying. Readers consume across packets or use httpLinearizePacket */
+            httpPutForService(q, packet, HTTP_DELAY_SERVICE);
             HTTP_NOTIFY(q->conn, 0, HTTP_NOTIFY_READABLE);
         } else {
             /* Zero length packet means eof */
@@ -132,10 +132,10 @@ static void traceBuf(HttpConn *conn, int dir, int level, cchar *msg, cchar *buf,
         data = mprAlloc(len + 1);
         memcpy(data, start, len);
         data[len] = '\0';
-        mprRawLog(level, "\n>>>>>>>>>> %s %s packet %d, len %d (conn %d) >>>>>>>>>>\n%s", tag, msg, seqno, 
+        mprRawLog(level, "\n>>>>>>>>>> %s %s packet %d, len %d (conn %Ld) >>>>>>>>>>\n%s", tag, msg, seqno, 
             len, conn->seqno, data);
     } else {
-        mprRawLog(level, "\n>>>>>>>>>> %s %s packet %d, len %d (conn %d) >>>>>>>>>> (binary)\n", tag, msg, seqno, 
+        mprRawLog(level, "\n>>>>>>>>>> %s %s packet %d, len %d (conn %Ld) >>>>>>>>>> (binary)\n", tag, msg, seqno, 
             len, conn->seqno);
         data = mprAlloc(len * 3 + ((len / 16) + 1) + 1);
         digits = "0123456789ABCDEF";
@@ -151,7 +151,7 @@ static void traceBuf(HttpConn *conn, int dir, int level, cchar *msg, cchar *buf,
         *dp = '\0';
         mprRawLog(level, "%s", data);
     }
-    mprRawLog(level, "<<<<<<<<<< End %s packet, conn %d\n\n", tag, conn->seqno);
+    mprRawLog(level, "<<<<<<<<<< End %s packet, conn %Ld\n\n", tag, conn->seqno);
 }
 
 
@@ -165,7 +165,7 @@ void httpTraceContent(HttpConn *conn, int dir, int item, HttpPacket *packet, ssi
     level = trace->levels[item];
 
     if (trace->size >= 0 && total >= trace->size) {
-        mprLog(level, "Abbreviating response trace for conn %d", conn->seqno);
+        mprLog(level, "Abbreviating response trace for conn %Ld", conn->seqno);
         trace->disable = 1;
         return;
     }
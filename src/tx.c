@@ -7,9 +7,29 @@
 
 #include    "http.h"
 
+/************************************ Locals **********************************/
+
+#define HEADER_BIT(id)  (((int64) 1) << (id))
+
+/*
+    Pre-rendered static response headers for a route and mime type. Both variants include the terminating blank line.
+ */
+typedef struct HttpHeaderTemplate {
+    cchar       *software;              /* Server header value when rendered */
+    char        *keepAlive;             /* Headers for a response on a persistent connection */
+    char        *close;                 /* Headers for the last response on a connection */
+    ssize       keepAliveLen;           /* Length of keepAlive */
+    ssize       closeLen;               /* Length of close */
+} HttpHeaderTemplate;
+
 /***************************** Forward Declarations ***************************/
 
+static MprBuf *createTemplateBuf(char *data, ssize len);
+static HttpHeaderTemplate *getHeaderTemplate(HttpConn *conn, int64 *defined);
+static void manageHeaderTemplate(HttpHeaderTemplate *tp, int flags);
+static void manageTemplateBuf(MprBuf *buf, int flags);
 static void manageTx(HttpTx *tx, int flags);
+static void setTemplateHeaders(HttpConn *conn, HttpPacket *packet, HttpHeaderTemplate *tp, int64 defined);
 
 /*********************************** Code *************************************/
 
@@ -119,7 +139,7 @@ void httpAddHeader(HttpConn *conn, cchar *key, cchar *fmt, ...)
     mprAssert(fmt && *fmt);
 
     va_start(vargs, fmt);
-    value = sfmtv(fmt, vargs);
+    value = mprArenaFmtv(conn->arena, fmt, vargs);
     va_end(vargs);
 
     if (!mprLookupKey(conn->tx->headers, key)) {
@@ -137,7 +157,7 @@ void httpAddHeaderString(HttpConn *conn, cchar *key, cchar *value)
     mprAssert(value);
 
     if (!mprLookupKey(conn->tx->headers, key)) {
-        addHdr(conn, key, sclone(value));
+        addHdr(conn, key, mprArenaClone(conn->arena, value));
     }
 }
 
@@ -156,7 +176,7 @@ void httpAppendHeader(HttpConn *conn, cchar *key, cchar *fmt, ...)
     mprAssert(fmt && *fmt);
 
     va_start(vargs, fmt);
-    value = sfmtv(fmt, vargs);
+    value = mprArenaFmtv(conn->arena, fmt, vargs);
     va_end(vargs);
 
     oldValue = mprLookupKey(conn->tx->headers, key);
@@ -167,7 +187,7 @@ void httpAppendHeader(HttpConn *conn, cchar *key, cchar *fmt, ...)
         if (scaselessmatch(key, "Set-Cookie")) {
             mprAddDuplicateKey(conn->tx->headers, key, value);
         } else {
-            addHdr(conn, key, sfmt("%s, %s", oldValue, value));
+            addHdr(conn, key, mprArenaFmt(conn->arena, "%s, %s", oldValue, value));
         }
     } else {
         addHdr(conn, key, value);
@@ -189,12 +209,12 @@ void httpAppendHeaderString(HttpConn *conn, cchar *key, cchar *value)
     oldValue = mprLookupKey(conn->tx->headers, key);
     if (oldValue) {
         if (scaselessmatch(key, "Set-Cookie")) {
-            mprAddDuplicateKey(conn->tx->headers, key, sclone(value));
+            mprAddDuplicateKey(conn->tx->headers, key, mprArenaClone(conn->arena, value));
         } else {
-            addHdr(conn, key, sfmt("%s, %s", oldValue, value));
+            addHdr(conn, key, mprArenaFmt(conn->arena, "%s, %s", oldValue, value));
         }
     } else {
-        addHdr(conn, key, sclone(value));
+        addHdr(conn, key, mprArenaClone(conn->arena, value));
     }
 }
 
@@ -211,7 +231,7 @@ void httpSetHeader(HttpConn *conn, cchar *key, cchar *fmt, ...)
     mprAssert(fmt && *fmt);
 
     va_start(vargs, fmt);
-    value = sfmtv(fmt, vargs);
+    value = mprArenaFmtv(conn->arena, fmt, vargs);
     va_end(vargs);
     addHdr(conn, key, value);
 }
@@ -222,7 +242,7 @@ void httpSetHeaderString(HttpConn *conn, cchar *key, cchar *value)
     mprAssert(key && *key);
     mprAssert(value);
 
-    addHdr(conn, key, sclone(value));
+    addHdr(conn, key, mprArenaClone(conn->arena, value));
 }
 
 
@@ -529,7 +549,7 @@ static void setHeaders(HttpConn *conn, HttpPacket *packet)
     MprOff      length;
     cchar       *mimeType;
 
-    mprAssert(packet->flags == HTTP_PACKET_HEADER);
+    mprAssert(packet->flags & HTTP_PACKET_HEADER);
 
     rx = conn->rx;
     tx = conn->tx;
@@ -625,16 +645,182 @@ void httpSetContentType(HttpConn *conn, cchar *mimeType)
 }
 
 
-void httpWriteHeaders(HttpConn *conn, HttpPacket *packet)
+/*
+    Return the header template to use for a server response, or null if the response must render all headers. 
+    Templates are only used for plain responses where the handler has not defined the templated headers itself.
+    The well-known headers already defined by the handler are returned as a bit mask in *defined.
+ */
+static HttpHeaderTemplate *getHeaderTemplate(HttpConn *conn, int64 *defined)
+{
+    HttpRx              *rx;
+    HttpTx              *tx;
+    HttpRoute           *route;
+    HttpHeaderTemplate  *tp;
+    MprKey              *kp;
+    cchar               *mimeType, *software;
+    int                 id;
+
+    rx = conn->rx;
+    tx = conn->tx;
+    if (!conn->endpoint || conn->error || (route = rx->route) == 0 || tx->altBody || tx->outputRanges) {
+        return 0;
+    }
+    *defined = 0;
+    for (kp = 0; (kp = mprGetNextKey(tx->headers, kp)) != 0; ) {
+        if ((id = httpGetHeaderId(kp->key, slen(kp->key))) >= 0) {
+            *defined |= HEADER_BIT(id);
+        }
+    }
+    if (*defined & (HEADER_BIT(HTTP_HDR_SERVER) | HEADER_BIT(HTTP_HDR_CONNECTION) | HEADER_BIT(HTTP_HDR_KEEP_ALIVE) | 
+            HEADER_BIT(HTTP_HDR_TRANSFER_ENCODING))) {
+        return 0;
+    }
+    mimeType = 0;
+    if (tx->ext && !(*defined & HEADER_BIT(HTTP_HDR_CONTENT_TYPE))) {
+        mimeType = mprLookupMime(route->mimeTypes, tx->ext);
+    }
+    software = conn->http->software;
+
+    lock(route);
+    if (route->headerTemplates == 0) {
+        route->headerTemplates = mprCreateHash(HTTP_SMALL_HASH_SIZE, 0);
+    }
+    if ((tp = mprLookupKey(route->headerTemplates, mimeType ? mimeType : "")) == 0 || tp->software != software) {
+        if ((tp = mprAllocObj(HttpHeaderTemplate, manageHeaderTemplate)) != 0) {
+            tp->software = software;
+            if (mimeType) {
+                tp->keepAlive = sfmt("Server: %s\r\nContent-Type: %s\r\nConnection: keep-alive\r\n\r\n", 
+                    software, mimeType);
+                tp->close = sfmt("Server: %s\r\nContent-Type: %s\r\nConnection: close\r\n\r\n", 
+                    software, mimeType);
+            } else {
+                tp->keepAlive = sfmt("Server: %s\r\nConnection: keep-alive\r\n\r\n", software);
+                tp->close = sfmt("Server: %s\r\nConnection: close\r\n\r\n", software);
+            }
+            tp->keepAliveLen = slen(tp->keepAlive);
+            tp->closeLen = slen(tp->close);
+            mprAddKey(route->headerTemplates, mimeType ? mimeType : "", tp);
+        }
+    }
+    unlock(route);
+    return tp;
+}
+
+
+static void manageHeaderTemplate(HttpHeaderTemplate *tp, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(tp->software);
+        mprMark(tp->keepAlive);
+        mprMark(tp->close);
+    }
+}
+
+
+/*
+    Create a read-only buffer that references template data without copying
+ */
+static MprBuf *createTemplateBuf(char *data, ssize len)
+{
+    MprBuf      *buf;
+
+    if ((buf = mprAllocObj(MprBuf, manageTemplateBuf)) == 0) {
+        return 0;
+    }
+    buf->data = buf->start = data;
+    buf->endbuf = buf->end = &data[len];
+    buf->buflen = buf->maxsize = buf->growBy = len;
+    return buf;
+}
+
+
+static void manageTemplateBuf(MprBuf *buf, int flags)
 {
-    Http        *http;
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(buf->data);
+    }
+}
+
+
+/*
+    Render the variable headers of a templated response. The packet content holds the status line and these headers.
+    It is then moved to the packet prefix and the content references the template so the static headers are written 
+    as a separate I/O vector entry. Only the Date, Content-Length, ETag and Keep-Alive values vary per response.
+ */
+static void setTemplateHeaders(HttpConn *conn, HttpPacket *packet, HttpHeaderTemplate *tp, int64 defined)
+{
+    HttpRx      *rx;
     HttpTx      *tx;
-    HttpUri     *parsedUri;
-    MprKey      *kp;
     MprBuf      *buf;
-    int         level;
+    MprOff      length;
+    ssize       len;
+    char        *data;
+
+    rx = conn->rx;
+    tx = conn->tx;
+    buf = packet->content;
+
+    if (!(defined & HEADER_BIT(HTTP_HDR_DATE))) {
+        mprPutStringToBuf(buf, "Date: ");
+        mprPutStringToBuf(buf, conn->http->currentDate);
+        mprPutStringToBuf(buf, "\r\n");
+    }
+    if (tx->etag && !(defined & HEADER_BIT(HTTP_HDR_ETAG))) {
+        mprPutStringToBuf(buf, "ETag: ");
+        mprPutStringToBuf(buf, tx->etag);
+        mprPutStringToBuf(buf, "\r\n");
+    }
+    length = tx->length > 0 ? tx->length : 0;
+    if (rx->flags & HTTP_HEAD) {
+        tx->flags |= HTTP_TX_NO_BODY;
+        httpDiscardData(conn, HTTP_QUEUE_TX);
+    }
+    if (tx->chunkSize > 0 && !(rx->flags & HTTP_HEAD)) {
+        mprPutStringToBuf(buf, "Transfer-Encoding: chunked\r\n");
 
-    mprAssert(packet->flags == HTTP_PACKET_HEADER);
+    } else if ((rx->flags & HTTP_HEAD) || 
+            !((100 <= tx->status && tx->status <= 199) || tx->status == 204 || tx->status == 304)) {
+        /* Server must not emit a content length header for 1XX, 204 and 304 status */
+        if (!(defined & HEADER_BIT(HTTP_HDR_CONTENT_LENGTH))) {
+            mprPutStringToBuf(buf, "Content-Length: ");
+            mprPutIntToBuf(buf, length);
+            mprPutStringToBuf(buf, "\r\n");
+        }
+    }
+    if (--conn->keepAliveCount > 0) {
+        mprPutStringToBuf(buf, "Keep-Alive: timeout=");
+        mprPutIntToBuf(buf, conn->limits->inactivityTimeout / 1000);
+        mprPutStringToBuf(buf, ", max=");
+        mprPutIntToBuf(buf, conn->keepAliveCount);
+        mprPutStringToBuf(buf, "\r\n");
+        data = tp->keepAlive;
+        len = tp->keepAliveLen;
+    } else {
+        data = tp->close;
+        len = tp->closeLen;
+    }
+    if (tx->chunkSize > 0) {
+        /* Omit the blank line. The chunk filter emits "\r\nSize\r\n" as the first chunk delimiter. */
+        len -= 2;
+    }
+    /* httpRecyclePacket reclaims the pooled buffer from the prefix */
+    packet->prefix = buf;
+    packet->content = createTemplateBuf(data, len);
+}
+
+
+void httpWriteHeaders(HttpConn *conn, HttpPacket *packet)
+{
+    Http                *http;
+    HttpTx              *tx;
+    HttpUri             *parsedUri;
+    HttpHeaderTemplate  *tp;
+    MprKey              *kp;
+    MprBuf              *buf;
+    int64               defined;
+    int                 level;
+
+    mprAssert(packet->flags & HTTP_PACKET_HEADER);
 
     http = conn->http;
     tx = conn->tx;
@@ -653,7 +839,9 @@ void httpWriteHeaders(HttpConn *conn, HttpPacket *packet)
         conn->keepAliveCount = -1;
         return;
     }
-    setHeaders(conn, packet);
+    if ((tp = getHeaderTemplate(conn, &defined)) == 0) {
+        setHeaders(conn, packet);
+    }
 
     if (conn->endpoint) {
         mprPutStringToBuf(buf, conn->protocol);
@@ -694,14 +882,19 @@ void httpWriteHeaders(HttpConn *conn, HttpPacket *packet)
      */
     kp = mprGetFirstKey(conn->tx->headers);
     while (kp) {
-        mprPutStringToBuf(packet->content, kp->key);
-        mprPutStringToBuf(packet->content, ": ");
+        mprPutStringToBuf(buf, kp->key);
+        mprPutStringToBuf(buf, ": ");
         if (kp->data) {
-            mprPutStringToBuf(packet->content, kp->data);
+            mprPutStringToBuf(buf, kp->data);
         }
-        mprPutStringToBuf(packet->content, "\r\n");
+        mprPutStringToBuf(buf, "\r\n");
         kp = mprGetNextKey(conn->tx->headers, kp);
     }
+    if (tp) {
+        setTemplateHeaders(conn, packet, tp, defined);
+        tx->headerSize = mprGetBufLength(packet->prefix) + mprGetBufLength(packet->content);
+        return;
+    }
 
     /* 
         By omitting the "\r\n" delimiter after the headers, chunks can emit "\r\nSize\r\n" as a single chunk delimiter
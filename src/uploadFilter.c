@@ -31,6 +31,7 @@ typedef struct Upload {
     char            *clientFilename;    /* Current file filename */
     char            *tmpPath;           /* Current temp filename for upload data */
     char            *id;                /* Current name keyword value */
+    char            *window;            /* Scratch to test for a boundary spanning packets */
 } Upload;
 
 
@@ -46,6 +47,7 @@ static void openUpload(HttpQueue *q);
 static int  processContentBoundary(HttpQueue *q, char *line);
 static int  processContentHeader(HttpQueue *q, char *line);
 static int  processContentData(HttpQueue *q);
+static bool spansPackets(HttpQueue *q);
 
 /************************************* Code ***********************************/
 
@@ -125,6 +127,7 @@ static void openUpload(HttpQueue *q)
         boundary += 9;
         up->boundary = sjoin("--", boundary, NULL);
         up->boundaryLen = strlen(up->boundary);
+        up->window = mprAlloc(up->boundaryLen * 2 + 2);
     }
     if (up->boundaryLen == 0 || *up->boundary == '\0') {
         httpError(conn, HTTP_CODE_BAD_REQUEST, "Bad boundary");
@@ -143,6 +146,7 @@ static void manageUpload(Upload *up, int flags)
         mprMark(up->clientFilename);
         mprMark(up->tmpPath);
         mprMark(up->id);
+        mprMark(up->window);
     }
 }
 
@@ -176,7 +180,6 @@ static void closeUpload(HttpQueue *q)
 static void incomingUpload(HttpQueue *q, HttpPacket *packet)
 {
     HttpConn    *conn;
-    HttpRx      *rx;
     MprBuf      *content;
     Upload      *up;
     char        *line, *nextTok;
@@ -186,7 +189,6 @@ static void incomingUpload(HttpQueue *q, HttpPacket *packet)
     mprAssert(packet);
     
     conn = q->conn;
-    rx = conn->rx;
     up = q->queueData;
     
     if (httpGetPacketLength(packet) == 0) {
@@ -199,26 +201,31 @@ static void incomingUpload(HttpQueue *q, HttpPacket *packet)
     mprLog(7, "uploadIncomingData: %d bytes", httpGetPacketLength(packet));
     
     /*  
-        Put the packet data onto the service queue for buffering. This aggregates input data incase we don't have
-        a complete mime record yet.
+        Chain the packet onto the service queue for buffering incase we don't have a complete mime record yet.
+        Packets are only joined when a line or boundary spans packets.
      */
-    httpJoinPacketForService(q, packet, 0);
-    
-    packet = q->first;
-    content = packet->content;
-    mprAddNullToBuf(content);
-    count = httpGetPacketLength(packet);
+    httpPutForService(q, packet, HTTP_DELAY_SERVICE);
 
     for (done = 0, line = 0; !done; ) {
+        packet = q->first;
+        content = packet->content;
+        if (httpGetPacketLength(packet) == 0 && packet->next) {
+            httpRecyclePacket(conn, httpGetPacket(q));
+            continue;
+        }
         if  (up->contentState == HTTP_UPLOAD_BOUNDARY || up->contentState == HTTP_UPLOAD_CONTENT_HEADER) {
             /*
                 Parse the next input line
              */
+            mprAddNullToBuf(content);
             line = mprGetBufStart(content);
             stok(line, "\n", &nextTok);
             if (nextTok == 0) {
-                /* Incomplete line */
-                /* done++; */
+                /* Incomplete line. Join the next packet if there is one */
+                if (packet->next && httpLinearizePacket(q, httpGetPacketLength(packet) + 
+                        httpGetPacketLength(packet->next)) != 0) {
+                    continue;
+                }
                 break; 
             }
             mprAdjustBufStart(content, (int) (nextTok - line));
@@ -238,12 +245,8 @@ static void incomingUpload(HttpQueue *q, HttpPacket *packet)
             break;
 
         case HTTP_UPLOAD_CONTENT_DATA:
-            rc = processContentData(q);
-            if (rc < 0) {
-                done++;
-            }
-            if (httpGetPacketLength(packet) < up->boundaryLen) {
-                /*  Incomplete boundary - return to get more data */
+            if ((rc = processContentData(q)) <= 0) {
+                /*  Error or incomplete boundary - return to get more data */
                 done++;
             }
             break;
@@ -256,17 +259,18 @@ static void incomingUpload(HttpQueue *q, HttpPacket *packet)
     /*  
         Compact the buffer to prevent memory growth. There is often residual data after the boundary for the next block.
      */
-    if (packet != rx->headerPacket) {
-        mprCompactBuf(content);
+    packet = q->first;
+    mprCompactBuf(packet->content);
+    for (count = 0; packet; packet = packet->next) {
+        count += httpGetPacketLength(packet);
     }
-    q->count -= (count - httpGetPacketLength(packet));
-    mprAssert(q->count >= 0);
+    q->count = count;
 
-    if (httpGetPacketLength(packet) == 0) {
+    if (q->first->next == 0 && httpGetPacketLength(q->first) == 0) {
         /* 
            Quicker to remove the buffer so the packets don't have to be joined the next time 
          */
-        httpGetPacket(q);
+        httpRecyclePacket(conn, httpGetPacket(q));
         mprAssert(q->count >= 0);
     }
 }
@@ -491,30 +495,47 @@ static int processContentData(HttpQueue *q)
 
     conn = q->conn;
     up = q->queueData;
-    content = q->first->content;
     file = up->currentFile;
     packet = 0;
 
-    size = mprGetBufLength(content);
-    if (size < up->boundaryLen) {
-        /*  Incomplete boundary. Return and get more data */
-        return 0;
-    }
-    bp = getBoundary(mprGetBufStart(content), size, up->boundary, up->boundaryLen);
-    if (bp == 0) {
-        mprLog(7, "uploadFilter: Got boundary filename %x", up->clientFilename);
-        if (up->clientFilename) {
-            /*  
-                No signature found yet. probably more data to come. Must handle split boundaries.
-             */
-            data = mprGetBufStart(content);
-            dataLen = ((int) (mprGetBufEnd(content) - data)) - (up->boundaryLen - 1);
-            if (dataLen > 0 && writeToFile(q, mprGetBufStart(content), dataLen) < 0) {
-                return MPR_ERR_CANT_WRITE;
+    /*
+        Scan the queued packets for the boundary. File data preceding the boundary is written a packet at a time
+        so packets are not joined unless the boundary spans packets. Form values are joined to be contiguous.
+     */
+    while (1) {
+        content = q->first->content;
+        size = mprGetBufLength(content);
+        if ((bp = getBoundary(mprGetBufStart(content), size, up->boundary, up->boundaryLen)) != 0) {
+            break;
+        }
+        if (q->first->next == 0) {
+            if (up->clientFilename && size > up->boundaryLen + 1) {
+                /*  
+                    No signature found yet. probably more data to come. Must handle split boundaries and keep the 
+                    CRLF that precedes the boundary.
+                 */
+                dataLen = size - (up->boundaryLen + 1);
+                if (writeToFile(q, mprGetBufStart(content), dataLen) < 0) {
+                    return MPR_ERR_CANT_WRITE;
+                }
+                mprAdjustBufStart(content, dataLen);
             }
-            mprAdjustBufStart(content, dataLen);
             return 0;       /* Get more data */
         }
+        if (!up->clientFilename || spansPackets(q)) {
+            if (httpLinearizePacket(q, up->clientFilename ? size + up->boundaryLen + 2 : -1) == 0) {
+                return MPR_ERR_MEMORY;
+            }
+            if (mprGetBufLength(content) == size) {
+                return 0;
+            }
+            continue;
+        }
+        if (writeToFile(q, mprGetBufStart(content), size) < 0) {
+            return MPR_ERR_CANT_WRITE;
+        }
+        mprAdjustBufStart(content, size);
+        httpRecyclePacket(conn, httpGetPacket(q));
     }
     data = mprGetBufStart(content);
     dataLen = (bp) ? (bp - data) : mprGetBufLength(content);
@@ -556,7 +577,7 @@ static int processContentData(HttpQueue *q)
                  */
                 mprPutCharToBuf(packet->content, '&');
             } else {
-                conn->rx->mimeType = sclone("application/x-www-form-urlencoded");
+                conn->rx->mimeType = "application/x-www-form-urlencoded";
 
             }
             mprPutFmtToBuf(packet->content, "%s=%s", up->id, data);
@@ -578,6 +599,39 @@ static int processContentData(HttpQueue *q)
 }
 
 
+/*
+    Test if a boundary starts in the first queued packet and continues into the following packets. A boundary at the
+    start of the next packet also counts as its preceding CRLF may be in the first packet. If too little data follows
+    to decide, assume the boundary may span. The queued data is read via the queue I/O vector without joining packets.
+ */
+static bool spansPackets(HttpQueue *q)
+{
+    MprIOVec    iovec[HTTP_MAX_IOVEC];
+    Upload      *up;
+    ssize       len, count, size, n;
+    char        *bp;
+    int         i, vcount;
+
+    up = q->queueData;
+    vcount = httpGetQueueVec(q, iovec, HTTP_MAX_IOVEC);
+    len = min(httpGetPacketLength(q->first), up->boundaryLen - 1);
+    i = 0;
+    if (len > 0) {
+        /* The first packet has data, so it is the first vector element */
+        memcpy(up->window, &iovec[0].start[iovec[0].len - len], len);
+        i++;
+    }
+    size = len + up->boundaryLen + 1;
+    for (count = len; i < vcount && count < size; i++) {
+        n = min((ssize) iovec[i].len, size - count);
+        memcpy(&up->window[count], iovec[i].start, n);
+        count += n;
+    }
+    bp = getBoundary(up->window, count, up->boundary, up->boundaryLen);
+    return count < size || (bp && bp < &up->window[len + 2]);
+}
+
+
 /*  
     Find the boundary signature in memory. Returns pointer to the first match.
  */ 
@@ -35,8 +35,9 @@ void httpCreateCGIParams(HttpConn *conn)
     mprAddKey(svars, "AUTH_TYPE", conn->authType);
     mprAddKey(svars, "AUTH_USER", conn->username);
     mprAddKey(svars, "AUTH_ACL", MPR->emptyString);
-    mprAddKey(svars, "CONTENT_LENGTH", rx->contentLength);
-    mprAddKey(svars, "CONTENT_TYPE", rx->mimeType);
+    /* Header values reference the header packet and must be copied as the hash marks its values */
+    mprAddKey(svars, "CONTENT_LENGTH", rx->contentLength ? sclone(rx->contentLength) : 0);
+    mprAddKey(svars, "CONTENT_TYPE", rx->mimeType ? sclone(rx->mimeType) : 0);
     mprAddKey(svars, "DOCUMENT_ROOT", rx->route->dir);
     mprAddKey(svars, "GATEWAY_INTERFACE", sclone("CGI/1.1"));
     mprAddKey(svars, "QUERY_STRING", rx->parsedUri->query);
@@ -104,7 +105,7 @@ static void addParamsFromBuf(HttpConn *conn, cchar *buf, ssize len)
 
     mprAssert(conn);
     vars = httpGetParams(conn);
-    decoded = mprAlloc(len + 1);
+    decoded = mprArenaAlloc(conn->arena, len + 1);
     decoded[len] = '\0';
     memcpy(decoded, buf, len);
 
@@ -129,7 +130,7 @@ static void addParamsFromBuf(HttpConn *conn, cchar *buf, ssize len)
                     mprAddKey(vars, keyword, newValue);
                 }
             } else {
-                mprAddKey(vars, keyword, sclone(value));
+                mprAddKey(vars, keyword, mprArenaClone(conn->arena, value));
             }
         }
         keyword = stok(0, "&", &tok);
@@ -149,7 +150,9 @@ static void addParamsFromQueue(HttpQueue *q)
     rx = conn->rx;
 
     if ((rx->form || rx->upload) && q->first && q->first->content) {
-        httpJoinPackets(q, -1);
+        if (httpLinearizePacket(q, -1) == 0) {
+            return;
+        }
         content = q->first->content;
         mprAddNullToBuf(content);
         mprLog(6, "Form body data: length %d, \"%s\"", mprGetBufLength(content), mprGetBufStart(content));
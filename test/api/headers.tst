@@ -0,0 +1,2 @@
+let command = Cmd.locate("testHttp") + " --filter http.api.headers " + test.mapVerbosity(-1)
+Cmd.run(command)
@@ -0,0 +1,2 @@
+let command = Cmd.locate("testHttp") + " --filter http.api.pipeline " + test.mapVerbosity(-1)
+Cmd.run(command)
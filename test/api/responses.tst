@@ -0,0 +1,2 @@
+let command = Cmd.locate("testHttp") + " --filter http.api.responses " + test.mapVerbosity(-1)
+Cmd.run(command)
@@ -0,0 +1,432 @@
+/**
+    benchMpr.c - Microbenchmarks for the MPR runtime
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+
+    Usage: benchMpr [--allocs count] [--requests count] [--timers count] [benchmark ...]
+ */
+
+/********************************** Includes **********************************/
+
+#include    "mpr.h"
+
+/*********************************** Locals ***********************************/
+
+#define BENCH_ALLOCS    (1000 * 1000)       /* Default count of allocations per thread */
+#define BENCH_THREADS   8                   /* Maximum allocation threads */
+#define BENCH_TIMERS    (100 * 1000)        /* Default count of timers */
+#define BENCH_REQUESTS  (100 * 1000)        /* Default count of simulated requests */
+#define BENCH_HEADERS   12                  /* Header strings per simulated request */
+#define BENCH_LOOPS     1000                /* Event service loop iterations to time */
+#define BENCH_BUSY      50                  /* Msec a busy thread runs without yielding */
+#define BENCH_BUFS      4                   /* Buffers per simulated request */
+#define BENCH_EVENTS    2                   /* Events per simulated request */
+
+static int          allocCount = BENCH_ALLOCS;
+static int          requestCount = BENCH_REQUESTS;
+static int          timerCount = BENCH_TIMERS;
+static volatile int allocDone;
+static volatile int busyDone;
+static volatile int fired;
+
+/***************************** Forward Declarations ***************************/
+
+static void allocThread(void *data, MprThread *tp);
+static void benchAlloc();
+static void benchArena();
+static void benchGC();
+static void benchObjects();
+static void busyThread(void *data, MprThread *tp);
+static void benchTimers();
+static void endMark(cchar *title, MprTime start, int count);
+static void objectThread(void *data, MprThread *tp);
+static void timerProc(void *data, MprEvent *event);
+
+/************************************* Code ***********************************/
+
+MAIN(benchMpr, int argc, char **argv, char **envp)
+{
+    cchar   *argp;
+    int     argind;
+
+    mprCreate(argc, argv, MPR_USER_EVENTS_THREAD);
+
+    for (argind = 1; argind < argc; argind++) {
+        argp = argv[argind];
+        if (*argp != '-') {
+            break;
+        }
+        if (smatch(argp, "--allocs") && argind + 1 < argc) {
+            allocCount = atoi(argv[++argind]);
+        } else if (smatch(argp, "--requests") && argind + 1 < argc) {
+            requestCount = atoi(argv[++argind]);
+        } else if (smatch(argp, "--timers") && argind + 1 < argc) {
+            timerCount = atoi(argv[++argind]);
+        } else {
+            mprPrintfError("Usage: benchMpr [--allocs count] [--requests count] [--timers count] [alloc] [arena] [gc] [objects] [timers]\n");
+            return 1;
+        }
+    }
+    if (mprStart() < 0) {
+        mprError("Can't start mpr services");
+        return 2;
+    }
+    if (argind >= argc) {
+        benchAlloc();
+        benchArena();
+        benchGC();
+        benchObjects();
+        benchTimers();
+    }
+    for (; argind < argc; argind++) {
+        if (smatch(argv[argind], "alloc")) {
+            benchAlloc();
+        } else if (smatch(argv[argind], "arena")) {
+            benchArena();
+        } else if (smatch(argv[argind], "gc")) {
+            benchGC();
+        } else if (smatch(argv[argind], "objects")) {
+            benchObjects();
+        } else if (smatch(argv[argind], "timers")) {
+            benchTimers();
+        }
+    }
+    mprDestroy(MPR_EXIT_DEFAULT);
+    return 0;
+}
+
+
+/*
+    Small block allocation throughput with increasing thread counts. Blocks are garbage immediately so this includes
+    the cost of collection. With per-thread allocation caches, usec/op should fall as threads are added.
+ */
+static void benchAlloc()
+{
+    MprThread   *tp;
+    MprTime     start;
+    int         i, threads;
+
+    mprPrintf("Alloc: %d per thread\n", allocCount);
+    for (threads = 1; threads <= BENCH_THREADS; threads *= 2) {
+        allocDone = 0;
+        start = mprGetTime();
+        for (i = 0; i < threads; i++) {
+            tp = mprCreateThread("alloc", allocThread, NULL, 0);
+            mprStartThread(tp);
+        }
+        mprYield(MPR_YIELD_STICKY);
+        while (allocDone < threads) {
+            mprNap(1);
+        }
+        mprResetYield();
+        endMark(sfmt("Alloc %d threads", threads), start, allocCount * threads);
+    }
+#if BIT_MEMORY_STATS
+    mprPrintf("    Heap lock contention %Ld, thread cache hits %Ld, refills %Ld\n", mprGetMemStats()->heapContention, 
+        mprGetMemStats()->cacheHits, mprGetMemStats()->cacheRefills);
+#endif
+}
+
+
+static void allocThread(void *data, MprThread *tp)
+{
+    int     i;
+
+    for (i = 0; i < allocCount; i++) {
+        mprAlloc(16 + (i & 0x7F));
+        if ((i & 0x3FF) == 0) {
+            mprYield(0);
+        }
+    }
+    mprAtomicAdd((int*) &allocDone, 1);
+}
+
+
+/*
+    Request-scoped string garbage. Each simulated request clones a set of header sized strings which die at the end of
+    the request. Compares the collector with an arena that is reset after each request. Reports GC iterations.
+ */
+static void benchArena()
+{
+    MprArena    *arena;
+    MprTime     start;
+    char        value[80];
+    int         i, j, gc;
+
+    mprPrintf("Arena: %d requests, %d strings per request\n", requestCount, BENCH_HEADERS);
+    memset(value, 'x', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+
+    gc = MPR->heap->iteration;
+    start = mprGetTime();
+    for (i = 0; i < requestCount; i++) {
+        for (j = 0; j < BENCH_HEADERS; j++) {
+            sclone(&value[j * 4]);
+        }
+        mprYield(0);
+    }
+    endMark("Heap strings", start, requestCount * BENCH_HEADERS);
+    mprPrintf("    %-20s %8d\n", "GC iterations", MPR->heap->iteration - gc);
+
+    arena = mprCreateArena(0);
+    mprAddRoot(arena);
+    gc = MPR->heap->iteration;
+    start = mprGetTime();
+    for (i = 0; i < requestCount; i++) {
+        for (j = 0; j < BENCH_HEADERS; j++) {
+            mprArenaClone(arena, &value[j * 4]);
+        }
+        mprResetArena(arena);
+        mprYield(0);
+    }
+    endMark("Arena strings", start, requestCount * BENCH_HEADERS);
+    mprPrintf("    %-20s %8d\n", "GC iterations", MPR->heap->iteration - gc);
+    mprRemoveRoot(arena);
+}
+
+
+/*
+    Collector pauses while one thread runs long operations without yielding. Allocating threads should not be held
+    for the duration of the busy thread's work. Reports the pause histogram.
+ */
+static void benchGC()
+{
+    MprGCPauses     pauses;
+    MprThread       *tp;
+    MprTime         start;
+    uint64          limit;
+    int             i, threads;
+
+    threads = BENCH_THREADS / 2;
+    mprPrintf("GC: %d allocation threads, 1 busy thread\n", threads);
+    allocDone = busyDone = 0;
+    start = mprGetTime();
+    tp = mprCreateThread("busy", busyThread, NULL, 0);
+    mprStartThread(tp);
+    for (i = 0; i < threads; i++) {
+        tp = mprCreateThread("alloc", allocThread, NULL, 0);
+        mprStartThread(tp);
+    }
+    mprYield(MPR_YIELD_STICKY);
+    while (allocDone < threads) {
+        mprNap(1);
+    }
+    busyDone = 1;
+    mprResetYield();
+    endMark("Alloc with busy", start, allocCount * threads);
+
+    mprGetGCPauses(&pauses);
+    mprPrintf("    Pauses %Ld, aborted %Ld, avg %Ld usec, max %Ld usec\n", pauses.count, pauses.aborted, 
+        pauses.count ? pauses.total / pauses.count : 0, pauses.max);
+    for (i = 0, limit = 1 << MPR_GC_PAUSE_SHIFT; i < MPR_GC_PAUSE_BUCKETS; i++, limit <<= 1) {
+        if (pauses.histogram[i]) {
+            if (i == MPR_GC_PAUSE_BUCKETS - 1) {
+                mprPrintf("        >= %8Ld usec %8Ld\n", limit >> 1, pauses.histogram[i]);
+            } else {
+                mprPrintf("        <  %8Ld usec %8Ld\n", limit, pauses.histogram[i]);
+            }
+        }
+    }
+}
+
+
+/*
+    Request-scoped object garbage. Each simulated request creates a header hash, buffers and events which die at the 
+    end of the request. These objects are allocated from slab pools.
+ */
+static void benchObjects()
+{
+    MprThread   *tp;
+    MprTime     start;
+    int         i, threads;
+
+    mprPrintf("Objects: %d requests per thread, %d keys, %d buffers, %d events per request\n", requestCount, 
+        BENCH_HEADERS, BENCH_BUFS, BENCH_EVENTS);
+    for (threads = 1; threads <= BENCH_THREADS; threads *= 2) {
+        allocDone = 0;
+        start = mprGetTime();
+        for (i = 0; i < threads; i++) {
+            tp = mprCreateThread("objects", objectThread, NULL, 0);
+            mprStartThread(tp);
+        }
+        mprYield(MPR_YIELD_STICKY);
+        while (allocDone < threads) {
+            mprNap(1);
+        }
+        mprResetYield();
+        endMark(sfmt("Requests %d threads", threads), start, requestCount * threads);
+    }
+}
+
+
+static void objectThread(void *data, MprThread *tp)
+{
+    MprHash     *headers;
+    MprBuf      *buf;
+    cchar       *keys[BENCH_HEADERS] = {
+        "host", "user-agent", "accept", "accept-language", "accept-encoding", "connection", "cookie", "referer",
+        "cache-control", "content-type", "content-length", "if-modified-since"
+    };
+    int         i, j;
+
+    for (i = 0; i < requestCount; i++) {
+        headers = mprCreateHash(BENCH_HEADERS, MPR_HASH_STATIC_ALL);
+        for (j = 0; j < BENCH_HEADERS; j++) {
+            mprAddKey(headers, keys[j], keys[j]);
+        }
+        for (j = 0; j < BENCH_BUFS; j++) {
+            buf = mprCreateBuf(64, -1);
+            mprPutStringToBuf(buf, keys[j]);
+        }
+        for (j = 0; j < BENCH_EVENTS; j++) {
+            mprCreateEvent(NULL, "request", 0, timerProc, NULL, MPR_EVENT_DONT_QUEUE);
+        }
+        mprYield(0);
+    }
+    mprAtomicAdd((int*) &allocDone, 1);
+}
+
+
+/*
+    Simulate a thread doing long running operations and only yielding in between
+ */
+static void busyThread(void *data, MprThread *tp)
+{
+    MprTime     mark;
+
+    while (!busyDone) {
+        for (mark = mprGetTime(); mprGetElapsedTime(mark) < BENCH_BUSY; ) ;
+        mprYield(0);
+    }
+}
+
+
+/*
+    Timer scheduling. Each timer has its own dispatcher to model connections that each own a timeout event.
+ */
+static void benchTimers()
+{
+    MprList         *dispatchers, *events;
+    MprDispatcher   *dispatcher;
+    MprEvent        *event;
+    MprTime         start, now;
+    int             i, next;
+
+    mprPrintf("Timers: %d\n", timerCount);
+    dispatchers = mprCreateList(timerCount, 0);
+    events = mprCreateList(timerCount, 0);
+    mprAddRoot(dispatchers);
+    mprAddRoot(events);
+
+    for (i = 0; i < timerCount; i++) {
+        mprAddItem(dispatchers, mprCreateDispatcher("bench", 1));
+    }
+    /*
+        Insert timers with due times spread over the next 1-2 minutes
+     */
+    start = mprGetTime();
+    for (ITERATE_ITEMS(dispatchers, dispatcher, next)) {
+        mprAddItem(events, mprCreateEvent(dispatcher, "timer", 60000 + (random() % 60000), timerProc, NULL, 0));
+    }
+    endMark("Insert timer", start, timerCount);
+
+    /*
+        Each event service loop finds the next due dispatcher and computes the idle time. Includes a 1 msec sleep.
+     */
+    start = mprGetTime();
+    for (i = 0; i < BENCH_LOOPS; i++) {
+        mprServiceEvents(1, MPR_SERVICE_ONE_THING);
+    }
+    endMark("Service loop", start, BENCH_LOOPS);
+
+    start = mprGetTime();
+    for (ITERATE_ITEMS(events, event, next)) {
+        mprRescheduleEvent(event, 60000 + (random() % 60000));
+    }
+    endMark("Reschedule timer", start, timerCount);
+
+    start = mprGetTime();
+    for (ITERATE_ITEMS(events, event, next)) {
+        mprRemoveEvent(event);
+    }
+    endMark("Cancel timer", start, timerCount);
+
+    for (ITERATE_ITEMS(dispatchers, dispatcher, next)) {
+        mprDestroyDispatcher(dispatcher);
+    }
+    mprClearList(dispatchers);
+    mprClearList(events);
+
+    /*
+        Fire timers due over the next 100 msec. Use a reactor so the dispatchers are serviced inline and the
+        benchmark is not limited by the worker pool.
+     */
+    if (mprStartReactors(1) == 0) {
+        fired = 0;
+        for (i = 0; i < timerCount; i++) {
+            mprAddItem(dispatchers, mprCreateReactorDispatcher("bench"));
+        }
+        start = mprGetTime();
+        for (ITERATE_ITEMS(dispatchers, dispatcher, next)) {
+            mprCreateEvent(dispatcher, "timer", random() % 100, timerProc, NULL, 0);
+        }
+        for (now = start; fired < timerCount && (now - start) < 60000; now = mprGetTime()) {
+            mprServiceEvents(10, 0);
+        }
+        endMark("Fire timer", start, fired);
+    }
+    mprRemoveRoot(events);
+    mprRemoveRoot(dispatchers);
+}
+
+
+static void timerProc(void *data, MprEvent *event)
+{
+    mprAtomicAdd((int*) &fired, 1);
+}
+
+
+static void endMark(cchar *title, MprTime start, int count)
+{
+    MprTime     elapsed;
+
+    elapsed = max(mprGetTime() - start, 1);
+    mprPrintf("    %-20s %8d in %6d msec, %10.2f usec/op\n", title, count, (int) elapsed,
+        (elapsed * 1000.0) / max(count, 1));
+}
+
+
+/*
+    @copy   default
+    
+    Copyright (c) Embedthis Software LLC, 2003-2012. All Rights Reserved.
+    Copyright (c) Michael O'Brien, 1993-2012. All Rights Reserved.
+    
+    This software is distributed under commercial and open source licenses.
+    You may use the GPL open source license described below or you may acquire 
+    a commercial license from Embedthis Software. You agree to be fully bound 
+    by the terms of either license. Consult the LICENSE.md distributed with 
+    this software for full details.
+    
+    This software is open source; you can redistribute it and/or modify it 
+    under the terms of the GNU General Public License as published by the 
+    Free Software Foundation; either version 2 of the License, or (at your 
+    option) any later version. See the GNU General Public License for more 
+    details at: http://embedthis.com/downloads/gplLicense.html
+    
+    This program is distributed WITHOUT ANY WARRANTY; without even the 
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+    
+    This GPL license does NOT permit incorporating this software into 
+    proprietary programs. If you are unable to comply with the GPL, you must
+    acquire a commercial license to use this software. Commercial licenses 
+    for this software and support services are available from Embedthis 
+    Software at http://embedthis.com 
+    
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
@@ -0,0 +1,262 @@
+/**
+    fuzzHttp.c - Fuzz driver for the Http request and response parser
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+
+    Each input is parsed from memory via httpParseMessage, once as a request by a server-side connection and once
+    as a response by a client-side connection. No sockets are used.
+
+    The file provides the libFuzzer entry points LLVMFuzzerInitialize and LLVMFuzzerTestOneInput. When built without
+    libFuzzer, it also provides a main program that replays inputs from files or mutates a built-in corpus.
+
+    Usage: fuzzHttp [--iterations count] [--seed n] [file ...]
+ */
+
+/********************************** Includes **********************************/
+
+#include    "http.h"
+
+/*********************************** Locals ***********************************/
+
+#define FUZZ_ITERATIONS     (100 * 1000)    /* Default count of mutated inputs */
+#define FUZZ_MAX_INPUT      (64 * 1024)     /* Inputs are truncated to this size */
+
+/*
+    Seed inputs for mutation
+ */
+static cchar *corpus[] = {
+    "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n",
+    "GET /index.html?a=1&b=2 HTTP/1.0\nUser-Agent: fuzz\nConnection: keep-alive\n\n",
+    "POST /form HTTP/1.1\r\nHost: example.com\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+        "Content-Length: 11\r\n\r\nname=value&",
+    "POST /upload HTTP/1.1\r\nHost: example.com\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n",
+    "GET /file HTTP/1.1\r\nHost: example.com\r\nRange: bytes=0-99,200-,-50\r\nIf-Range: \"abc\"\r\n"
+        "If-None-Match: \"abc\", \"def\"\r\nIf-Modified-Since: Tue, 05 Mar 2024 10:15:30 GMT\r\n\r\n",
+    "PUT /data HTTP/1.1\r\nHost: example.com\r\nExpect: 100-continue\r\nContent-Range: bytes 0-9/100\r\n"
+        "Content-Length: 10\r\nCookie: a=1\r\nCookie: b=2\r\nX-Custom: one\r\nX-Custom: two\r\n\r\n0123456789",
+    "GET /secure HTTP/1.1\r\nHost: example.com\r\nAuthorization: Basic dXNlcjpwYXNz\r\n"
+        "X-HTTP-Method-Override: DELETE\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 5\r\nSet-Cookie: s=1; Path=/\r\n\r\nhello",
+    "HTTP/1.1 302 Found\r\nLocation: http://example.com/next\r\nKeep-Alive: timeout=5, max=10\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\na\r\n0123456789\r\n0\r\n\r\n",
+    "HTTP/1.0 401 Unauthorized\nWWW-Authenticate: Digest realm=\"x\", nonce=\"y\"\n\n",
+};
+
+/*
+    Tokens inserted by the mutator to reach deeper parser states
+ */
+static cchar *tokens[] = {
+    "\r\n", "\n", "\r\n\r\n", ":", " ", "\t", ",", ";", "=", "\"", "/", "?", "%", "%00", "\0",
+    "Content-Length: ", "Transfer-Encoding: chunked", "Range: bytes=", "Host: ", "Cookie: ", "HTTP/1.1",
+    "-1", "0", "ffffffff", "99999999999999999999", "100-continue", "..", "../",
+};
+
+static Http         *http;
+static HttpEndpoint *endpoint;
+static HttpConn     *client;
+static HttpConn     *server;
+static HttpPacket   *packet;
+
+/********************************** Forwards **********************************/
+
+int LLVMFuzzerInitialize(int *argc, char ***argv);
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#ifndef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+static ssize mutate(char *buf, ssize len, ssize size, uint *seed);
+static int replayFile(cchar *path);
+#endif
+
+/************************************* Code ***********************************/
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    if (mprCreate(*argc, *argv, MPR_USER_EVENTS_THREAD) == 0 || mprStart() < 0) {
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    if ((http = httpCreate()) == 0) {
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    if ((endpoint = httpCreateConfiguredEndpoint(".", ".", "127.0.0.1", 0)) == 0) {
+        return MPR_ERR_CANT_INITIALIZE;
+    }
+    server = httpCreateConn(http, endpoint, NULL);
+    client = httpCreateConn(http, NULL, NULL);
+    packet = httpCreateDataPacket(FUZZ_MAX_INPUT);
+    mprAddRoot(endpoint);
+    mprAddRoot(server);
+    mprAddRoot(client);
+    mprAddRoot(packet);
+    return 0;
+}
+
+
+/*
+    Parse one input as a request and then as a response
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    size = min(size, FUZZ_MAX_INPUT);
+
+    mprFlushBuf(packet->content);
+    mprPutBlockToBuf(packet->content, (cchar*) data, size);
+    httpParseMessage(server, packet);
+
+    mprFlushBuf(packet->content);
+    mprPutBlockToBuf(packet->content, (cchar*) data, size);
+    httpParseMessage(client, packet);
+
+    mprYield(0);
+    return 0;
+}
+
+
+#ifndef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+MAIN(fuzzHttp, int argc, char **argv, char **envp)
+{
+    MprTime     start;
+    cchar       *argp, *seed;
+    char        *buf;
+    ssize       len;
+    uint        state;
+    int         argind, i, iterations;
+
+    iterations = FUZZ_ITERATIONS;
+    state = (uint) time(0);
+
+    for (argind = 1; argind < argc; argind++) {
+        argp = argv[argind];
+        if (*argp != '-') {
+            break;
+        }
+        if (smatch(argp, "--iterations") && argind + 1 < argc) {
+            iterations = atoi(argv[++argind]);
+        } else if (smatch(argp, "--seed") && argind + 1 < argc) {
+            state = (uint) atoi(argv[++argind]);
+        } else {
+            fprintf(stderr, "Usage: fuzzHttp [--iterations count] [--seed n] [file ...]\n");
+            return 1;
+        }
+    }
+    if (LLVMFuzzerInitialize(&argc, &argv) < 0) {
+        fprintf(stderr, "Can't initialize http\n");
+        return 2;
+    }
+    if (argind < argc) {
+        for (; argind < argc; argind++) {
+            if (replayFile(argv[argind]) < 0) {
+                return 3;
+            }
+        }
+        return 0;
+    }
+    mprPrintf("Fuzz: %d iterations, seed %u\n", iterations, state);
+    buf = mprAlloc(FUZZ_MAX_INPUT);
+    mprAddRoot(buf);
+    start = mprGetTime();
+
+    for (i = 0; i < iterations; i++) {
+        seed = corpus[rand_r(&state) % (sizeof(corpus) / sizeof(char*))];
+        len = slen(seed);
+        memcpy(buf, seed, len);
+        len = mutate(buf, len, FUZZ_MAX_INPUT, &state);
+        LLVMFuzzerTestOneInput((uint8_t*) buf, len);
+    }
+    mprPrintf("Fuzz: %d inputs in %d msec\n", iterations, (int) (mprGetTime() - start));
+    mprRemoveRoot(buf);
+    return 0;
+}
+
+
+/*
+    Apply a few random byte flips, truncations, deletions and token insertions. Returns the new length.
+ */
+static ssize mutate(char *buf, ssize len, ssize size, uint *seed)
+{
+    cchar   *token;
+    ssize   pos, tlen, count;
+    int     rounds;
+
+    for (rounds = 1 + rand_r(seed) % 8; rounds > 0 && len > 0; rounds--) {
+        pos = rand_r(seed) % len;
+        switch (rand_r(seed) % 5) {
+        case 0:
+            buf[pos] ^= (char) (1 << (rand_r(seed) % 8));
+            break;
+        case 1:
+            buf[pos] = (char) rand_r(seed);
+            break;
+        case 2:
+            len = pos;
+            break;
+        case 3:
+            count = 1 + rand_r(seed) % 16;
+            count = min(count, len - pos);
+            memmove(&buf[pos], &buf[pos + count], len - pos - count);
+            len -= count;
+            break;
+        case 4:
+            token = tokens[rand_r(seed) % (sizeof(tokens) / sizeof(char*))];
+            tlen = slen(token);
+            tlen = max(tlen, 1);
+            if (len + tlen <= size) {
+                memmove(&buf[pos + tlen], &buf[pos], len - pos);
+                memcpy(&buf[pos], token, tlen);
+                len += tlen;
+            }
+            break;
+        }
+    }
+    return len;
+}
+
+
+static int replayFile(cchar *path)
+{
+    char    *data;
+    ssize   len;
+
+    if ((data = mprReadPathContents(path, &len)) == 0) {
+        fprintf(stderr, "Can't read %s\n", path);
+        return MPR_ERR_CANT_READ;
+    }
+    LLVMFuzzerTestOneInput((uint8_t*) data, len);
+    return 0;
+}
+#endif /* FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION */
+
+/*
+    @copy   default
+    
+    Copyright (c) Embedthis Software LLC, 2003-2012. All Rights Reserved.
+    Copyright (c) Michael O'Brien, 1993-2012. All Rights Reserved.
+    
+    This software is distributed under commercial and open source licenses.
+    You may use the GPL open source license described below or you may acquire 
+    a commercial license from Embedthis Software. You agree to be fully bound 
+    by the terms of either license. Consult the LICENSE.md distributed with 
+    this software for full details.
+    
+    This software is open source; you can redistribute it and/or modify it 
+    under the terms of the GNU General Public License as published by the 
+    Free Software Foundation; either version 2 of the License, or (at your 
+    option) any later version. See the GNU General Public License for more 
+    details at: http://embedthis.com/downloads/gplLicense.html
+    
+    This program is distributed WITHOUT ANY WARRANTY; without even the 
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
+    
+    This GPL license does NOT permit incorporating this software into 
+    proprietary programs. If you are unable to comply with the GPL, you must
+    acquire a commercial license to use this software. Commercial licenses 
+    for this software and support services are available from Embedthis 
+    Software at http://embedthis.com 
+    
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
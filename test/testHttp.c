@@ -10,10 +10,22 @@
 /****************************** Test Definitions ******************************/
 
 extern MprTestDef testHttpGen;
+extern MprTestDef testHttpHeaders;
+extern MprTestDef testHttpPipeline;
+extern MprTestDef testHttpResponses;
+extern MprTestDef testHttpRoutes;
+extern MprTestDef testHttpSecure;
+extern MprTestDef testHttpUpload;
 
 static MprTestDef *testGroups[] = 
 {
     &testHttpGen,
+    &testHttpPipeline,
+    &testHttpUpload,
+    &testHttpHeaders,
+    &testHttpResponses,
+    &testHttpRoutes,
+    &testHttpSecure,
     0
 };
  
@@ -9,6 +9,8 @@
 
 /*********************************** Locals ***********************************/
 
+#define TEST_TIMEOUT    (10 * MPR_TICKS_PER_SEC)
+
 typedef struct TestHttp {
     Http        *http;
     HttpConn    *conn;
@@ -61,7 +63,7 @@ static void testCreateHttp(MprTestGroup *gp)
     Http        *http;
 
     th = gp->data;
-    th->http = http = httpCreate(gp);
+    th->http = http = httpCreate();
     assert(http != 0);
 }
 
@@ -75,16 +77,16 @@ static void testBasicHttpGet(MprTestGroup *gp)
     int         rc, status;
 
     th = gp->data;
-    th->http = http = httpCreate(gp);
+    th->http = http = httpCreate();
     assert(http != 0);
 
     th->conn = conn = httpCreateConn(http, NULL, gp->dispatcher);
 
-    rc = httpConnect(conn, "GET", "http://embedthis.com/index.html");
+    rc = httpConnect(conn, "GET", "http://embedthis.com/index.html", NULL);
     assert(rc >= 0);
     if (rc >= 0) {
         httpFinalize(conn);
-        httpWait(conn, HTTP_STATE_COMPLETE, MPR_TIMEOUT_SOCKETS);
+        httpWait(conn, HTTP_STATE_COMPLETE, TEST_TIMEOUT);
         status = httpGetStatus(conn);
         assert(status == 200 || status == 302);
         if (status != 200 && status != 302) {
@@ -107,16 +109,16 @@ static void testSecureHttpGet(MprTestGroup *gp)
     int         rc, status;
 
     th = gp->data;
-    th->http = http = httpCreate(gp);
+    th->http = http = httpCreate();
     assert(http != 0);
     th->conn = conn = httpCreateConn(http, NULL, gp->dispatcher);
     assert(conn != 0);
 
-    rc = httpConnect(conn, "GET", "https://www.ibm.com/");
+    rc = httpConnect(conn, "GET", "https://www.ibm.com/", NULL);
     assert(rc >= 0);
     if (rc >= 0) {
         httpFinalize(conn);
-        httpWait(conn, HTTP_STATE_COMPLETE, MPR_TIMEOUT_SOCKETS);
+        httpWait(conn, HTTP_STATE_COMPLETE, TEST_TIMEOUT);
         status = httpGetStatus(conn);
         assert(status == 200 || status == 301 || status == 302);
         if (status != 200 && status != 301 && status != 302) {
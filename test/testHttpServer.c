@@ -0,0 +1,1170 @@
+/**
+    testHttpServer.c - tests for the HTTP server using an in-process endpoint
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "http.h"
+
+/*********************************** Locals ***********************************/
+
+#define TEST_IP         "127.0.0.1"
+#define TEST_PORT       4991                /* Listening port for the in-process endpoint */
+#define TEST_TIMEOUT    (10 * MPR_TICKS_PER_SEC)
+#define TEST_BOUNDARY   "----TestBoundary7MA4YWxk"
+#define TEST_FILE_SIZE  3000                /* Size of the static file served via the send connector */
+#define TEST_SECURE_SIZE 102400             /* Size of the file sent to the test secure provider. Chunk size 0x19000 */
+
+/*
+    The endpoint is shared by all groups and is never destroyed. Tests run on a test thread while the main thread
+    services the endpoint events.
+ */
+static HttpEndpoint *endpoint;
+static char *fileDir;                       /* Directory of static files served via the send connector */
+static int sendBufferSize;                  /* Socket send buffer size for accepted connections. Zero for default */
+static ssize providerLimit;                 /* Maximum bytes accepted per write by the test secure provider */
+static int providerWrites;                  /* Count of writes to the test secure provider */
+
+/*
+    Client state for a test. Held via gp->data as the test thread yields to the garbage collector while waiting on I/O.
+ */
+typedef struct TestClient {
+    MprSocket   *sock;                      /* Client socket */
+    MprBuf      *requests;                  /* Raw requests to send */
+    MprBuf      *responses;                 /* Raw responses read */
+    MprList     *expected;                  /* Expected response bodies */
+    MprList     *marks;                     /* Offsets of interest in the requests */
+} TestClient;
+
+/***************************** Forward Declarations ***************************/
+
+static void addRequest(TestClient *tc, cchar *request, cchar *body);
+static uint checksum(cchar *data, ssize len);
+static bool checkUpload(MprTestGroup *gp);
+static char *echoResponse(cchar *body, cchar *test);
+static void fillProc(HttpConn *conn);
+static int getUploadMarks(MprTestGroup *gp, ssize *marks, int max);
+static char *makeFill(cchar *tag, int n);
+static void manageTestClient(TestClient *tc, int flags);
+static char *maskDate(cchar *response);
+static int matchResponses(MprBuf *buf, MprList *expected);
+static void notifyServer(HttpConn *conn, int state, int flags);
+static bool openClient(MprTestGroup *gp);
+static void openFile(HttpQueue *q);
+static bool prepBareLf(MprTestGroup *gp);
+static bool prepUpload(MprTestGroup *gp);
+static void readPair(int fd, MprBuf *buf);
+static char *readAll(MprTestGroup *gp, cchar *requests);
+static void readResponses(TestClient *tc, ssize chunk, MprTime delay);
+static void readyChunked(HttpQueue *q);
+static void readyEcho(HttpQueue *q);
+static void readyUpload(HttpQueue *q);
+static bool sendSecure(MprSocket *sock, int fd, ssize limit, MprBuf *out);
+static void startFile(HttpQueue *q);
+static bool uploadSplit(MprTestGroup *gp, ssize offset);
+static bool writeRequests(TestClient *tc, ssize len);
+static ssize writeProvider(MprSocket *sp, cvoid *buf, ssize len);
+
+/************************************ Code ************************************/
+
+static int initServer(MprTestGroup *gp)
+{
+    HttpHost    *host;
+    HttpRoute   *route;
+    HttpStage   *handler;
+
+    gp->data = mprAllocObj(TestClient, manageTestClient);
+    mprGlobalLock();
+    if (endpoint == 0) {
+        httpCreate();
+        if ((endpoint = httpCreateConfiguredEndpoint(".", ".", TEST_IP, TEST_PORT)) == 0) {
+            mprGlobalUnlock();
+            return MPR_ERR_CANT_CREATE;
+        }
+        mprAddRoot(endpoint);
+        host = mprGetFirstItem(endpoint->hosts);
+        httpSetRouteHandler(host->defaultRoute, "procHandler");
+        httpDefineProc("/fill", fillProc);
+
+        /*
+            The upload route needs a handler that runs once all the request body has been received
+         */
+        handler = httpCreateHandler(endpoint->http, "testHandler", 0, NULL);
+        handler->ready = readyUpload;
+        route = httpCreateInheritedRoute(host->defaultRoute);
+        route->handler = handler;
+        httpSetRoutePattern(route, "/upload", 0);
+        httpAddRouteFilter(route, "uploadFilter", NULL, HTTP_STAGE_RX);
+        httpFinalizeRoute(route);
+
+        handler = httpCreateHandler(endpoint->http, "echoHandler", 0, NULL);
+        handler->ready = readyEcho;
+        route = httpCreateInheritedRoute(host->defaultRoute);
+        route->handler = handler;
+        httpSetRoutePattern(route, "/echo", 0);
+        httpFinalizeRoute(route);
+
+        /*
+            Chunked responses need the chunk filter which the configured endpoint does not add to its routes
+         */
+        handler = httpCreateHandler(endpoint->http, "chunkedHandler", 0, NULL);
+        handler->ready = readyChunked;
+        route = httpCreateInheritedRoute(host->defaultRoute);
+        route->handler = handler;
+        httpSetRoutePattern(route, "/chunked", 0);
+        httpAddRouteFilter(route, "chunkFilter", NULL, HTTP_STAGE_RX | HTTP_STAGE_TX);
+        httpFinalizeRoute(route);
+
+        /*
+            The library has no static file handler. Define one and register it as the file handler so that GET 
+            requests for /static/ files use the send connector.
+         */
+        fileDir = mprGetTempPath(NULL);
+        mprAddRoot(fileDir);
+        mprDeletePath(fileDir);
+        mprMakeDir(mprJoinPath(fileDir, "static"), 0755, -1, -1, 1);
+        mprWritePathContents(mprJoinPath(fileDir, "static/data.txt"), makeFill("file-", TEST_FILE_SIZE), 
+            TEST_FILE_SIZE, 0644);
+        handler = httpCreateHandler(endpoint->http, "testFileHandler", HTTP_STAGE_ALL, NULL);
+        handler->open = openFile;
+        handler->start = startFile;
+        endpoint->http->fileHandler = handler;
+        route = httpCreateInheritedRoute(host->defaultRoute);
+        route->handler = handler;
+        httpSetRoutePattern(route, "/static/", 0);
+        httpSetRouteDir(route, fileDir);
+        httpFinalizeRoute(route);
+        httpSetEndpointNotifier(endpoint, notifyServer);
+        if (httpStartEndpoint(endpoint) < 0) {
+            mprGlobalUnlock();
+            return MPR_ERR_CANT_OPEN;
+        }
+    }
+    mprGlobalUnlock();
+    return 0;
+}
+
+
+static void notifyServer(HttpConn *conn, int state, int flags)
+{
+    int     size;
+
+    if (state == HTTP_STATE_CONNECTED && sendBufferSize > 0) {
+        size = sendBufferSize;
+        setsockopt(conn->sock->fd, SOL_SOCKET, SO_SNDBUF, (char*) &size, sizeof(size));
+    }
+}
+
+
+/*
+    Respond with "n" bytes made by repeating "tag"
+ */
+static void fillProc(HttpConn *conn)
+{
+    int     n;
+
+    n = httpGetIntParam(conn, "n", 0);
+    httpSetContentLength(conn, n);
+    httpWriteBlock(conn->writeq, makeFill(httpGetParam(conn, "tag", "x"), n), n);
+    httpFinalize(conn);
+}
+
+
+static char *makeFill(cchar *tag, int n)
+{
+    char    *body;
+    ssize   len;
+    int     i;
+
+    len = slen(tag);
+    body = mprAlloc(n + 1);
+    for (i = 0; i < n; i++) {
+        body[i] = tag[i % len];
+    }
+    body[n] = '\0';
+    return body;
+}
+
+
+/*
+    Respond with a chunked body
+ */
+static void readyChunked(HttpQueue *q)
+{
+    HttpConn    *conn;
+
+    conn = q->conn;
+    httpSetChunkSize(conn, 64);
+    httpWrite(q, "chunked body\n");
+    httpFinalize(conn);
+}
+
+
+static void openFile(HttpQueue *q)
+{
+    HttpConn    *conn;
+
+    conn = q->conn;
+    httpMapFile(conn, conn->rx->route);
+    if (!conn->tx->fileInfo.valid) {
+        httpError(conn, HTTP_CODE_NOT_FOUND, "Can't find %s", conn->rx->uri);
+    }
+}
+
+
+static void startFile(HttpQueue *q)
+{
+    HttpConn    *conn;
+    HttpTx      *tx;
+
+    conn = q->conn;
+    tx = conn->tx;
+    httpSetEntityLength(conn, tx->fileInfo.size);
+    if (!(tx->flags & HTTP_TX_NO_BODY)) {
+        httpPutForService(q, httpCreateEntityPacket(0, tx->fileInfo.size, NULL), HTTP_SCHEDULE_QUEUE);
+    }
+    httpFinalize(conn);
+}
+
+
+/*
+    Respond with the length and checksum of the request body and the value of the X-Test header
+ */
+static void readyEcho(HttpQueue *q)
+{
+    HttpConn    *conn;
+    MprBuf      *buf;
+    char        *response;
+    ssize       nbytes;
+
+    conn = q->conn;
+    buf = mprCreateBuf(HTTP_BUFSIZE, -1);
+    while ((nbytes = httpRead(conn, mprGetBufEnd(buf), mprGetBufSpace(buf))) > 0) {
+        mprAdjustBufEnd(buf, nbytes);
+        if (mprGetBufSpace(buf) == 0) {
+            mprGrowBuf(buf, HTTP_BUFSIZE);
+        }
+    }
+    mprAddNullToBuf(buf);
+    response = echoResponse(mprGetBufStart(buf), httpGetHeader(conn, "x-test"));
+    httpSetContentLength(conn, slen(response));
+    httpWriteBlock(q, response, slen(response));
+    httpFinalize(conn);
+}
+
+
+static char *echoResponse(cchar *body, cchar *test)
+{
+    return sfmt("len=%d sum=%u test=%s\n", (int) slen(body), checksum(body, slen(body)), test ? test : "");
+}
+
+
+/*
+    Respond with the name, length and checksum of each uploaded file followed by the "name" and "note" form fields
+ */
+static void readyUpload(HttpQueue *q)
+{
+    HttpConn        *conn;
+    HttpUploadFile  *file;
+    MprKey          *kp;
+    MprBuf          *buf;
+    char            *data;
+    ssize           len;
+
+    conn = q->conn;
+    buf = mprCreateBuf(0, 0);
+    for (ITERATE_KEY_DATA(conn->rx->files, kp, file)) {
+        if ((data = mprReadPathContents(file->filename, &len)) == 0) {
+            len = -1;
+        }
+        mprPutFmtToBuf(buf, "file %s %s len=%d sum=%u\n", kp->key, file->clientFilename, (int) len, 
+            checksum(data, len));
+    }
+    mprPutFmtToBuf(buf, "name=%s\nnote=%s\n", httpGetParam(conn, "name", ""), httpGetParam(conn, "note", ""));
+    httpSetContentLength(conn, mprGetBufLength(buf));
+    httpWriteBlock(q, mprGetBufStart(buf), mprGetBufLength(buf));
+    httpFinalize(conn);
+}
+
+
+static uint checksum(cchar *data, ssize len)
+{
+    uint    sum;
+    ssize   i;
+
+    for (sum = 0, i = 0; i < len; i++) {
+        sum = sum * 31 + (uchar) data[i];
+    }
+    return sum;
+}
+
+
+static void manageTestClient(TestClient *tc, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(tc->sock);
+        mprMark(tc->requests);
+        mprMark(tc->responses);
+        mprMark(tc->expected);
+        mprMark(tc->marks);
+    }
+}
+
+
+/*
+    Open a non-blocking client connection and reset the client state
+ */
+static bool openClient(MprTestGroup *gp)
+{
+    TestClient  *tc;
+
+    tc = gp->data;
+    tc->requests = mprCreateBuf(HTTP_BUFSIZE, -1);
+    tc->responses = mprCreateBuf(HTTP_BUFSIZE, -1);
+    tc->expected = mprCreateList(0, 0);
+    tc->marks = mprCreateList(0, MPR_LIST_STATIC_VALUES);
+    tc->sock = mprCreateSocket(NULL);
+    if (mprConnectSocket(tc->sock, TEST_IP, TEST_PORT, MPR_SOCKET_NODELAY) < 0) {
+        return 0;
+    }
+    mprSetSocketBlockingMode(tc->sock, 0);
+    return 1;
+}
+
+
+/*
+    Write "len" bytes of the pending requests. Write all pending requests if "len" is negative.
+ */
+static bool writeRequests(TestClient *tc, ssize len)
+{
+    MprBuf  *buf;
+    ssize   written;
+
+    buf = tc->requests;
+    if (len < 0 || len > mprGetBufLength(buf)) {
+        len = mprGetBufLength(buf);
+    }
+    while (len > 0) {
+        if ((written = mprWriteSocket(tc->sock, mprGetBufStart(buf), len)) < 0) {
+            return 0;
+        } else if (written == 0) {
+            mprYield(MPR_YIELD_STICKY);
+            mprWaitForSingleIO(tc->sock->fd, MPR_WRITABLE, TEST_TIMEOUT);
+            mprResetYield();
+        }
+        mprAdjustBufStart(buf, written);
+        len -= written;
+    }
+    return 1;
+}
+
+
+/*
+    Read until the server closes the connection. Read "chunk" bytes at a time and pause "delay" msec between reads
+    to emulate a slow client. Stops early on a timeout.
+ */
+static void readResponses(TestClient *tc, ssize chunk, MprTime delay)
+{
+    MprBuf  *buf;
+    ssize   nbytes;
+    int     ready;
+
+    buf = tc->responses;
+    while (!mprIsSocketEof(tc->sock)) {
+        mprYield(MPR_YIELD_STICKY);
+        ready = mprWaitForSingleIO(tc->sock->fd, MPR_READABLE, TEST_TIMEOUT);
+        mprResetYield();
+        if (!ready) {
+            break;
+        }
+        if (mprGetBufSpace(buf) < chunk) {
+            mprGrowBuf(buf, chunk);
+        }
+        if ((nbytes = mprReadSocket(tc->sock, mprGetBufEnd(buf), chunk)) > 0) {
+            mprAdjustBufEnd(buf, nbytes);
+        }
+        if (delay) {
+            mprSleep(delay);
+        }
+    }
+    mprAddNullToBuf(buf);
+}
+
+
+/*
+    Match pipelined responses against the expected bodies. Return the count of leading responses that matched exactly,
+    or -1 if there is unmatched response data.
+ */
+static int matchResponses(MprBuf *buf, MprList *expected)
+{
+    char    *body, *cp, *end, *headers, *tok;
+    ssize   len;
+    int     next;
+
+    cp = mprGetBufStart(buf);
+    end = mprGetBufEnd(buf);
+    for (next = 0; (body = mprGetNextItem(expected, &next)) != 0; ) {
+        if (!sstarts(cp, "HTTP/1.1 200 ") || (headers = strstr(cp, "\r\n\r\n")) == 0) {
+            next--;
+            break;
+        }
+        *headers = '\0';
+        headers += 4;
+        len = ((tok = scontains(cp, "\r\nContent-Length:")) != 0) ? (ssize) stoi(&tok[17]) : -1;
+        if (len != slen(body) || (end - headers) < len || memcmp(headers, body, len) != 0) {
+            next--;
+            break;
+        }
+        cp = headers + len;
+    }
+    return (cp == end) ? next : -1;
+}
+
+
+/*
+    Pipeline many small requests on one keep-alive connection. The total output is well over the pipeline hold limit
+    so the held output buffer must be reused across requests.
+ */
+static void pipelineRequests(MprTestGroup *gp, int count, ssize chunk, MprTime stall, MprTime delay)
+{
+    TestClient  *tc;
+    char        *tag;
+    int         i, n;
+
+    tc = gp->data;
+    if (!openClient(gp)) {
+        assert(0);
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        tag = sfmt("r%03d-", i);
+        n = (HTTP_MAX_PIPELINE_HOLD / 32) + ((i * 37) % 300);
+        mprAddItem(tc->expected, makeFill(tag, n));
+        mprPutFmtToBuf(tc->requests, "GET /fill?n=%d&tag=%s HTTP/1.1\r\nHost: %s\r\n%s\r\n", n, tag, TEST_IP,
+            (i == count - 1) ? "Connection: close\r\n" : "");
+    }
+    assert(writeRequests(tc, -1));
+    if (stall) {
+        mprSleep(stall);
+    }
+    readResponses(tc, chunk, delay);
+    assert(matchResponses(tc->responses, tc->expected) == count);
+    mprCloseSocket(tc->sock, 0);
+}
+
+
+static void testPipelineHold(MprTestGroup *gp)
+{
+    pipelineRequests(gp, 90, HTTP_BUFSIZE, 0, 0);
+}
+
+
+/*
+    Read slowly with a small server send buffer so the connector blocks part way through writing held output
+ */
+static void testPipelineSlowReader(MprTestGroup *gp)
+{
+    sendBufferSize = 4096;
+    pipelineRequests(gp, 90, 1024, 500, 1);
+    sendBufferSize = 0;
+}
+
+
+/*
+    Pipeline small dynamic responses that are held with static files written by the send connector. The held responses
+    must be written before each file so the responses stay in request order.
+ */
+static void testPipelineSendfile(MprTestGroup *gp)
+{
+    TestClient  *tc;
+    char        *tag;
+    int         i, count;
+
+    tc = gp->data;
+    if (!openClient(gp)) {
+        assert(0);
+        return;
+    }
+    count = 20;
+    for (i = 0; i < count; i++) {
+        if (i & 1) {
+            mprAddItem(tc->expected, makeFill("file-", TEST_FILE_SIZE));
+            mprPutFmtToBuf(tc->requests, "GET /static/data.txt HTTP/1.1\r\nHost: %s\r\n", TEST_IP);
+        } else {
+            tag = sfmt("r%03d-", i);
+            mprAddItem(tc->expected, makeFill(tag, 100 + i));
+            mprPutFmtToBuf(tc->requests, "GET /fill?n=%d&tag=%s HTTP/1.1\r\nHost: %s\r\n", 100 + i, tag, TEST_IP);
+        }
+        mprPutStringToBuf(tc->requests, (i == count - 1) ? "Connection: close\r\n\r\n" : "\r\n");
+    }
+    assert(writeRequests(tc, -1));
+    readResponses(tc, HTTP_BUFSIZE, 0);
+    assert(matchResponses(tc->responses, tc->expected) == count);
+    mprCloseSocket(tc->sock, 0);
+}
+
+
+/*
+    Open a client and prepare a multipart upload request with two files and two form fields. The offsets of the
+    boundaries in the request are saved in the client marks.
+ */
+static bool prepUpload(MprTestGroup *gp)
+{
+    TestClient  *tc;
+    MprBuf      *buf;
+    char        *data, *small;
+    ssize       len;
+    int         i;
+
+    if (!openClient(gp)) {
+        return 0;
+    }
+    tc = gp->data;
+
+    /*
+        File data with line breaks, dashes and a partial boundary so the filter must not match early
+     */
+    len = 400;
+    data = mprAlloc(len);
+    for (i = 0; i < len; i++) {
+        data[i] = "ab\r\n-"[(i * 7) % 5];
+    }
+    memcpy(&data[150], "\r\n--" TEST_BOUNDARY, 16);
+    data[len - 2] = '\r';
+    data[len - 1] = '\n';
+    small = "--\r\n";
+
+    buf = mprCreateBuf(0, 0);
+    mprAddItem(tc->marks, ITOP(mprGetBufLength(buf)));
+    mprPutStringToBuf(buf, "--" TEST_BOUNDARY "\r\nContent-Disposition: form-data; name=\"name\"\r\n\r\nJoe Bloggs\r\n");
+    mprAddItem(tc->marks, ITOP(mprGetBufLength(buf)));
+    mprPutStringToBuf(buf, "--" TEST_BOUNDARY "\r\nContent-Disposition: form-data; name=\"file1\"; "
+        "filename=\"one.bin\"\r\nContent-Type: application/octet-stream\r\n\r\n");
+    mprPutBlockToBuf(buf, data, len);
+    mprPutStringToBuf(buf, "\r\n");
+    mprAddItem(tc->marks, ITOP(mprGetBufLength(buf)));
+    mprPutStringToBuf(buf, "--" TEST_BOUNDARY "\r\nContent-Disposition: form-data; name=\"note\"\r\n\r\n"
+        "line one\r\nline two\r\n");
+    mprAddItem(tc->marks, ITOP(mprGetBufLength(buf)));
+    mprPutStringToBuf(buf, "--" TEST_BOUNDARY "\r\nContent-Disposition: form-data; name=\"file2\"; "
+        "filename=\"two.txt\"\r\nContent-Type: text/plain\r\n\r\n");
+    mprPutStringToBuf(buf, small);
+    mprPutStringToBuf(buf, "\r\n");
+    mprAddItem(tc->marks, ITOP(mprGetBufLength(buf)));
+    mprPutStringToBuf(buf, "--" TEST_BOUNDARY "--\r\n");
+
+    mprPutFmtToBuf(tc->requests, "POST /upload HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n"
+        "Content-Type: multipart/form-data; boundary=%s\r\nContent-Length: %d\r\n\r\n", 
+        TEST_IP, TEST_BOUNDARY, (int) mprGetBufLength(buf));
+    for (i = 0; i < mprGetListLength(tc->marks); i++) {
+        mprSetItem(tc->marks, i, ITOP(PTOI(mprGetItem(tc->marks, i)) + mprGetBufLength(tc->requests)));
+    }
+    mprPutBlockToBuf(tc->requests, mprGetBufStart(buf), mprGetBufLength(buf));
+
+    /*
+        The response lines for the files may be in either order
+     */
+    mprAddItem(tc->expected, sfmt("file file1 one.bin len=%d sum=%u\n", (int) len, checksum(data, len)));
+    mprAddItem(tc->expected, sfmt("file file2 two.txt len=%d sum=%u\n", (int) slen(small), checksum(small, slen(small))));
+    mprAddItem(tc->expected, sclone("name=Joe Bloggs\nnote=line one\r\nline two\n"));
+    return 1;
+}
+
+
+/*
+    Get the boundary offsets in the upload request. Returns the count of offsets.
+ */
+static int getUploadMarks(MprTestGroup *gp, ssize *marks, int max)
+{
+    TestClient  *tc;
+    int         i, count;
+
+    if (!prepUpload(gp)) {
+        return 0;
+    }
+    tc = gp->data;
+    mprCloseSocket(tc->sock, 0);
+    count = min(mprGetListLength(tc->marks), max);
+    for (i = 0; i < count; i++) {
+        marks[i] = PTOI(mprGetItem(tc->marks, i));
+    }
+    return count;
+}
+
+
+/*
+    Check the upload response contains each expected line and nothing else
+ */
+static bool checkUpload(MprTestGroup *gp)
+{
+    TestClient  *tc;
+    MprBuf      *buf;
+    char        *body, *line;
+    ssize       len;
+    int         next;
+
+    tc = gp->data;
+    readResponses(tc, HTTP_BUFSIZE, 0);
+    mprCloseSocket(tc->sock, 0);
+    buf = tc->responses;
+    if (!sstarts(mprGetBufStart(buf), "HTTP/1.1 200 ") || (body = strstr(mprGetBufStart(buf), "\r\n\r\n")) == 0) {
+        return 0;
+    }
+    body += 4;
+    for (len = 0, next = 0; (line = mprGetNextItem(tc->expected, &next)) != 0; ) {
+        if (!scontains(body, line)) {
+            return 0;
+        }
+        len += slen(line);
+    }
+    return slen(body) == len;
+}
+
+
+/*
+    Send the upload request in two parts split at "offset" so the upload filter sees a new packet at that point
+ */
+static bool uploadSplit(MprTestGroup *gp, ssize offset)
+{
+    TestClient  *tc;
+
+    if (!prepUpload(gp)) {
+        return 0;
+    }
+    tc = gp->data;
+    if (!writeRequests(tc, offset)) {
+        return 0;
+    }
+    mprSleep(10);
+    if (!writeRequests(tc, -1)) {
+        return 0;
+    }
+    return checkUpload(gp);
+}
+
+
+static void testUploadOneByte(MprTestGroup *gp)
+{
+    TestClient  *tc;
+
+    if (!prepUpload(gp)) {
+        assert(0);
+        return;
+    }
+    tc = gp->data;
+    while (mprGetBufLength(tc->requests) > 0) {
+        if (!writeRequests(tc, 1)) {
+            break;
+        }
+        mprSleep(1);
+    }
+    assert(checkUpload(gp));
+}
+
+
+/*
+    Split so the next packet starts exactly with each boundary
+ */
+static void testUploadBoundaryAtStart(MprTestGroup *gp)
+{
+    ssize   marks[8];
+    int     i, count;
+
+    count = getUploadMarks(gp, marks, 8);
+    assert(count > 0);
+    for (i = 0; i < count; i++) {
+        assert(uploadSplit(gp, marks[i]));
+    }
+}
+
+
+/*
+    Split so the CRLF before each boundary ends one packet and the boundary starts the next. Also split inside the CRLF.
+ */
+static void testUploadCrlfBeforeBoundary(MprTestGroup *gp)
+{
+    ssize   marks[8];
+    int     i, count;
+
+    count = getUploadMarks(gp, marks, 8);
+    assert(count > 0);
+    for (i = 1; i < count; i++) {
+        assert(uploadSplit(gp, marks[i] - 2));
+        assert(uploadSplit(gp, marks[i] - 1));
+    }
+}
+
+
+/*
+    Split at every offset around each boundary so the boundary straddles packets
+ */
+static void testUploadStraddle(MprTestGroup *gp)
+{
+    ssize   marks[8], offset;
+    int     i, count;
+
+    count = getUploadMarks(gp, marks, 8);
+    assert(count > 0);
+    for (i = 0; i < count; i++) {
+        for (offset = marks[i] - 4; offset < marks[i] + (ssize) sizeof(TEST_BOUNDARY) + 6; offset++) {
+            assert(uploadSplit(gp, offset));
+        }
+    }
+}
+
+
+/*
+    Add a request to send and the response body expected for it
+ */
+static void addRequest(TestClient *tc, cchar *request, cchar *body)
+{
+    mprPutStringToBuf(tc->requests, request);
+    mprAddItem(tc->expected, sclone(body));
+}
+
+
+/*
+    Pipeline requests with header lines terminated by a bare "\n", including a mix of line endings
+ */
+static bool prepBareLf(MprTestGroup *gp)
+{
+    TestClient  *tc;
+
+    if (!openClient(gp)) {
+        return 0;
+    }
+    tc = gp->data;
+    addRequest(tc, "GET /fill?n=20&tag=lf HTTP/1.1\nHost: localhost\n\n", makeFill("lf", 20));
+    addRequest(tc, "\nPOST /echo HTTP/1.1\nHost: localhost\nX-Test: bare\nContent-Length: 5\n\nhello", 
+        echoResponse("hello", "bare"));
+    addRequest(tc, "POST /echo HTTP/1.1\r\nHost: localhost\nX-Test: mixed\r\nContent-Length: 3\n\r\nabc", 
+        echoResponse("abc", "mixed"));
+    addRequest(tc, "POST /echo HTTP/1.1\nHost: localhost\nX-Test: chunked\nTransfer-Encoding: chunked\n\n"
+        "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n", echoResponse("hello world", "chunked"));
+    addRequest(tc, "POST /echo HTTP/1.1\nHost: localhost\nX-Test: lf-chunks\nTransfer-Encoding: chunked\n\n"
+        "3\nabc\n2\nde\n0\n\n", echoResponse("abcde", "lf-chunks"));
+    addRequest(tc, "GET /fill?n=7&tag=end HTTP/1.1\r\nHost: localhost\nConnection: close\r\n\r\n", makeFill("end", 7));
+    return 1;
+}
+
+
+static void testHeadersBareLf(MprTestGroup *gp)
+{
+    TestClient  *tc;
+
+    if (!prepBareLf(gp)) {
+        assert(0);
+        return;
+    }
+    tc = gp->data;
+    assert(writeRequests(tc, -1));
+    readResponses(tc, HTTP_BUFSIZE, 0);
+    assert(matchResponses(tc->responses, tc->expected) == mprGetListLength(tc->expected));
+    mprCloseSocket(tc->sock, 0);
+}
+
+
+/*
+    A chunked body after a header ending in "\n\n". The chunk filter must accept the bare "\n" before the first chunk.
+ */
+static void testHeadersChunkedAfterLf(MprTestGroup *gp)
+{
+    TestClient  *tc;
+
+    if (!openClient(gp)) {
+        assert(0);
+        return;
+    }
+    tc = gp->data;
+    addRequest(tc, "POST /echo HTTP/1.1\nHost: localhost\nTransfer-Encoding: chunked\nConnection: close\n\n"
+        "b\r\nhello world\r\n0\r\n\r\n", echoResponse("hello world", NULL));
+    assert(writeRequests(tc, -1));
+    readResponses(tc, HTTP_BUFSIZE, 0);
+    assert(matchResponses(tc->responses, tc->expected) == 1);
+    mprCloseSocket(tc->sock, 0);
+}
+
+
+/*
+    Trickle the requests one byte at a time so every header line and terminator arrives in pieces
+ */
+static void testHeadersTrickle(MprTestGroup *gp)
+{
+    TestClient  *tc;
+
+    if (!prepBareLf(gp)) {
+        assert(0);
+        return;
+    }
+    tc = gp->data;
+    while (mprGetBufLength(tc->requests) > 0) {
+        if (!writeRequests(tc, 1)) {
+            break;
+        }
+        mprSleep(1);
+    }
+    readResponses(tc, HTTP_BUFSIZE, 0);
+    assert(matchResponses(tc->responses, tc->expected) == mprGetListLength(tc->expected));
+    mprCloseSocket(tc->sock, 0);
+}
+
+
+/*
+    Send requests on a new connection and return the responses read until the server closes the connection.
+    The value of each Date header is replaced with "DATE".
+ */
+static char *readAll(MprTestGroup *gp, cchar *requests)
+{
+    TestClient  *tc;
+
+    if (!openClient(gp)) {
+        return 0;
+    }
+    tc = gp->data;
+    mprPutStringToBuf(tc->requests, requests);
+    if (!writeRequests(tc, -1)) {
+        return 0;
+    }
+    readResponses(tc, HTTP_BUFSIZE, 0);
+    mprCloseSocket(tc->sock, 0);
+    return maskDate(mprGetBufStart(tc->responses));
+}
+
+
+static char *maskDate(cchar *response)
+{
+    MprBuf  *buf;
+    cchar   *cp, *date, *end;
+
+    buf = mprCreateBuf(0, 0);
+    for (cp = response; (date = strstr(cp, "\r\nDate: ")) != 0 && (end = strstr(&date[8], "\r\n")) != 0; cp = end) {
+        mprPutBlockToBuf(buf, cp, date - cp);
+        mprPutStringToBuf(buf, "\r\nDate: DATE");
+    }
+    mprPutStringToBuf(buf, cp);
+    mprAddNullToBuf(buf);
+    return mprGetBufStart(buf);
+}
+
+
+/*
+    Responses with a keep-alive connection followed by a response that closes the connection. These use the header
+    templates, so check the exact header order and the blank line after the headers.
+ */
+static void testResponsesKeepAlive(MprTestGroup *gp)
+{
+    HttpLimits  *limits;
+    cchar       *software;
+    char        *expected, *responses;
+
+    limits = endpoint->limits;
+    software = endpoint->http->software;
+    responses = readAll(gp,
+        "GET /fill?n=5&tag=k HTTP/1.1\r\nHost: " TEST_IP "\r\n\r\n"
+        "GET /fill?n=3&tag=c HTTP/1.1\r\nHost: " TEST_IP "\r\nConnection: close\r\n\r\n");
+    expected = sfmt(
+        "HTTP/1.1 200 OK\r\nContent-Length: 5\r\nDate: DATE\r\nKeep-Alive: timeout=%d, max=%d\r\n"
+        "Server: %s\r\nConnection: keep-alive\r\n\r\nkkkkk"
+        "HTTP/1.1 200 OK\r\nContent-Length: 3\r\nDate: DATE\r\nServer: %s\r\nConnection: close\r\n\r\nccc",
+        (int) (limits->inactivityTimeout / 1000), limits->keepAliveMax - 1, software, software);
+    assert(smatch(responses, expected));
+}
+
+
+/*
+    A chunked response. The chunk filter emits the blank line after the headers with the first chunk size.
+ */
+static void testResponsesChunked(MprTestGroup *gp)
+{
+    char    *expected, *responses;
+
+    responses = readAll(gp, "GET /chunked HTTP/1.1\r\nHost: " TEST_IP "\r\nConnection: close\r\n\r\n");
+    expected = sfmt(
+        "HTTP/1.1 200 OK\r\nDate: DATE\r\nTransfer-Encoding: chunked\r\nServer: %s\r\nConnection: close\r\n"
+        "\r\nd\r\nchunked body\n\r\n0\r\n\r\n", endpoint->http->software);
+    assert(smatch(responses, expected));
+}
+
+
+/*
+    A HEAD response has the content length of the GET response but no body
+ */
+static void testResponsesHead(MprTestGroup *gp)
+{
+    char    *expected, *responses;
+
+    responses = readAll(gp, "HEAD /fill?n=5&tag=h HTTP/1.1\r\nHost: " TEST_IP "\r\nConnection: close\r\n\r\n");
+    expected = sfmt("HTTP/1.1 200 OK\r\nContent-Length: 5\r\nDate: DATE\r\nServer: %s\r\nConnection: close\r\n\r\n",
+        endpoint->http->software);
+    assert(smatch(responses, expected));
+}
+
+
+/*
+    Routes are inserted before the default route. Each route must skip to the next route with a different first 
+    segment, and the last group must skip to the default route.
+ */
+static void testRoutesInsertBeforeDefault(MprTestGroup *gp)
+{
+    HttpHost    *host;
+    HttpRoute   *route, *next;
+    cchar       *patterns[] = { "/a/one", "/a/two", "/b", "/a/three", "/c/one", "/c/two", 0 };
+    int         i, j, count;
+
+    host = httpCreateHost(".");
+    httpRemoveHost(endpoint->http, host);
+    mprAddRoot(host);
+    route = httpCreateRoute(host);
+    httpSetHostDefaultRoute(host, route);
+    httpFinalizeRoute(route);
+    for (i = 0; patterns[i]; i++) {
+        route = httpCreateInheritedRoute(host->defaultRoute);
+        httpSetRoutePattern(route, patterns[i], 0);
+        httpFinalizeRoute(route);
+    }
+    count = mprGetListLength(host->routes);
+    assert(count == i + 1);
+    assert(mprGetLastItem(host->routes) == host->defaultRoute);
+    for (i = 0; i < count; i++) {
+        route = mprGetItem(host->routes, i);
+        for (j = i + 1; j < count; j++) {
+            next = mprGetItem(host->routes, j);
+            if (!smatch(next->startSegment, route->startSegment)) {
+                break;
+            }
+        }
+        assert(route->nextGroup == j);
+    }
+    mprRemoveRoot(host);
+}
+
+
+#if BIT_UNIX_LIKE
+/*
+    Secure provider that passes data through unencrypted. Writes accept at most providerLimit bytes if set.
+ */
+static ssize writeProvider(MprSocket *sp, cvoid *buf, ssize len)
+{
+    providerWrites++;
+    if (providerLimit > 0) {
+        len = min(len, providerLimit);
+    }
+    return write(sp->fd, buf, len);
+}
+
+
+static void readPair(int fd, MprBuf *buf)
+{
+    ssize   nbytes;
+
+    while (1) {
+        if (mprGetBufSpace(buf) < HTTP_BUFSIZE) {
+            mprGrowBuf(buf, HTTP_BUFSIZE);
+        }
+        if ((nbytes = read(fd, mprGetBufEnd(buf), mprGetBufSpace(buf))) <= 0) {
+            break;
+        }
+        mprAdjustBufEnd(buf, nbytes);
+    }
+}
+
+
+/*
+    Send headers, a file and a trailer to a secure socket over a socket pair. Short writes are resumed the way the send
+    connector resumes them: by calling again with the vectors and file offset advanced past the bytes written.
+ */
+static bool sendSecure(MprSocket *sock, int fd, ssize limit, MprBuf *out)
+{
+    MprFile     *file;
+    MprIOVec    before, after;
+    MprOff      done, rc, total;
+    ssize       hlen, tlen, size;
+    cchar       *header, *trailer;
+
+    header = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n19000\r\n";
+    trailer = "\r\n0\r\n\r\n";
+    hlen = slen(header);
+    tlen = slen(trailer);
+    size = TEST_SECURE_SIZE;
+    if ((file = mprOpenFile(mprJoinPath(fileDir, "static/secure.txt"), O_RDONLY | O_BINARY, 0)) == 0) {
+        return 0;
+    }
+    providerLimit = limit;
+    providerWrites = 0;
+    total = hlen + size + tlen;
+    for (done = 0; done < total; done += rc) {
+        before.start = (char*) &header[min(done, hlen)];
+        before.len = hlen - min(done, hlen);
+        after.start = (char*) &trailer[max(done - hlen - size, 0)];
+        after.len = tlen - max(done - hlen - size, 0);
+        rc = mprSendFileToSocket(sock, file, min(max(done - hlen, 0), size), total - done, &before, before.len ? 1 : 0, 
+            &after, 1);
+        readPair(fd, out);
+        if (rc <= 0) {
+            break;
+        }
+    }
+    mprCloseFile(file);
+    return done == total;
+}
+
+
+/*
+    Files sent to a secure socket are packed into records. Send to a pass-through provider with and without short 
+    writes and check the bytes received.
+ */
+static void testSecureSendFile(MprTestGroup *gp)
+{
+    MprSocketProvider   *provider;
+    MprSocket           *sock;
+    MprBuf              *out;
+    char                *body, *expected, *path;
+    int                 pair[2], size;
+
+    body = makeFill("secure-", TEST_SECURE_SIZE);
+    path = mprJoinPath(fileDir, "static/secure.txt");
+    assert(mprWritePathContents(path, body, TEST_SECURE_SIZE, 0644) == TEST_SECURE_SIZE);
+    expected = sfmt("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n19000\r\n%s\r\n0\r\n\r\n", body);
+
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+    size = 4 * TEST_SECURE_SIZE;
+    setsockopt(pair[0], SOL_SOCKET, SO_SNDBUF, (char*) &size, sizeof(size));
+    fcntl(pair[1], F_SETFL, fcntl(pair[1], F_GETFL) | O_NONBLOCK);
+
+    provider = mprAllocObj(MprSocketProvider, NULL);
+    provider->writeSocket = writeProvider;
+    sock = mprCreateSocket(NULL);
+    sock->provider = provider;
+    sock->sslSocket = provider;
+    sock->fd = pair[0];
+    out = mprCreateBuf(0, 0);
+    mprAddRoot(sock);
+    mprAddRoot(out);
+
+    /*
+        Without short writes, each provider write is one full record
+     */
+    assert(sendSecure(sock, pair[1], 0, out));
+    mprAddNullToBuf(out);
+    assert(smatch(mprGetBufStart(out), expected));
+    assert(providerWrites == (slen(expected) + MPR_SSL_RECORD_SIZE - 1) / MPR_SSL_RECORD_SIZE);
+
+    mprFlushBuf(out);
+    assert(sendSecure(sock, pair[1], 5000, out));
+    mprAddNullToBuf(out);
+    assert(smatch(mprGetBufStart(out), expected));
+
+    mprFlushBuf(out);
+    assert(sendSecure(sock, pair[1], 777, out));
+    mprAddNullToBuf(out);
+    assert(smatch(mprGetBufStart(out), expected));
+
+    mprRemoveRoot(out);
+    mprRemoveRoot(sock);
+    sock->fd = -1;
+    close(pair[0]);
+    close(pair[1]);
+}
+#endif
+
+
+MprTestDef testHttpPipeline = {
+    "pipeline", 0, initServer, 0,
+    {
+        MPR_TEST(0, testPipelineHold),
+        MPR_TEST(0, testPipelineSlowReader),
+        MPR_TEST(0, testPipelineSendfile),
+        MPR_TEST(0, 0),
+    },
+};
+
+
+MprTestDef testHttpUpload = {
+    "upload", 0, initServer, 0,
+    {
+        MPR_TEST(0, testUploadOneByte),
+        MPR_TEST(0, testUploadBoundaryAtStart),
+        MPR_TEST(0, testUploadCrlfBeforeBoundary),
+        MPR_TEST(0, testUploadStraddle),
+        MPR_TEST(0, 0),
+    },
+};
+
+
+MprTestDef testHttpHeaders = {
+    "headers", 0, initServer, 0,
+    {
+        MPR_TEST(0, testHeadersBareLf),
+        MPR_TEST(0, testHeadersChunkedAfterLf),
+        MPR_TEST(0, testHeadersTrickle),
+        MPR_TEST(0, 0),
+    },
+};
+
+
+MprTestDef testHttpResponses = {
+    "responses", 0, initServer, 0,
+    {
+        MPR_TEST(0, testResponsesKeepAlive),
+        MPR_TEST(0, testResponsesChunked),
+        MPR_TEST(0, testResponsesHead),
+        MPR_TEST(0, 0),
+    },
+};
+
+
+MprTestDef testHttpSecure = {
+    "secure", 0, initServer, 0,
+    {
+#if BIT_UNIX_LIKE
+        MPR_TEST(0, testSecureSendFile),
+#endif
+        MPR_TEST(0, 0),
+    },
+};
+
+
+MprTestDef testHttpRoutes = {
+    "routes", 0, initServer, 0,
+    {
+        MPR_TEST(0, testRoutesInsertBeforeDefault),
+        MPR_TEST(0, 0),
+    },
+};
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2012. All Rights Reserved.
+    Copyright (c) Michael O'Brien, 1993-2012. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the GPL open source license described below or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details.
+
+    This software is open source; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version. See the GNU General Public License for more
+    details at: http://embedthis.com/downloads/gplLicense.html
+
+    This program is distributed WITHOUT ANY WARRANTY; without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+    This GPL license does NOT permit incorporating this software into
+    proprietary programs. If you are unable to comply with the GPL, you must
+    acquire a commercial license to use this software. Commercial licenses
+    for this software and support services are available from Embedthis
+    Software at http://embedthis.com
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */